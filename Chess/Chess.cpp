@@ -25,8 +25,14 @@
 #include "pawnsDef.h"
 #include "creditsDef.h"
 #include "gameoverDef.h"
+#include "ChessEngine/Tracer.h"
 #include <fstream>
 
+namespace
+{
+    const char* const TraceFile = "trace.json";
+}
+
 //-----------------------------------------------------------------------------
 // Name : Chess (constructor)
 //-----------------------------------------------------------------------------
@@ -223,6 +229,28 @@ void Chess::sendKeyEvent(unsigned char key, bool down)
         }
     }
         
+    // toggle playing against the engine, it takes the black pieces
+    if ((key == 'e' || key == 'E') && down && m_sceneInput)
+    {
+        ChessScene* chessScene = static_cast<ChessScene*>(m_scene);
+        chessScene->setEnginePlayer(chessScene->getEnginePlayer() == BLACK ? 0 : BLACK);
+    }
+
+    // start a timeline trace, pressing again writes it to trace.json
+    if ((key == 't' || key == 'T') && down && m_sceneInput)
+    {
+        if (Tracer::isEnabled())
+        {
+            Tracer::stop();
+            if (Tracer::writeJson(TraceFile))
+                std::cout << "trace written to " << TraceFile << "\n";
+            else
+                std::cout << "Error : failed to write " << TraceFile << "\n";
+        }
+        else
+            Tracer::start();
+    }
+        
     m_mainMenuDialog.handleKeyEvent(key, down);
     m_optionDialog.handleKeyEvent(key, down);
     m_creditsDialog.handleKeyEvent(key, down);
@@ -0,0 +1,116 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Attacks.h"
+
+Bitboard Attacks::s_pawn[2][SQUARE_NB];
+Bitboard Attacks::s_knight[SQUARE_NB];
+Bitboard Attacks::s_king[SQUARE_NB];
+Bitboard Attacks::s_rays[DIRECTION_NB][SQUARE_NB];
+
+namespace
+{
+    //-----------------------------------------------------------------------------
+    // Name : offsetSquare ()
+    // Desc : returns the square at the given row/col offset or NO_SQUARE when
+    //        it falls outside of the board
+    //-----------------------------------------------------------------------------
+    int offsetSquare(int square, int dRow, int dCol)
+    {
+        int row = squareRow(square) + dRow;
+        int col = squareCol(square) + dCol;
+
+        if (row < 0 || row >= boardX || col < 0 || col >= boardY)
+            return NO_SQUARE;
+
+        return makeSquare(row, col);
+    }
+
+    Bitboard leaperAttacks(int square, const int deltas[][2], int count)
+    {
+        Bitboard attacks = 0;
+        for (int i = 0; i < count; i++)
+        {
+            int target = offsetSquare(square, deltas[i][0], deltas[i][1]);
+            if (target != NO_SQUARE)
+                attacks |= squareBB(target);
+        }
+        return attacks;
+    }
+}
+
+// the tables are filled before main() runs
+struct AttacksInit
+{
+    AttacksInit()
+    {
+        const int knightDeltas[8][2] = {{1,2}, {2,1}, {2,-1}, {1,-2}, {-1,-2}, {-2,-1}, {-2,1}, {-1,2}};
+        const int kingDeltas[8][2]   = {{1,0}, {-1,0}, {0,1}, {0,-1}, {1,1}, {1,-1}, {-1,1}, {-1,-1}};
+        // {row, col} step of every Attacks::Direction, north is toward the upper side
+        const int rayDeltas[Attacks::DIRECTION_NB][2] = {{0,-1}, {0,1}, {1,0}, {-1,0}, {1,-1}, {-1,-1}, {1,1}, {-1,1}};
+        // pawns of the upper side move down the board, bottom pawns move up
+        const int pawnDeltas[2][2][2] = {{{-1,1}, {1,1}}, {{-1,-1}, {1,-1}}};
+
+        for (int square = 0; square < SQUARE_NB; square++)
+        {
+            Attacks::s_knight[square] = leaperAttacks(square, knightDeltas, 8);
+            Attacks::s_king[square]   = leaperAttacks(square, kingDeltas, 8);
+
+            for (int side = 0; side < 2; side++)
+                Attacks::s_pawn[side][square] = leaperAttacks(square, pawnDeltas[side], 2);
+
+            for (int dir = 0; dir < Attacks::DIRECTION_NB; dir++)
+            {
+                Attacks::s_rays[dir][square] = 0;
+                int target = offsetSquare(square, rayDeltas[dir][0], rayDeltas[dir][1]);
+                while (target != NO_SQUARE)
+                {
+                    Attacks::s_rays[dir][square] |= squareBB(target);
+                    target = offsetSquare(target, rayDeltas[dir][0], rayDeltas[dir][1]);
+                }
+            }
+        }
+    }
+};
+
+static AttacksInit attacksInit;
+
+//-----------------------------------------------------------------------------
+// Name : pieceAttacks ()
+// Desc : attacks of any non pawn piece type
+//-----------------------------------------------------------------------------
+Bitboard Attacks::pieceAttacks(int pieceType, int square, Bitboard occupied)
+{
+    switch (pieceType)
+    {
+    case KNIGHT:
+        return knight(square);
+    case BISHOP:
+        return bishop(square, occupied);
+    case ROOK:
+        return rook(square, occupied);
+    case QUEEN:
+        return queen(square, occupied);
+    case KING:
+        return king(square);
+    default:
+        return 0;
+    }
+}
@@ -0,0 +1,81 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ATTACKS_H_
+#define _ATTACKS_H_
+
+#include "Bitboard.h"
+
+// precomputed attack sets of every piece type.
+// sliding pieces use ray tables : the ray is cut at the first blocker
+// by removing the ray that starts behind it
+class Attacks
+{
+public:
+    enum Direction {NORTH, SOUTH, EAST, WEST, NORTH_EAST, NORTH_WEST, SOUTH_EAST, SOUTH_WEST, DIRECTION_NB};
+
+    static Bitboard pawn  (int side, int square) { return s_pawn[side][square]; }
+    static Bitboard knight(int square)           { return s_knight[square]; }
+    static Bitboard king  (int square)           { return s_king[square]; }
+
+    static Bitboard bishop(int square, Bitboard occupied)
+    {
+        return slide(NORTH_EAST, square, occupied) | slide(NORTH_WEST, square, occupied) |
+               slide(SOUTH_EAST, square, occupied) | slide(SOUTH_WEST, square, occupied);
+    }
+
+    static Bitboard rook(int square, Bitboard occupied)
+    {
+        return slide(NORTH, square, occupied) | slide(SOUTH, square, occupied) |
+               slide(EAST, square, occupied)  | slide(WEST, square, occupied);
+    }
+
+    static Bitboard queen(int square, Bitboard occupied)
+    {
+        return bishop(square, occupied) | rook(square, occupied);
+    }
+
+    static Bitboard ray(int direction, int square) { return s_rays[direction][square]; }
+
+    static Bitboard pieceAttacks(int pieceType, int square, Bitboard occupied);
+
+private:
+    friend struct AttacksInit;
+
+    static Bitboard slide(int direction, int square, Bitboard occupied)
+    {
+        Bitboard attacks  = s_rays[direction][square];
+        Bitboard blockers = attacks & occupied;
+        if (blockers)
+        {
+            // directions that go toward higher squares hit their lowest blocker first
+            int blocker = (direction == SOUTH || direction == EAST || direction == SOUTH_EAST || direction == SOUTH_WEST)
+                        ? lsb(blockers) : msb(blockers);
+            attacks ^= s_rays[direction][blocker];
+        }
+        return attacks;
+    }
+
+    static Bitboard s_pawn[2][SQUARE_NB];
+    static Bitboard s_knight[SQUARE_NB];
+    static Bitboard s_king[SQUARE_NB];
+    static Bitboard s_rays[DIRECTION_NB][SQUARE_NB];
+};
+
+#endif // _ATTACKS_H_
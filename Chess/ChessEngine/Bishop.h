@@ -27,7 +27,6 @@ class bishop : public piece
 public:
     bishop(int playerColor, BOARD_POINT _boardPoistion);
     ~bishop(void);
-    virtual bool validateNewPos(int dx,int dy, BOARD_POINT startSqaure, BOARD_POINT targetSquare,piece * SBoard[boardY][boardX]);
     int   getType();
 
 private:
@@ -0,0 +1,141 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BITBOARD_H_
+#define _BITBOARD_H_
+
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "Chess.h"
+
+// a set of squares, bit n is set when square n is in the set.
+// squares are numbered the same way the board array is laid out :
+// square = col * boardX + row, so square 0 is the upper left corner(a8)
+// and square 63 is the bottom right corner(h1)
+typedef uint64_t Bitboard;
+
+const int SQUARE_NB   = boardX * boardY;
+const int NO_SQUARE   = -1;
+
+const Bitboard FILE_A_BB = 0x0101010101010101ULL;
+const Bitboard FILE_H_BB = FILE_A_BB << 7;
+
+//-----------------------------------------------------------------------------
+// Square helpers
+//-----------------------------------------------------------------------------
+inline int makeSquare(int row, int col)
+{
+    return col * boardX + row;
+}
+
+inline int makeSquare(const BOARD_POINT& point)
+{
+    return point.col * boardX + point.row;
+}
+
+inline BOARD_POINT squareToPoint(int square)
+{
+    return BOARD_POINT(square % boardX, square / boardX);
+}
+
+// the file(a-h) of the square, same as BOARD_POINT::row
+inline int squareRow(int square)
+{
+    return square & 7;
+}
+
+// distance of the square from the upper side, same as BOARD_POINT::col
+inline int squareCol(int square)
+{
+    return square >> 3;
+}
+
+// rank of the square as seen by the given side, 0 is the side back rank
+inline int relativeRank(int side, int square)
+{
+    return (side == BOTTOM) ? 7 - squareCol(square) : squareCol(square);
+}
+
+inline Bitboard squareBB(int square)
+{
+    return 1ULL << square;
+}
+
+inline Bitboard fileBB(int row)
+{
+    return FILE_A_BB << row;
+}
+
+// moves all the squares one step forward from the given side point of view
+inline Bitboard shiftForward(int side, Bitboard b)
+{
+    return (side == BOTTOM) ? b >> 8 : b << 8;
+}
+
+//-----------------------------------------------------------------------------
+// Bit twiddling
+//-----------------------------------------------------------------------------
+#if defined(_MSC_VER)
+inline int popCount(Bitboard b)
+{
+    return static_cast<int>(__popcnt64(b));
+}
+
+inline int lsb(Bitboard b)
+{
+    unsigned long index;
+    _BitScanForward64(&index, b);
+    return static_cast<int>(index);
+}
+
+inline int msb(Bitboard b)
+{
+    unsigned long index;
+    _BitScanReverse64(&index, b);
+    return static_cast<int>(index);
+}
+#else
+inline int popCount(Bitboard b)
+{
+    return __builtin_popcountll(b);
+}
+
+inline int lsb(Bitboard b)
+{
+    return __builtin_ctzll(b);
+}
+
+inline int msb(Bitboard b)
+{
+    return 63 - __builtin_clzll(b);
+}
+#endif
+
+// returns the lowest square in the set and removes it
+inline int popLsb(Bitboard& b)
+{
+    int square = lsb(b);
+    b &= b - 1;
+    return square;
+}
+
+#endif // _BITBOARD_H_
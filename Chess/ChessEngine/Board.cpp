@@ -19,22 +19,60 @@
 //
 
 #include "Board.h"
+#include "Serialization.h"
+#include "Tracer.h"
+#include <cstring>
+
+namespace
+{
+    const char* const SaveFile       = "board.sav";
+    const char* const JournalFile    = "board.journal";
+    const char        SaveMagic[4]   = {'C', 'S', 'A', 'V'};
+    const uint16_t    SaveVersion    = 2;
+    // version 1 saves and the journals that follow them hold queenside
+    // castling with the king on the b file
+    const uint16_t    BFileCastlingVersion = 1;
+    const int         SaveHeaderSize = 16;
+
+    // moves journaled before a new snapshot replaces the journal
+    const size_t      SnapshotInterval = 64;
+
+    //-------------------------------------------------------------------------
+    // Name : toStandardCastling ()
+    // Desc : a b file castling of a version 1 save becomes the standard
+    //        castling to the c file, other moves are returned as they are
+    //-------------------------------------------------------------------------
+    Move toStandardCastling(Move move)
+    {
+        if (moveType(move) == CASTLING_MOVE && moveFrom(move) - moveTo(move) == 3)
+            return makeMove(moveFrom(move), moveTo(move) + 1, CASTLING_MOVE);
+
+        return move;
+    }
+}
 
 //-----------------------------------------------------------------------------
 // Name : board (Constructor)
 //-----------------------------------------------------------------------------
 board::board()
-: m_startSquare (-1, -1), m_targetSquare (0,0), m_threatSquare(-1, -1), m_attLoc (0,0)
+: m_startSquare (-1, -1), m_targetSquare (0,0), m_threatSquare(-1, -1)
 {
     for (unsigned int i = 0; i < boardX; i++)
         for (unsigned int j = 0; j < boardY; j++)
                 m_board[i][j] = nullptr;
 
     m_currentPawn = nullptr;
-    m_prevPawn = nullptr;
+    m_promotionMove = MOVE_NONE;
+
+    m_gameActive = false;
+    m_unitPromotion = false;
+    m_asyncEndGameCheck = false;
 
-    m_kings[BOTTOM] = nullptr;
-    m_kings[UPPER] = nullptr;
+    m_journaling = false;
+    m_saveFile = SaveFile;
+    m_journalFile = JournalFile;
+    m_snapshotId = 0;
+    m_snapshotMoves = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -48,8 +86,10 @@ board::~board(void)
 //-----------------------------------------------------------------------------
 void board::init()
 {
-    m_currentPlayer = 1;
-    m_pieceCount = 0;
+    m_position.setStartPosition();
+    m_startPosition = m_position;
+    m_moveHistory.clear();
+    m_positionKeys.assign(1, m_position.key());
 
     // add black pieces to board
     for (int i = 0; i < 2; i++)
@@ -71,131 +111,239 @@ void board::init()
 
     m_gameActive = true;
     m_unitPromotion = false;
-    m_kingInThreat = false;
+    m_promotionMove = MOVE_NONE;
 }
 
 //-----------------------------------------------------------------------------
 // Name : SaveBoardToFile ()
+// Desc : the snapshot reaches the disk before the journal names it, so a
+//        power loss never leaves a journal that follows a snapshot that is
+//        not there
 //-----------------------------------------------------------------------------
 void board::SaveBoardToFile()
 {
-    std::ofstream saveFile;
-
-    saveFile.open("board.sav");
-
-    saveFile << m_kingInThreat << "| king in Threat" << "\n";
-    saveFile << m_pieceCount << "| piece Count" << "\n";
-    saveFile << m_currentPlayer << "| current player" << "\n";
-
-    for (unsigned int i = 0; i < boardY; i++)
-    {
-        for (unsigned int j = 0; j < boardX; j++)
-        { 
-            if ( m_board[i][j] != nullptr)
-            {
-                saveFile << i << "| piece i" << "\n";
-                saveFile << j << "| piece j" << "\n";
-                saveFile << m_board[i][j]->getColor() << "| piece Color\n";
-                saveFile << m_board[i][j]->getType() << "| piece Type\n";
-                saveFile << m_board[i][j]->isMoved() << "| piece moved\n";
-            }
-        }
-    }
+    std::vector<uint8_t> data = encodeSave();
+    if (!replaceFile(m_saveFile, &data[0], data.size()))
+        return;
 
-    saveFile.close();
+    // the moves from here on follow the new snapshot
+    m_snapshotId = readLE32(&data[12]);
+    m_snapshotMoves = m_moveHistory.size();
+    if (m_journaling)
+        m_journal.create(m_journalFile, m_snapshotId, static_cast<uint32_t>(m_snapshotMoves));
 }
 
 //-----------------------------------------------------------------------------
 // Name : LoadBoardFromFile ()
+// Desc : the whole file is read at once and checked before the board is
+//        touched, a damaged save leaves the current game as it is
 //-----------------------------------------------------------------------------
 bool board::LoadBoardFromFile()
 {
-    std::ifstream inputFile;
-        
-    // open the save file and verify success
-    inputFile.open("board.sav");
+    std::ifstream inputFile(m_saveFile.c_str(), std::ios::binary | std::ios::ate);
     if (!inputFile.good())
         return false;
-    
-    for (unsigned int i = 0; i < boardX; i++)
-        for (unsigned int j = 0; j < boardY; j++)
-                m_board[i][j] = nullptr;
 
-    m_targetSquare.col = 0;
-    m_targetSquare.row = 0;
+    std::streamoff fileSize = inputFile.tellg();
+    if (fileSize < SaveHeaderSize + 2 * PACKED_POSITION_SIZE)
+        return false;
 
-    m_currentPawn = nullptr;
-    m_prevPawn    = nullptr;
+    std::vector<uint8_t> data(static_cast<size_t>(fileSize));
+    inputFile.seekg(0);
+    if (!inputFile.read(reinterpret_cast<char*>(&data[0]), fileSize))
+        return false;
 
-    m_kings[UPPER]  = nullptr;
-    m_kings[BOTTOM] = nullptr;
-    
-    m_deadPawnsVec[UPPER].clear();
-    m_deadPawnsVec[BOTTOM].clear();
+    if (!decodeSave(data))
+        return false;
 
+    // the replayed moves are journaled by the snapshot taken at the end
+    bool journaling = m_journaling;
+    m_journaling = false;
 
-    //clearing the pieces
-    for (unsigned int j =0; j < 2; j++)
+    replayJournal(readLE16(&data[4]) == BFileCastlingVersion);
+
+    // start over from a snapshot holding the replayed moves
+    m_journaling = journaling;
+    if (m_journaling)
+        SaveBoardToFile();
+
+    return m_gameActive;
+}
+
+//-----------------------------------------------------------------------------
+// Name : encodeSave ()
+// Desc : the save is a binary snapshot :
+//        bytes 0-3   "CSAV"
+//        bytes 4-5   format version
+//        bytes 6-7   reserved
+//        bytes 8-11  number of moves
+//        bytes 12-15 crc-32 of everything after the header
+//        then the packed start position, the packed current position and
+//        the moves played from the start position, 2 bytes each
+//-----------------------------------------------------------------------------
+std::vector<uint8_t> board::encodeSave() const
+{
+    size_t moveCount = m_moveHistory.size();
+    std::vector<uint8_t> data(SaveHeaderSize + 2 * PACKED_POSITION_SIZE + moveCount * 2);
+
+    uint8_t* body = &data[SaveHeaderSize];
+    m_startPosition.pack(body);
+    m_position.pack(body + PACKED_POSITION_SIZE);
+    for (size_t i = 0; i < moveCount; i++)
+        writeLE16(body + 2 * PACKED_POSITION_SIZE + i * 2, m_moveHistory[i]);
+
+    std::memcpy(&data[0], SaveMagic, 4);
+    writeLE16(&data[4], SaveVersion);
+    writeLE32(&data[8], static_cast<uint32_t>(moveCount));
+    writeLE32(&data[12], crc32(body, data.size() - SaveHeaderSize));
+
+    return data;
+}
+
+//-----------------------------------------------------------------------------
+// Name : decodeSave ()
+// Desc : the data is checked before the board is touched, a damaged save
+//        leaves the current game as it is
+//-----------------------------------------------------------------------------
+bool board::decodeSave(const std::vector<uint8_t>& data)
+{
+    if (data.size() < SaveHeaderSize + 2 * PACKED_POSITION_SIZE)
+        return false;
+
+    const uint8_t* body = &data[SaveHeaderSize];
+    size_t bodySize = data.size() - SaveHeaderSize;
+    size_t moveCount = readLE32(&data[8]);
+    uint16_t version = readLE16(&data[4]);
+
+    if (std::memcmp(&data[0], SaveMagic, 4) != 0 || (version != SaveVersion && version != BFileCastlingVersion) ||
+        bodySize != 2 * PACKED_POSITION_SIZE + moveCount * 2 || readLE32(&data[12]) != crc32(body, bodySize))
     {
-        for (piece* currentPiece : m_pawnsVec[j])
-        {
-            delete currentPiece;
-            currentPiece = nullptr;
-        }
-        m_pawnsVec[j].clear();
+        std::cout << "Error occurred while loading board save file\n";
+        return false;
     }
-    
-    inputFile >> m_kingInThreat;
-    inputFile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-    inputFile >> m_pieceCount;
-    inputFile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-    inputFile >> m_currentPlayer;
-    inputFile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-
-    do 
+
+    Position startPosition, currentPosition;
+    if (!startPosition.unpack(body) || !currentPosition.unpack(body + PACKED_POSITION_SIZE))
     {
-        unsigned int i = 0,j = 0;
-        int color,type;
-        bool moved;
+        std::cout << "Error occurred while loading board save file\n";
+        return false;
+    }
+
+    // the loaded moves are journaled by the next snapshot
+    bool journaling = m_journaling;
+    m_journaling = false;
 
-        inputFile >> i;
-        inputFile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        if (inputFile.eof() && inputFile.fail())
+    setPosition(currentPosition);
+    m_startPosition = startPosition;
+    // the moves of an old save are converted once here, everything after
+    // the load only sees standard castling
+    bool bFileCastling = (version == BFileCastlingVersion);
+    for (size_t i = 0; i < moveCount; i++)
+    {
+        Move move = readLE16(body + 2 * PACKED_POSITION_SIZE + i * 2);
+        m_moveHistory.push_back(bFileCastling ? toStandardCastling(move) : move);
+    }
+    rebuildPositionKeys();
+
+    m_snapshotId = readLE32(&data[12]);
+    m_snapshotMoves = moveCount;
+    // the views learn about the pieces the same way a new game creates them
+    for (int side = 0; side < 2; side++)
+        for (piece* curPiece : m_pawnsVec[side])
+            m_pieceCreatedSig(curPiece);
+
+    endTurn();
+
+    m_journaling = journaling;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : setSaveFiles ()
+//-----------------------------------------------------------------------------
+void board::setSaveFiles(const std::string& saveFile, const std::string& journalFile)
+{
+    m_journal.close();
+    m_saveFile = saveFile;
+    m_journalFile = journalFile;
+}
+
+//-----------------------------------------------------------------------------
+// Name : setJournaling ()
+//-----------------------------------------------------------------------------
+void board::setJournaling(bool enabled)
+{
+    m_journaling = enabled;
+    if (!enabled)
+        m_journal.close();
+}
+
+//-----------------------------------------------------------------------------
+// Name : journalMoves ()
+// Desc : appends the moves played since the last call, a game that never
+//        had a snapshot gets one first
+//-----------------------------------------------------------------------------
+void board::journalMoves()
+{
+    if (!m_journaling)
+        return;
+
+    if (!m_journal.isOpen() || m_moveHistory.size() >= m_snapshotMoves + SnapshotInterval)
+    {
+        SaveBoardToFile();
+        return;
+    }
+
+    while (m_snapshotMoves + m_journal.getMoveCount() < m_moveHistory.size())
+        if (!m_journal.append(m_moveHistory[m_snapshotMoves + m_journal.getMoveCount()]))
             break;
+}
 
-        inputFile >> j;
-        inputFile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        inputFile >> color;
-        inputFile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        inputFile >> type;
-        inputFile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        inputFile >> moved;
-        inputFile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-
-        m_board[i][j] = createPiece(color, static_cast<PIECES>(type), BOARD_POINT(j,i));
-        m_board[i][j]->setMoved(moved);
-        if (type == KING)
-        {
-            if (color == BLACK)
-                m_kings[UPPER] = static_cast<king*>(m_board[i][j]);
-            else
-                m_kings[BOTTOM] = static_cast<king*>(m_board[i][j]);
-        }
-    } while (!inputFile.eof() && !inputFile.fail());
+//-----------------------------------------------------------------------------
+// Name : replayJournal ()
+// Desc : plays the journaled moves that follow the loaded snapshot, with
+//        journaling off as they are already in the journal. the
+//        replay stops at the first move that does not fit the position, which
+//        can only be the last one if the game crashed while writing it.
+//        the journal of a version 1 save is converted like the save
+//-----------------------------------------------------------------------------
+void board::replayJournal(bool bFileCastling)
+{
+    uint32_t snapshotId, snapshotMoves;
+    std::vector<Move> moves;
 
-    if (inputFile.eof())
-        m_gameActive = true;
-    else
+    if (!GameJournal::read(m_journalFile, snapshotId, snapshotMoves, moves) ||
+        snapshotId != m_snapshotId || snapshotMoves != m_moveHistory.size())
+        return;
+
+    for (Move move : moves)
+        if (!playMove(bFileCastling ? toStandardCastling(move) : move))
+            break;
+}
+
+//-----------------------------------------------------------------------------
+// Name : rebuildPositionKeys ()
+// Desc : the keys of a loaded game come from replaying its moves, when they
+//        do not lead to the saved position only the current key is known and
+//        repetitions are counted from there
+//-----------------------------------------------------------------------------
+void board::rebuildPositionKeys()
+{
+    Position pos = m_startPosition;
+    m_positionKeys.assign(1, pos.key());
+
+    for (Move move : m_moveHistory)
     {
-        std::cout << "Error occurred while loading board save file\n";
-        m_gameActive = false;
+        if (!pos.isPseudoLegal(move) || !pos.isLegal(move))
+            break;
+
+        UndoInfo undo;
+        pos.doMove(move, undo);
+        m_positionKeys.push_back(pos.key());
     }
-    
-    inputFile.close();
-    //m_gameActive = true;
-    m_currentPlayer *=-1;
-    endTurn();
-    return m_gameActive;
+
+    if (m_positionKeys.size() != m_moveHistory.size() + 1 || pos.key() != m_position.key())
+        m_positionKeys.assign(1, m_position.key());
 }
 
 //-----------------------------------------------------------------------------
@@ -208,75 +356,60 @@ bool board::validateMove(BOARD_POINT startLoc,BOARD_POINT newLoc)
         std::cout << "Error : currentPawn was null.. aborting\n";
         return false;
     }
-    
-    int dx = startLoc.row - newLoc.row;
-    int dy = startLoc.col - newLoc.col;
 
-    if ( m_currentPawn->validateNewPos(dx,dy,startLoc,newLoc,m_board ))
+    Move move = findMove(startLoc, newLoc);
+    if (move == MOVE_NONE)
+        return false;
+
+    movePieces(move);
+
+    // the position takes the pawn move once the player picks the piece
+    if (moveType(move) == PROMOTION_MOVE)
     {
-        //TODO: make castling thingy here 
-        piece * targetPiece = m_board[newLoc.col][newLoc.row];
+        m_promotionMove = move;
+        m_unitPromotion = true;
+    }
+    else
+        commitMove(move);
 
-        if (targetPiece != nullptr)
-        {
-            m_prevPawn = targetPiece;
-            // soft kill this piece by setting out of the bounds of the board
-            m_prevPawn->setBoardPosition(BOARD_POINT(10,10));
-        }
-        else
-        {
-            //king was moved to castling pos
-            if ( m_currentPawn->getType() == KING && (dx == -2 || dx == 3))
-            {
-                if (!m_kingInThreat)
-                {
-                    if (castling(dx, dy))//check if castling is valid 
-                    {
-                        int x = dx/abs(dx);
-                        int y = m_startSquare.col;
-
-                        x = m_startSquare.row - dx -x;
-
-                        BOARD_POINT newRookSquare(x + 2 * (dx / abs(dx)), y);
-
-                        piece * rookPiece = m_board[y][x]; 
-                        m_board[newRookSquare.col][newRookSquare.row] = rookPiece;
-                        m_pieceMovedSig(rookPiece, rookPiece->getPosition() ,newRookSquare);
-                        rookPiece->setBoardPosition(newRookSquare);
-                        m_board[y][x] = nullptr;
-                    }
-                    else
-                        return false;
-                }
-                else
-                    return false;
-            }
-        }
+    return true;
+}
 
-        m_board[newLoc.col][newLoc.row] = m_currentPawn;
-        m_currentPawn->setBoardPosition(newLoc);
-        m_board[startLoc.col][startLoc.row]  = nullptr;
-        
-        // if king is under threat the move is illegal
-        if(isKingInThreat( m_currentPlayer,false))
-        {
-            reverseMove();  // reverse the changes done 
-            m_prevPawn = nullptr;
-            return false;
-        }
-        else
-        {
-            //TODO: add here some way to display something that will let the player choose the promotion unit
-            if ( m_prevPawn != nullptr)
-                killPiece( m_prevPawn,newLoc);
+//-----------------------------------------------------------------------------
+// Name : findMove ()
+//-----------------------------------------------------------------------------
+Move board::findMove(BOARD_POINT startLoc, BOARD_POINT newLoc) const
+{
+    BOARD_STAT(MOVE_CHECKS);
 
-            m_currentPawn->setMoved(true);
-            m_prevPawn = nullptr;
-            return true;
-        }
+    if (startLoc.row < 0 || startLoc.row >= boardX || startLoc.col < 0 || startLoc.col >= boardY ||
+        newLoc.row < 0 || newLoc.row >= boardX || newLoc.col < 0 || newLoc.col >= boardY)
+        return MOVE_NONE;
+
+    // only the moves between the squares are checked for legality
+    MoveList moveList;
+    m_position.generateMoves(moveList);
+
+    int from = makeSquare(startLoc);
+    int to = makeSquare(newLoc);
+
+    for (int i = 0; i < moveList.size; i++)
+    {
+        Move move = moveList.moves[i];
+        if (moveFrom(move) != from || moveTo(move) != to)
+            continue;
+
+        if (moveType(move) == PROMOTION_MOVE && promotionType(move) != QUEEN)
+            continue;
+
+        if (!m_position.isLegal(move))
+            return MOVE_NONE;
+
+        BOARD_STAT(LEGAL_MOVES);
+        return move;
     }
-    
-    return false;
+
+    return MOVE_NONE;
 }
 
 //-----------------------------------------------------------------------------
@@ -284,6 +417,8 @@ bool board::validateMove(BOARD_POINT startLoc,BOARD_POINT newLoc)
 //-----------------------------------------------------------------------------
 void board::processPress(BOARD_POINT pressedSqaure)
 {
+    TRACE_SCOPE("board::processPress");
+
     // we only handle presses if game is still active and there is no units waiting for promotion
     if (m_gameActive && !m_unitPromotion) 
     {        
@@ -318,12 +453,6 @@ void board::processPress(BOARD_POINT pressedSqaure)
             {
                 m_attackSquares.clear();
                 m_moveSquares.clear();
-
-                if ( m_currentPawn->getType() == PAWN)
-                {
-                    if ( m_targetSquare.col == 0 || m_targetSquare.col == 7)
-                        m_unitPromotion = true;
-                }
                 
                 piece* currentPawnTemp = m_currentPawn;
                 BOARD_POINT startSquare = m_startSquare;
@@ -345,13 +474,11 @@ void board::processPress(BOARD_POINT pressedSqaure)
             if ( m_currentPawn == nullptr)
                 return;
 
-            if ( m_currentPawn->getColor() == m_currentPlayer ) 
+            if ( m_currentPawn->getColor() == getCurrentPlayer() ) 
             {
                 m_startSquare = pressedSqaure;
                 m_curStatus += "\n press is Valid";
 
-                m_attackSquares.clear();
-                m_moveSquares.clear();
                 markPawnMoves(m_startSquare);
             }
         }
@@ -362,508 +489,233 @@ void board::processPress(BOARD_POINT pressedSqaure)
 //-----------------------------------------------------------------------------
 // Name : isKingInThreat ()
 //-----------------------------------------------------------------------------
-bool board::isKingInThreat(int player,bool getAllAttackers)
+bool board::isKingInThreat() const
 {
-    int pieceSide,kingSide,maxThreat;
-    m_kingInThreat = false;
-
-    if (player == 1)
-        kingSide = BOTTOM;
-    else
-        kingSide = UPPER;
-
-    if (player == 1)
-        pieceSide = UPPER;
-    else
-        pieceSide = BOTTOM;
-
-    if (getAllAttackers)
-        maxThreat = 2;
-    else
-        maxThreat = 1;
-
-    unsigned int i = 0;
-    int threat = 0;
-
-    std::vector<piece*> pawnTemp=m_pawnsVec[pieceSide];
-    while (i < m_pawnsVec[pieceSide].size() && threat < maxThreat)
-    {
-        piece * pCurPiece = pawnTemp[i];
-
-        BOARD_POINT curPieceSquare = pCurPiece->getPosition();
-        BOARD_POINT curKingSquare  = m_kings[kingSide]->getPosition();
-        
-        if ( (curPieceSquare.row  > 8 || curPieceSquare.row < 0) || ( curPieceSquare.col > 8 || curPieceSquare.col < 0))
-        {
-            i++;
-            //piece is on invalid location so ignore it ... **piece will be on an invalid location only if it is about to be killed
-            continue;
-        }
-
-        int dx = curPieceSquare.row - curKingSquare.row;
-        int dy = curPieceSquare.col - curKingSquare.col;
-
-        if(pCurPiece->validateNewPos(dx, dy, curPieceSquare, curKingSquare, m_board ))
-        {
-            threat++;
-            if (getAllAttackers)
-            {
-                m_attLoc.row = dx;
-                m_attLoc.col = dy;
-            }
-        }
-        i++;
-    }
-    
-    if (getAllAttackers)
-        m_nAttackers=threat;
-
-    if (threat > 0)
-    {
-        m_kingInThreat = true;
-        BOARD_POINT curKingSquare  = m_kings[kingSide]->getPosition();
-        return true;
-    }
-    else
-    {
-        return false;
-    }
-    
-    return false;
+    BOARD_STAT(KING_IN_THREAT);
+    return m_position.inCheck();
 }
 
 //-----------------------------------------------------------------------------
-// Name : reverseMove ()
+// Name : isEndGame ()
 //-----------------------------------------------------------------------------
-void board::reverseMove()
+bool board::isEndGame() const
 {
-    m_board[m_targetSquare.col][m_targetSquare.row] = m_prevPawn;
-    if ( m_prevPawn )
-        m_prevPawn->setBoardPosition( m_targetSquare );
-    
-    m_board[m_startSquare.col][m_startSquare.row]   = m_currentPawn;
-    m_currentPawn->setBoardPosition( m_startSquare );
+    TRACE_SCOPE("board::isEndGame");
+    BOARD_STAT(END_GAME_CHECKS);
+    return m_position.inCheck() && !m_position.hasLegalMove();
 }
 
 //-----------------------------------------------------------------------------
-// Name : isEndGame ()
+// Name : getPieceMoves ()
+// Desc : a promotion is listed once, the piece is chosen after the move
 //-----------------------------------------------------------------------------
-bool board::isEndGame(int curretPlayer)
+void board::getPieceMoves(BOARD_POINT pieceSqaure, std::vector<BOARD_POINT>& moveSquares,
+                          std::vector<BOARD_POINT>& attackSquares) const
 {
-    int side;
-
-    if (curretPlayer == WHITE)
-        side = BOTTOM;
-    else
-        side = UPPER;
+    moveSquares.clear();
+    attackSquares.clear();
 
-    BOARD_POINT kingSquare = m_kings[side]->getPosition();
+    // only the moves of the piece are checked for legality
+    MoveList moveList;
+    m_position.generateMoves(moveList);
 
-    if ( m_nAttackers == 1)
+    int from = makeSquare(pieceSqaure);
+    for (int i = 0; i < moveList.size; i++)
     {
-        //----------------------------------------------------------------
-        //check if we can eat the piece that is attacking               
-        //----------------------------------------------------------------
-        // getting the position of the pawn that is attacking the king
-        m_targetSquare.row = kingSquare.row + m_attLoc.row;
-        m_targetSquare.col = kingSquare.col + m_attLoc.col;
-
-        //getting pawns under the king color
-        std::vector<piece*> pawnTemp = m_pawnsVec[side];     
-        unsigned int i = 0;
-
-        //scanning to check if a pawn can eat the attacking pawn
-        while (i<m_pawnsVec[side].size())
-        {
-            //getting the pawn that we checking for right now
-            piece* curPawn=pawnTemp[i];
-            //BOARD_POINT curPieceSquare,curAttPieceSquare;
-
-            BOARD_POINT curPieceSquare = curPawn->getPosition();
-            // getting the square it is current at
-            m_startSquare = curPieceSquare;
-
-            //getting the location of the attacker on the board
-            BOARD_POINT curAttPieceSquare(kingSquare.row + m_attLoc.row, kingSquare.col + m_attLoc.col);
-
-            //calculating dx dy of curPawn from Attacker
-            int dx = curPieceSquare.row - curAttPieceSquare.row;
-            int dy = curPieceSquare.col - curAttPieceSquare.col;
-
-            if(curPawn->validateNewPos(dx,dy,m_startSquare,m_targetSquare,m_board ))
-            {
-                // if the move is valid checking to see that the king is not threated from
-                // such move if the king is threated than keep scanning 
-                // also after the move was done always reverse it in the end
-                if(!validateKingThreat(curretPlayer))
-                    return false;
-            }
-            i++;
-        }
-        //----------------------------------------------------------------
-        //END of check if we can eat the attacker                       
-        //----------------------------------------------------------------
-
-
-        //----------------------------------------------------------------
-        //checking if a pawn can block the attacker path                
-        //----------------------------------------------------------------
-        m_targetSquare.row = kingSquare.row + m_attLoc.row;
-        m_targetSquare.col = kingSquare.col + m_attLoc.col;
-
-        int AtkPawnType = m_board[m_targetSquare.col][m_targetSquare.row]->getType();
-        int dxxx,dyyy;
+        Move move = moveList.moves[i];
+        if (moveFrom(move) != from || !m_position.isLegal(move))
+            continue;
 
-        if ( m_attLoc.row != 0)
-            dxxx = m_attLoc.row / abs( m_attLoc.row);
-        else
-            dxxx = 0;
+        if (moveType(move) == PROMOTION_MOVE && promotionType(move) != QUEEN)
+            continue;
 
-        if ( m_attLoc.col != 0)
-            dyyy = m_attLoc.col / abs( m_attLoc.col);
+        if (m_position.isCapture(move))
+            attackSquares.emplace_back(squareToPoint(moveTo(move)));
         else
-            dyyy=0;
-
-        m_targetSquare.row = kingSquare.row + dxxx;
-        m_targetSquare.col = kingSquare.col + dyyy;
-
-        // knight king and pawn cannot be blocked
-        if(AtkPawnType != KNIGHT && AtkPawnType != PAWN && AtkPawnType != KING) 
-        {
-            i = 0;
-            //scanning to check if a pawn can eat the attacking pawn
-            while (i < m_pawnsVec[side].size())
-            {
-                int j = kingSquare.row + dxxx;
-                int k = kingSquare.col + dyyy;
-
-                while (j != (kingSquare.row + m_attLoc.row) || k != (kingSquare.col + m_attLoc.col))
-                {
-                    //getting the location of the attacker on the board
-                    m_targetSquare.row = j;
-                    m_targetSquare.col = k;
-
-                    piece* curPawn=pawnTemp[i];//getting the pawn that we checking for right now
-
-                    m_startSquare = curPawn->getPosition(); // getting the square he is current at
-
-                    int dx = m_startSquare.row - m_targetSquare.row;//calculating dx dy of curPawn from 
-                    int dy = m_startSquare.col - m_targetSquare.col;//Attacker
-
-                    if(curPawn->validateNewPos(dx,dy,m_startSquare,m_targetSquare,m_board ))
-                    {
-                        // if the move is valid checking to see that the king is not threated from
-                        // such move if the king is threated than keep scanning 
-                        // also after the move was done always reverse it in the end
-                        if(!validateKingThreat(curretPlayer))
-                            return false;
-                    }
-                    
-                    j+=dxxx;
-                    k+=dyyy;
-                }
-                i++;
-            }
-        }
-        //----------------------------------------------------------------
-        //END of checking if a pawn can block the attacker path         
-        //----------------------------------------------------------------
+            moveSquares.emplace_back(squareToPoint(moveTo(move)));
     }
 
-    //----------------------------------------------------------------
-    //check for if the king can flee to other square from the attack
-    //----------------------------------------------------------------
-    m_startSquare = kingSquare;//getting king square
-
-    //scanning all possible squares that the king can move to 
-    for (int dy = -1; dy < 2; dy++)
-    {
-        for (int dx =- 1; dx < 2; dx++)
-        {
-            if (dx !=0 || dy != 0)
-            {
-                BOARD_POINT kingFleeLoc(kingSquare.row - dx, kingSquare.col - dy); 
-
-                if ( (kingFleeLoc.row < 8 && kingFleeLoc.row >=0) && (kingFleeLoc.col < 8 && kingFleeLoc.col >=0 ) )//checking that we are still in board range
-                {
-                    m_targetSquare = kingFleeLoc;//getting the flee square
-
-                    if( m_kings[side]->validateNewPos(dx,dy,m_startSquare,m_targetSquare,m_board ))
-                    {
-                        // checking that the king can do the move without being threaten
-                        if (!validateKingThreat(curretPlayer))
-                            return false; 
-                    }
-                }
-            }
-        }
-    }
-    //------------------------------------------------------------------------
-    //END of check for if the king can flee to other square from the attack 
-    //------------------------------------------------------------------------
-
-    return true;
+    BOARD_STAT_ADD(LEGAL_MOVES, moveSquares.size() + attackSquares.size());
 }
 
 //-----------------------------------------------------------------------------
-// Name : validateKingThreat ()
+// Name : markPawnMoves ()
 //-----------------------------------------------------------------------------
-bool board::validateKingThreat(int curretPlayer)
+void board::markPawnMoves(BOARD_POINT pieceSqaure)
 {
-    m_prevPawn    = m_board[m_targetSquare.col][m_targetSquare.row];
+    m_startSquare = pieceSqaure;
     m_currentPawn = m_board[m_startSquare.col][m_startSquare.row];
+    if (!m_currentPawn)
+        return;
 
-    if(m_prevPawn != nullptr)
-        m_prevPawn->setBoardPosition(BOARD_POINT(10,10));
-    
-    m_board[m_targetSquare.col][m_targetSquare.row] = m_currentPawn;
-    m_currentPawn->setBoardPosition( m_targetSquare );
-    m_board[m_startSquare.col][m_startSquare.row]   = nullptr;
-    
-    if (!isKingInThreat( m_currentPlayer,false))
-    {
-        reverseMove();
-        m_prevPawn = nullptr;
-        return false;
-    }
-    else
-    {
-        reverseMove();
-        m_prevPawn = nullptr;
-        return true;
-    }
+    BOARD_STAT(MARK_MOVES);
+    getPieceMoves(pieceSqaure, m_moveSquares, m_attackSquares);
 }
 
 //-----------------------------------------------------------------------------
-// Name : canPawnMove ()
+// Name : isDraw ()
 //-----------------------------------------------------------------------------
-bool board::canPawnMove(BOARD_POINT pieceSqaure, int curretPlayer)
+bool board::isDraw() const
 {
-    int dxValues[2];
-    int dyValues[2];
-
-    //getting the current Pawn we are checking for square
-    m_startSquare = pieceSqaure;
-    m_currentPawn = m_board[m_startSquare.col][m_startSquare.row];
+    BOARD_STAT(DRAW_CHECKS);
+    return getDrawType() != NO_DRAW;
+}
 
-    //getting the values of dx/dy should run between in order to cover all possible moves
-    m_currentPawn->getDx(dxValues);
-    m_currentPawn->getDy(dyValues);
-    //scanning all possible squares that the pawn can move to 
-    for (int dy = dyValues[0]; dy < dyValues[1]; dy++)
-    {
-        for (int dx = dxValues[0]; dx < dxValues[1]; dx++)
-        {
-            if (dx != 0 || dy != 0)
-            {
-                BOARD_POINT possibleMoveLoc( m_startSquare.row - dx, m_startSquare.col - dy); 
-                //checking that we are still in board range
-                if ( (possibleMoveLoc.row < boardX && possibleMoveLoc.row >=0) && (possibleMoveLoc.col < boardY && possibleMoveLoc.col >=0 ) )
-                {
-                    //getting the  current possible square
-                    m_targetSquare = possibleMoveLoc;
-                    if( m_currentPawn->validateNewPos(dx,dy,m_startSquare,m_targetSquare,m_board ))
-                    {
-                        // checking that the king can do the move without being threaten
-                        if (!validateKingThreat(curretPlayer))
-                            return true;
-                    }
-                }
-            }
-        }
-    }
-    
-    return false;
+//-----------------------------------------------------------------------------
+// Name : getDrawType ()
+//-----------------------------------------------------------------------------
+DrawType board::getDrawType() const
+{
+    return findDraw(m_position, m_positionKeys);
 }
 
 //-----------------------------------------------------------------------------
-// Name : markPawnMoves ()
+// Name : getPawnKey ()
 //-----------------------------------------------------------------------------
-void board::markPawnMoves(BOARD_POINT pieceSqaure)
+uint64_t board::getPawnKey() const
 {
-    int dxValues[2];
-    int dyValues[2];
+    return m_position.pawnKey();
+}
 
-    //getting the current Pawn we are checking for  square
-    m_startSquare = pieceSqaure;
-    m_currentPawn = m_board[m_startSquare.col][m_startSquare.row];
-    if (!m_currentPawn)
-        return;
-    
-    int curretPlayer = m_currentPawn->getColor();
-    //getting the values of dx/dy should run between in order to cover all possible moves
-    m_currentPawn->getDx(dxValues);
-    m_currentPawn->getDy(dyValues);
+//-----------------------------------------------------------------------------
+// Name : probePawnStructure ()
+//-----------------------------------------------------------------------------
+PawnEntry* board::probePawnStructure(PawnHashTable& pawnTable) const
+{
+    Bitboard pawns[2] = {m_position.pieces(UPPER, PAWN), m_position.pieces(BOTTOM, PAWN)};
+    return pawnTable.probe(getPawnKey(), pawns);
+}
 
-    switch ( m_currentPawn->getType())
-    {
-    case PAWN:
-    case KING:
-    case KNIGHT:
-    {
-        //scanning all possible squares that the pawn can move to 
-        for (int dy = dyValues[0]; dy < dyValues[1]; dy++)
-        {
-            for (int dx = dxValues[0]; dx < dxValues[1]; dx++)
-            {
-                if (dx != 0 || dy != 0)
-                {
-                    //getting current possible square x,y that the pawn can move to
-                    BOARD_POINT possibleMoveLoc(m_startSquare.row - dx, m_startSquare.col - dy); 
-                    //checking that we are still in board range
-                    if ( (possibleMoveLoc.row < 8 && possibleMoveLoc.row >=0) &&
-                        (possibleMoveLoc.col < 8 && possibleMoveLoc.col >=0 ) )
-                    {
-                        // getting the  current possible square
-                        m_targetSquare = possibleMoveLoc;
-                        if( m_currentPawn->validateNewPos(dx,dy,m_startSquare,m_targetSquare,m_board ))
-                        {
-                            //checking that the king
-                            if (!validateKingThreat(curretPlayer))
-                            {
-                                if ( m_board[m_targetSquare.col][m_targetSquare.row] != nullptr)
-                                {
-                                    if (m_board[m_targetSquare.col][m_targetSquare.row]->getColor() != curretPlayer)
-                                        m_attackSquares.emplace_back(m_targetSquare);
-                                    else
-                                        m_moveSquares.emplace_back(m_targetSquare);
-                                }
-                                else
-                                    m_moveSquares.emplace_back(m_targetSquare);
-                            }
-                        }
-                    }
-                }
-            }
-        }
+//-----------------------------------------------------------------------------
+// Name : setAsyncEndGameCheck ()
+//-----------------------------------------------------------------------------
+void board::setAsyncEndGameCheck(bool enabled)
+{
+    m_asyncEndGameCheck = enabled;
+}
 
-        //king was moved to castling pos
-        if ( m_currentPawn->getType() == KING)
-            //make sure the king is not in threat
-            if (!m_kingInThreat)
-            {
-                //getting current possible square x,y that the pawn can move to
-                BOARD_POINT possibleMoveLoc(m_startSquare.row - (-2) , m_startSquare.col - 0); 
+//-----------------------------------------------------------------------------
+// Name : getPosition ()
+//-----------------------------------------------------------------------------
+const Position& board::getPosition() const
+{
+    return m_position;
+}
 
-                m_targetSquare = possibleMoveLoc;
-                if (m_currentPawn->validateNewPos(-2, 0, m_startSquare, m_targetSquare, m_board) )
-                    if (castling(-2, 0)) //check if castling is valid
-                        m_moveSquares.emplace_back(m_targetSquare);
+//-----------------------------------------------------------------------------
+// Name : playMove ()
+// Desc : plays a move given by the engine as if the player made it
+//-----------------------------------------------------------------------------
+bool board::playMove(Move move)
+{
+    if (!m_gameActive || m_unitPromotion || move == MOVE_NONE)
+        return false;
 
-                possibleMoveLoc.row = m_startSquare.row - 3;//getting current possible square x,y that the pawn can move to
-                possibleMoveLoc.col = m_startSquare.col - 0;
-                m_targetSquare = possibleMoveLoc;
+    if (!m_position.isPseudoLegal(move) || !m_position.isLegal(move))
+        return false;
 
-                if (m_currentPawn->validateNewPos(3, 0, m_startSquare, m_targetSquare, m_board) )
-                    if (castling(3, 0)) //check if castling is valid
-                        m_moveSquares.emplace_back(m_targetSquare);
-            }
+    BOARD_POINT startSquare = squareToPoint(moveFrom(move));
+    BOARD_POINT targetSquare = squareToPoint(moveTo(move));
+    piece* movedPiece = m_board[startSquare.col][startSquare.row];
 
-    }break;
+    movePieces(move);
 
-    case BISHOP:
-    {
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(1,1));
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(-1,-1));
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(1,-1));
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(-1,1));
-    }break;
+    m_currentPawn = movedPiece;
+    m_targetSquare = targetSquare;
+    m_attackSquares.clear();
+    m_moveSquares.clear();
 
-    case ROOK:
-    {
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(1,0));
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(0,1));
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(-1,0));
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(0,-1));
-    }break;
+    m_pieceMovedSig(movedPiece, startSquare, targetSquare);
 
-    case QUEEN:
+    if (moveType(move) == PROMOTION_MOVE)
     {
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(1,1));
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(-1,-1));
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(1,-1));
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(-1,1));
-
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(1,0));
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(0,1));
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(-1,0));
-        ScanPawnMoves(pieceSqaure, curretPlayer, DIR_VEC(0,-1));
-    }break;
-
+        // PromoteUnit() ends the turn once the new piece is on the board
+        m_promotionMove = move;
+        m_unitPromotion = true;
+        return PromoteUnit(static_cast<PIECES>(promotionType(move)));
     }
+
+    commitMove(move);
+    endTurn();
+    return true;
 }
 
 //-----------------------------------------------------------------------------
-// Name : ScanPawnMoves ()
+// Name : movePieces ()
+// Desc : castling follows the standard rules so the king lands on the c/g
+//        file and the rook is moved next to it
 //-----------------------------------------------------------------------------
-void board::ScanPawnMoves(BOARD_POINT pieceSqaure, int curretPlayer,DIR_VEC dir)
+void board::movePieces(Move move)
 {
-    // getting the current Pawn we are checking for square
-    BOARD_POINT possibleMoveLoc = pieceSqaure;
-    m_startSquare = pieceSqaure;
-
-    possibleMoveLoc.row = possibleMoveLoc.row + dir.x;
-    possibleMoveLoc.col = possibleMoveLoc.col + dir.y;
+    BOARD_POINT startSquare = squareToPoint(moveFrom(move));
+    BOARD_POINT targetSquare = squareToPoint(moveTo(move));
+    piece* movedPiece = m_board[startSquare.col][startSquare.row];
 
-    while( (possibleMoveLoc.row < 8 && possibleMoveLoc.row >=0) && (possibleMoveLoc.col < 8 && possibleMoveLoc.col >=0 ) )
+    if (moveType(move) == EN_PASSANT_MOVE)
     {
-        m_targetSquare = possibleMoveLoc;//getting the  current possible square
-
-        int dx = m_startSquare.row - m_targetSquare.row;
-        int dy = m_startSquare.col - m_targetSquare.col;
-
-        if(m_currentPawn->validateNewPos(dx, dy, m_startSquare, m_targetSquare, m_board))
-        {
-            //checking that the king
-            if (!validateKingThreat(curretPlayer))
-            {
-                if (m_board[m_targetSquare.col][m_targetSquare.row] != nullptr)
-                {
-                    if (m_board[m_targetSquare.col][m_targetSquare.row]->getColor() != curretPlayer)
-                    {
-                        m_attackSquares.emplace_back(m_targetSquare);
-                        break;
-                    }
-                }
-                else
-                    m_moveSquares.emplace_back(m_targetSquare);
-            }
-        }
+        BOARD_POINT capturedSquare(targetSquare.row, startSquare.col);
+        piece* capturedPawn = m_board[capturedSquare.col][capturedSquare.row];
+
+        // the views drop the piece on the square a piece moves to, so the
+        // captured pawn is first shown on the target square
+        m_pieceMovedSig(capturedPawn, capturedSquare, targetSquare);
+        m_board[capturedSquare.col][capturedSquare.row] = nullptr;
+        killPiece(capturedPawn, capturedSquare);
+    }
+    else if (moveType(move) == CASTLING_MOVE)
+    {
+        bool kingSide = targetSquare.row > startSquare.row;
+        BOARD_POINT rookSquare(kingSide ? boardX - 1 : 0, startSquare.col);
+        BOARD_POINT newRookSquare(kingSide ? targetSquare.row - 1 : targetSquare.row + 1, startSquare.col);
+
+        piece* rookPiece = m_board[rookSquare.col][rookSquare.row];
+        m_board[newRookSquare.col][newRookSquare.row] = rookPiece;
+        m_board[rookSquare.col][rookSquare.row] = nullptr;
+        m_pieceMovedSig(rookPiece, rookSquare, newRookSquare);
+        rookPiece->setBoardPosition(newRookSquare);
+        rookPiece->setMoved(true);
+    }
+    else
+    {
+        piece* targetPiece = m_board[targetSquare.col][targetSquare.row];
+        if (targetPiece != nullptr)
+            killPiece(targetPiece, targetSquare);
+    }
 
-        possibleMoveLoc.row = possibleMoveLoc.row + dir.x;
-        possibleMoveLoc.col = possibleMoveLoc.col + dir.y;
-     }
+    m_board[targetSquare.col][targetSquare.row] = movedPiece;
+    m_board[startSquare.col][startSquare.row] = nullptr;
+    movedPiece->setBoardPosition(targetSquare);
+    movedPiece->setMoved(true);
 }
 
 //-----------------------------------------------------------------------------
-// Name : isDraw ()
+// Name : commitMove ()
 //-----------------------------------------------------------------------------
-bool board::isDraw(int currentPlayer)
+void board::commitMove(Move move)
 {
-    int side;
-    if (currentPlayer == 1)
-        side = BOTTOM;
-    else
-        side = UPPER;
-
-    unsigned int i = 0;
-    std::vector<piece*> pawnTemp = m_pawnsVec[side];
-
-    while (i < m_pawnsVec[side].size())
-    {
-        BOARD_POINT curPieceSquare = pawnTemp[i]->getPosition();
-        if(canPawnMove(curPieceSquare, currentPlayer))
-            return false;
-        i++;
-    }
-    
-    return true;
+    UndoInfo undo;
+    m_position.doMove(move, undo);
+    m_moveHistory.push_back(move);
+    m_positionKeys.push_back(m_position.key());
 }
 
 //-----------------------------------------------------------------------------
 // Name : createPiece ()
 //-----------------------------------------------------------------------------
 piece* board::createPiece(int playerColor, PIECES pieceType, BOARD_POINT piecePos)
+{
+    piece* pCurPiece = newPiece(playerColor, pieceType, piecePos);
+    if (pCurPiece)
+        m_pieceCreatedSig(pCurPiece);
+
+    return pCurPiece;
+}
+
+//-----------------------------------------------------------------------------
+// Name : newPiece ()
+// Desc : creates a piece owned by the board without telling the views
+//-----------------------------------------------------------------------------
+piece* board::newPiece(int playerColor, PIECES pieceType, BOARD_POINT piecePos)
 {
     piece* pCurPiece = nullptr;
     
@@ -902,7 +754,6 @@ piece* board::createPiece(int playerColor, PIECES pieceType, BOARD_POINT piecePo
     else
         m_pawnsVec[BOTTOM].push_back(pCurPiece);
     
-    m_pieceCreatedSig(pCurPiece);
     return pCurPiece; 
 }
     
@@ -932,13 +783,7 @@ bool board::createStartingPiece(int i, int j, int playerColor)
             pNewPiece = createPiece(playerColor, QUEEN, piecePos);
 
         if (j == 4)
-        {
             pNewPiece = createPiece(playerColor, KING, piecePos);
-            if (playerColor == BLACK)
-                m_kings[UPPER] =  (king*)pNewPiece;
-            else
-                m_kings[BOTTOM] = (king*)pNewPiece;
-        }
     }
     
     if(pNewPiece != nullptr)
@@ -953,7 +798,7 @@ bool board::createStartingPiece(int i, int j, int playerColor)
 //-----------------------------------------------------------------------------
 // Name : connectToPieceCreated ()
 //-----------------------------------------------------------------------------
-void board::connectToPieceCreated(const singal_pieceCreated::slot_type& subscriber)
+void board::connectToPieceCreated(const PieceCreatedDelegate& subscriber)
 {
     m_pieceCreatedSig.connect(subscriber);
 }
@@ -961,7 +806,7 @@ void board::connectToPieceCreated(const singal_pieceCreated::slot_type& subscrib
 //-----------------------------------------------------------------------------
 // Name : connectToPieceMoved ()
 //-----------------------------------------------------------------------------
-void board::connectToPieceMoved(const signal_pieceMoved::slot_type& subscriber)
+void board::connectToPieceMoved(const PieceMovedDelegate& subscriber)
 {
     m_pieceMovedSig.connect(subscriber);
 }
@@ -969,7 +814,7 @@ void board::connectToPieceMoved(const signal_pieceMoved::slot_type& subscriber)
 //-----------------------------------------------------------------------------
 // Name : connectToPieceKilled ()
 //-----------------------------------------------------------------------------
-void board::connectToPieceKilled(const signal_pieceKilled::slot_type& subscriber)
+void board::connectToPieceKilled(const PieceKilledDelegate& subscriber)
 {
     m_pieceKilledSig.connect(subscriber);
 }
@@ -977,7 +822,7 @@ void board::connectToPieceKilled(const signal_pieceKilled::slot_type& subscriber
 //-----------------------------------------------------------------------------
 // Name : connectToGameOver ()
 //-----------------------------------------------------------------------------
-void board::connectToGameOver(const singal_gameover::slot_type& subscriber)
+void board::connectToGameOver(const GameOverDelegate& subscriber)
 {
     m_gameOverSig.connect(subscriber);
 }
@@ -985,7 +830,7 @@ void board::connectToGameOver(const singal_gameover::slot_type& subscriber)
 //-----------------------------------------------------------------------------
 // Name : conntectToEndTurn ()
 //-----------------------------------------------------------------------------
-void board::conntectToEndTurn( const signal_endTurn::slot_type& subscriber )
+void board::conntectToEndTurn(const EndTurnDelegate& subscriber)
 {
     m_endTurnSig.connect(subscriber);
 }
@@ -995,60 +840,43 @@ void board::conntectToEndTurn( const signal_endTurn::slot_type& subscriber )
 //-----------------------------------------------------------------------------
 void board::endTurn()
 {
-    m_currentPlayer *=-1;
-
-    if (isKingInThreat( m_currentPlayer,true))
-    {
-        if(isEndGame( m_currentPlayer ))
-        {
-            m_gameActive = false;
-            m_curStatus = "CheckMate";
+    TRACE_SCOPE("board::endTurn");
 
-            std::string endGameStatus;
+    int currentPlayer = getCurrentPlayer();
+    journalMoves();
 
-            if ( m_currentPlayer == 1)
-                endGameStatus = "Black Wins!";
-            else
-                endGameStatus = "White Wins!";
+    bool kingInThreat = isKingInThreat();
+    if (kingInThreat)
+        m_threatSquare = squareToPoint(m_position.kingSquare(m_position.sideToMove()));
+    else
+        m_threatSquare = BOARD_POINT(-1, -1);
 
-            m_gameOverSig(endGameStatus);
+    // a mate on the move that completes the fifty moves still wins, so the
+    // mate is looked for before the draws
+    bool mated = !m_asyncEndGameCheck && kingInThreat && isEndGame();
+    DrawType drawType = (m_asyncEndGameCheck || mated) ? NO_DRAW : getDrawType();
 
-            int kingSide;
+    if (mated)
+    {
+        m_gameActive = false;
+        m_curStatus = "CheckMate";
 
-            if ( m_currentPlayer == 1)
-                kingSide = BOTTOM;
-            else
-                kingSide = UPPER;
+        std::string endGameStatus;
 
-            m_threatSquare = m_kings[kingSide]->getPosition();
-        }
+        if ( currentPlayer == WHITE)
+            endGameStatus = "Black Wins!";
         else
-        {
-            int kingSide;
-            if ( m_currentPlayer == 1)
-                kingSide = BOTTOM;
-            else
-                kingSide = UPPER;
+            endGameStatus = "White Wins!";
 
-            m_threatSquare = m_kings[kingSide]->getPosition();
-            m_endTurnSig( m_currentPlayer );
-        }
+        m_gameOverSig(endGameStatus);
+    }
+    else if (drawType != NO_DRAW)
+    {
+        declareDraw(drawType);
     }
     else
     {
-        m_threatSquare = BOARD_POINT(-1, -1);
-        if (isDraw( m_currentPlayer ))
-        {
-            m_gameActive = false;
-            m_curStatus = "Draw";
-
-            std::string endGameStatus = "Draw";
-            m_gameOverSig(endGameStatus);
-        }
-        else
-        {
-            m_endTurnSig( m_currentPlayer );
-        }
+        m_endTurnSig( currentPlayer );
     }
 
     m_startSquare.row = -1;
@@ -1056,17 +884,33 @@ void board::endTurn()
 }
 
 //-----------------------------------------------------------------------------
-// Name : killPiece ()
+// Name : declareGameOver ()
 //-----------------------------------------------------------------------------
-void board::killPiece(piece * pPieceToKill, BOARD_POINT pieceSquare)
+void board::declareGameOver(const std::string& endGameStatus)
 {
-    int side;
+    m_gameActive = false;
+    m_curStatus = endGameStatus;
+    m_gameOverSig(endGameStatus);
+}
 
-    if ( m_currentPlayer == BLACK)
-        side = BOTTOM;
-    else
-        side = UPPER;
+//-----------------------------------------------------------------------------
+// Name : declareDraw ()
+//-----------------------------------------------------------------------------
+void board::declareDraw(DrawType drawType)
+{
+    m_gameActive = false;
+    m_curStatus = std::string("Draw by ") + drawTypeToString(drawType);
 
+    std::string endGameStatus = "Draw";
+    m_gameOverSig(endGameStatus);
+}
+
+//-----------------------------------------------------------------------------
+// Name : killPiece ()
+//-----------------------------------------------------------------------------
+void board::killPiece(piece * pPieceToKill, BOARD_POINT pieceSquare)
+{
+    int side = colorToSide(pPieceToKill->getColor());
     std::vector<piece*> &curVector = m_pawnsVec[side];
 
     for (unsigned int i = 0; i < curVector.size(); i++)
@@ -1088,7 +932,7 @@ void board::killPiece(piece * pPieceToKill, BOARD_POINT pieceSquare)
 //-----------------------------------------------------------------------------
 int board::getCurrentPlayer() const
 {
-    return m_currentPlayer;
+    return (m_position.sideToMove() == BOTTOM) ? WHITE : BLACK;
 }
 
 //-----------------------------------------------------------------------------
@@ -1147,18 +991,79 @@ const std::vector<BOARD_POINT>& board::getAttackSquares() const
     return m_attackSquares;
 }
 
+//-----------------------------------------------------------------------------
+// Name : stats ()
+//-----------------------------------------------------------------------------
+BoardStats board::stats()
+{
+#ifdef CHESS_BOARD_STATS
+    return BoardStatsCounters::collect();
+#else
+    return BoardStats();
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Name : resetStats ()
+//-----------------------------------------------------------------------------
+void board::resetStats()
+{
+#ifdef CHESS_BOARD_STATS
+    BoardStatsCounters::reset();
+#endif
+}
+
 //-----------------------------------------------------------------------------
 // Name : getKingThreat ()
 //-----------------------------------------------------------------------------
 bool board::getKingThreat () const
 {
-    return m_kingInThreat;
+    return m_position.inCheck();
 }
 
 //-----------------------------------------------------------------------------
 // Name : resetGame ()
 //-----------------------------------------------------------------------------
 bool board::resetGame()
+{
+    clearBoard();
+
+    for (int i = 0; i < 2; i++)
+    {
+        for (int j = 0; j < boardX; j++)
+        {
+            if(!createStartingPiece(i,j, BLACK))
+                return false;
+        }
+    }
+
+    for (int i = boardY - 2; i < boardY; i++)
+    {
+        for (int j = 0; j < boardX; j++)
+        {
+            if(!createStartingPiece(i,j, WHITE))
+                return false;
+        }
+    }
+
+    m_position.setStartPosition();
+    m_startPosition = m_position;
+    m_moveHistory.clear();
+    m_positionKeys.assign(1, m_position.key());
+    m_gameActive = true;
+    m_unitPromotion = false;
+    m_promotionMove = MOVE_NONE;
+
+    if (m_journaling)
+        SaveBoardToFile();
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : clearBoard ()
+//-----------------------------------------------------------------------------
+void board::clearBoard()
 {
     for (unsigned int i = 0; i < boardX; i++)
         for (unsigned int j = 0; j < boardY; j++)
@@ -1167,13 +1072,11 @@ bool board::resetGame()
     m_startSquare  = BOARD_POINT(-1, -1);
     m_targetSquare = BOARD_POINT(0,0);
     m_threatSquare = BOARD_POINT(-1, -1);
-    m_attLoc       = BOARD_POINT(0,0);
 
     m_currentPawn = nullptr;
-    m_prevPawn    = nullptr;
 
-    m_kings[BOTTOM] = nullptr;
-    m_kings[UPPER]  = nullptr;
+    m_attackSquares.clear();
+    m_moveSquares.clear();
 
     m_deadPawnsVec[UPPER].clear();
     m_deadPawnsVec[BOTTOM].clear();
@@ -1191,119 +1094,149 @@ bool board::resetGame()
 
     m_pawnsVec[UPPER].clear();
     m_pawnsVec[BOTTOM].clear();
+}
 
-    m_pieceCount = 0;
-    for (int i = 0; i < 2; i++)
-    {
-        for (int j = 0; j < boardX; j++)
-        {
-            if(!createStartingPiece(i,j, BLACK))
-                return false;
-        }
-    }
-
-    for (int i = boardY - 2; i < boardY; i++)
-    {
-        for (int j = 0; j < boardX; j++)
-        {
-            if(!createStartingPiece(i,j, WHITE))
-                return false;
-        }
-    }
+//-----------------------------------------------------------------------------
+// Name : setFromFEN ()
+// Desc : the fen is parsed and checked by the engine position
+//-----------------------------------------------------------------------------
+bool board::setFromFEN(const std::string& fen)
+{
+    Position pos;
+    if (!pos.setFromFEN(fen))
+        return false;
 
-    m_currentPlayer = 1;
-    m_gameActive = true;
-    m_kingInThreat = false;
+    setPosition(pos);
+    if (m_journaling)
+        SaveBoardToFile();
 
     return true;
 }
 
 //-----------------------------------------------------------------------------
-// Name : PromoteUnit ()
+// Name : setPosition ()
+// Desc : the board takes the pieces from the position. kings and rooks that
+//        keep a castling right and pawns on their starting rank are marked as
+//        never moved. the position starts a new move history
 //-----------------------------------------------------------------------------
-bool board::PromoteUnit(PIECES type)
+void board::setPosition(const Position& pos)
 {
-    SIDES curSide;
-    int pieceIndex = -1;
-
-    if ( m_currentPawn->getColor() == 1)
-        curSide = BOTTOM;
-    else
-        curSide = UPPER;
+    clearBoard();
 
-    std::vector<piece*>& curPieceVec = m_pawnsVec[curSide];
+    const int rightsOO[2]  = {BLACK_OO, WHITE_OO};
+    const int rightsOOO[2] = {BLACK_OOO, WHITE_OOO};
 
-    if ( m_currentPawn )
+    for (int square = 0; square < SQUARE_NB; square++)
     {
-        for (unsigned int i = 0; i < curPieceVec.size(); i++)
-        {
-            if (curPieceVec[i] == m_currentPawn )
-            {
-                pieceIndex = i;
-                curPieceVec.erase(curPieceVec.begin() + pieceIndex);//remove the piece from the vector
-                break;
-            }
-        }
+        int curPiece = pos.pieceOn(square);
+        if (curPiece == NO_PIECE)
+            continue;
 
-        if (pieceIndex != -1)
-        {
-            if ( m_currentPawn->getColor() == WHITE)
-                pieceIndex += 16; 
+        int side = pieceSide(curPiece);
+        int type = pieceType(curPiece);
+        int color = (side == BOTTOM) ? WHITE : BLACK;
+        BOARD_POINT piecePos = squareToPoint(square);
+
+        piece* pNewPiece = newPiece(color, static_cast<PIECES>(type), piecePos);
+        m_board[piecePos.col][piecePos.row] = pNewPiece;
+
+        int backRank = (side == BOTTOM) ? boardY - 1 : 0;
+        bool unmoved = false;
+
+        if (type == PAWN)
+            unmoved = relativeRank(side, square) == 1;
+        else if (type == KING)
+            unmoved = piecePos.col == backRank && piecePos.row == 4 &&
+                      (pos.castlingRights() & (rightsOO[side] | rightsOOO[side]));
+        else if (type == ROOK && piecePos.col == backRank)
+            unmoved = (piecePos.row == boardX - 1 && (pos.castlingRights() & rightsOO[side])) ||
+                      (piecePos.row == 0 && (pos.castlingRights() & rightsOOO[side]));
+        else
+            unmoved = true;
 
-            m_currentPawn = nullptr;
-            piece* pNewPiece = nullptr;
-            if ( m_currentPlayer == WHITE)
-                pNewPiece = createPiece(WHITE, type, m_targetSquare );
-            else
-                pNewPiece = createPiece(BLACK, type, m_targetSquare );
+        pNewPiece->setMoved(!unmoved);
+    }
 
-            if (pNewPiece)
-                m_board[m_targetSquare.col][m_targetSquare.row] = pNewPiece;
-            else
-                return false;
-            
-            m_unitPromotion = false;
-            //the new promoted piece is now part of the board so we can end the player turn
-            endTurn();
-        }
+    m_position = pos;
 
-    }
-    else 
-        return false;
+    m_gameActive = true;
+    m_unitPromotion = false;
+    m_promotionMove = MOVE_NONE;
 
-    return true;
+    m_startPosition = pos;
+    m_moveHistory.clear();
+    m_positionKeys.assign(1, m_position.key());
+
+    if (m_position.inCheck())
+        m_threatSquare = squareToPoint(m_position.kingSquare(m_position.sideToMove()));
 }
 
 //-----------------------------------------------------------------------------
-// Name : castling ()
+// Name : getStartPosition ()
 //-----------------------------------------------------------------------------
-bool board::castling(int dx , int dy)
+const Position& board::getStartPosition() const
 {
+    return m_startPosition;
+}
 
-    int x = dx/abs(dx);
-    int y = m_startSquare.col;
+//-----------------------------------------------------------------------------
+// Name : getMoveHistory ()
+//-----------------------------------------------------------------------------
+const std::vector<Move>& board::getMoveHistory() const
+{
+    return m_moveHistory;
+}
 
-    x = m_startSquare.row - dx -x;
+//-----------------------------------------------------------------------------
+// Name : getPositionKeys ()
+//-----------------------------------------------------------------------------
+const std::vector<uint64_t>& board::getPositionKeys() const
+{
+    return m_positionKeys;
+}
 
-    BOARD_POINT newRookSquare(x + 2 * (dx / abs(dx)), y);
+//-----------------------------------------------------------------------------
+// Name : toFEN ()
+//-----------------------------------------------------------------------------
+std::string board::toFEN() const
+{
+    return m_position.toFEN();
+}
 
-    piece * rookPiece = m_board[y][x]; 
-    if (rookPiece != NULL)
+//-----------------------------------------------------------------------------
+// Name : PromoteUnit ()
+//-----------------------------------------------------------------------------
+bool board::PromoteUnit(PIECES type)
+{
+    if (!m_unitPromotion || m_promotionMove == MOVE_NONE || type < KNIGHT || type > QUEEN)
+        return false;
+
+    BOARD_POINT targetSquare = squareToPoint(moveTo(m_promotionMove));
+    piece* pawnPiece = m_board[targetSquare.col][targetSquare.row];
+    int color = pawnPiece->getColor();
+
+    std::vector<piece*>& curPieceVec = m_pawnsVec[colorToSide(color)];
+    for (unsigned int i = 0; i < curPieceVec.size(); i++)
     {
-        if (rookPiece->getType() == ROOK && !rookPiece->isMoved())
+        if (curPieceVec[i] == pawnPiece)
         {
-            dx = dx / abs(dx);
-            for (int i = m_startSquare.row - dx; i != x; i -= dx)
-            {
-                m_targetSquare.col = y;
-                m_targetSquare.row = i;
-                if ( validateKingThreat( m_currentPlayer ) )
-                    return false;
-            }
-            
-            return true;
+            curPieceVec.erase(curPieceVec.begin() + i);//remove the piece from the vector
+            break;
         }
     }
-    
-    return false;
-} 
+
+    m_currentPawn = nullptr;
+    piece* pNewPiece = createPiece(color, type, targetSquare);
+    if (!pNewPiece)
+        return false;
+
+    m_board[targetSquare.col][targetSquare.row] = pNewPiece;
+    commitMove(makePromotion(moveFrom(m_promotionMove), moveTo(m_promotionMove), type));
+
+    m_promotionMove = MOVE_NONE;
+    m_unitPromotion = false;
+    //the new promoted piece is now part of the board so we can end the player turn
+    endTurn();
+
+    return true;
+}
@@ -23,10 +23,6 @@
 #include <iostream>
 #include <string>
 #include <sstream>
-#include <boost/signals2/signal.hpp>
-#include <boost/bind/bind.hpp>
-#undef min
-#undef max
 #include <fstream>
 #include <vector>
 
@@ -38,20 +34,28 @@
 #include "Rook.h"
 #include "Pawn.h"
 #include "Queen.h"
-
-class king;
-
-enum COLORS{BLACK = -1,WHITE = 1};
-enum SIDES {UPPER, BOTTOM};
-
+#include "Zobrist.h"
+#include "PawnHash.h"
+#include "Position.h"
+#include "GameJournal.h"
+#include "BoardStats.h"
+#include "Delegate.h"
+#include "DrawRules.h"
+
+// the interactive game : the rules and the game state live in a Position,
+// the board keeps the piece objects the views draw in step with it and holds
+// what the player selected. every query about the game is a const function
+// of the position, so it can be asked from any thread that holds a copy
 class board
 {
 public:
-    typedef boost::signals2::signal<void (piece*)>       singal_pieceCreated;
-    typedef boost::signals2::signal<void (piece*, BOARD_POINT, BOARD_POINT)> signal_pieceMoved;
-    typedef boost::signals2::signal<void (piece*)>       signal_pieceKilled;
-    typedef boost::signals2::signal<void (std::string)>  singal_gameover;
-    typedef boost::signals2::signal<void (int)>          signal_endTurn;
+    // the views are told about the changes through these, a board without
+    // observers(the engine tools) pays only an empty loop per event
+    typedef Delegate<void (piece*)>                           PieceCreatedDelegate;
+    typedef Delegate<void (piece*, BOARD_POINT, BOARD_POINT)> PieceMovedDelegate;
+    typedef Delegate<void (piece*)>                           PieceKilledDelegate;
+    typedef Delegate<void (std::string)>                      GameOverDelegate;
+    typedef Delegate<void (int)>                              EndTurnDelegate;
 
     //-------------------------------------------------------------------------
     // Constructors & Destructors for This Class.
@@ -64,47 +68,92 @@ public:
     piece*      createPiece(int playerColor, PIECES pieceType, BOARD_POINT piecePos);
     bool        createStartingPiece(int i, int j, int playerColor);
 
-    void        connectToPieceCreated   (const singal_pieceCreated::slot_type& subscriber);
-    void        connectToPieceMoved     (const signal_pieceMoved::slot_type& subscriber);
-    void        connectToPieceKilled     (const signal_pieceKilled::slot_type& subscriber);
-    void        connectToGameOver       (const singal_gameover::slot_type& subscriber);
-    void        conntectToEndTurn       (const signal_endTurn::slot_type& subscriber );
+    void        connectToPieceCreated   (const PieceCreatedDelegate& subscriber);
+    void        connectToPieceMoved     (const PieceMovedDelegate& subscriber);
+    void        connectToPieceKilled    (const PieceKilledDelegate& subscriber);
+    void        connectToGameOver       (const GameOverDelegate& subscriber);
+    void        conntectToEndTurn       (const EndTurnDelegate& subscriber);
 
     void        killPiece(piece * pPieceToKill, BOARD_POINT pieceSquare);
+    // reports the position after a move : journals it, finds the threatened
+    // king and the end of the game and tells the views whose turn it is
     void        endTurn();
-    void        reverseMove();
+    void        declareGameOver(const std::string& endGameStatus);
+    // ends the game as a "Draw" with the rule in the status
+    void        declareDraw(DrawType drawType);
     bool        resetGame();
 
     void        SaveBoardToFile();
     bool        LoadBoardFromFile();
+    // the save file contents without the file, decodeSave() sets up the
+    // game but replays no journal
+    std::vector<uint8_t> encodeSave() const;
+    bool        decodeSave(const std::vector<uint8_t>& data);
+    // board.sav and board.journal in the working directory unless set
+    void        setSaveFiles(const std::string& saveFile, const std::string& journalFile);
+    // when enabled every move is appended to a journal next to the save file
+    // and a new snapshot is saved every few dozen moves, loading replays the
+    // journal so a crash loses at most the last few moves
+    void        setJournaling(bool enabled);
+
+    // sets up any position including castling rights, en passant square and
+    // move counters. the pieces are created without a created signal per
+    // piece, so a view has to be rebuilt from the board afterwards
+    bool        setFromFEN (const std::string& fen);
+    void        setPosition(const Position& pos);
+    std::string toFEN      () const;
 
     //-------------------------------------------------------------------------
     // Functions that control the pawn movement logic
     //-------------------------------------------------------------------------
     void processPress(BOARD_POINT pressedSqaure);
     bool PromoteUnit (PIECES type);
+    // plays the move from the selected piece when the rules allow it, a pawn
+    // reaching the last rank waits for PromoteUnit()
     bool validateMove(BOARD_POINT startLoc,BOARD_POINT newLoc);
-    bool castling(int dx , int dy);
+    bool playMove(Move move);
+    // the legal move between the squares, a promotion is returned as a queen
+    Move findMove(BOARD_POINT startLoc, BOARD_POINT newLoc) const;
 
     //-------------------------------------------------------------------------
     // Functions that detect if the game has come to an end
     //-------------------------------------------------------------------------
-    bool isEndGame(int curretPlayer);
-    bool isDraw(int currentPlayer);
-
+    // the player to move is mated
+    bool isEndGame() const;
+    // a draw rule ends the game
+    bool isDraw() const;
+    // the rule that draws the game : insufficient material, threefold
+    // repetition, the fifty move rule or stalemate, NO_DRAW otherwise
+    DrawType getDrawType() const;
+    // when enabled endTurn() skips the mate and stalemate search and the
+    // owner reports the result later through declareGameOver() or declareDraw()
+    void setAsyncEndGameCheck(bool enabled);
 
     //-------------------------------------------------------------------------
     // Functions that help detect if the king is in threat
     //-------------------------------------------------------------------------
-    bool isKingInThreat(int player,bool getAllAttackers);
-    bool validateKingThreat(int curretPlayer);
+    bool isKingInThreat() const;
 
     //-------------------------------------------------------------------------
-    // Functions that detect if pawns can move or is it stuck in his place
+    // Functions that find where the pieces can move
     //-------------------------------------------------------------------------
-    bool canPawnMove    (BOARD_POINT pieceSqaure, int curretPlayer);
+    // the empty squares and the captures the piece on the square can move to
+    void getPieceMoves  (BOARD_POINT pieceSqaure, std::vector<BOARD_POINT>& moveSquares,
+                         std::vector<BOARD_POINT>& attackSquares) const;
+    // selects the piece and marks its moves for the views
     void markPawnMoves  (BOARD_POINT pieceSqaure);
-    void ScanPawnMoves  (BOARD_POINT pieceSqaure, int curretPlayer, DIR_VEC dir);
+
+    //-------------------------------------------------------------------------
+    // Functions that evaluate the pawn structure
+    //-------------------------------------------------------------------------
+    uint64_t        getPawnKey() const;
+    PawnEntry*      probePawnStructure(PawnHashTable& pawnTable) const;
+    const Position& getPosition() const;
+    // the moves played since the start position, in engine encoding
+    const Position&          getStartPosition() const;
+    const std::vector<Move>& getMoveHistory  () const;
+    // the keys of the positions of the game, the current one last
+    const std::vector<uint64_t>& getPositionKeys() const;
 
     //-------------------------------------------------------------------------
     // Get methods for this class
@@ -120,45 +169,66 @@ public:
     const std::vector<BOARD_POINT>& getMoveSquares() const;
     const std::vector<BOARD_POINT>& getAttackSquares() const;
 
+    // the counters of the move logic summed over every thread, always zero
+    // unless the engine is built with CHESS_BOARD_STATS
+    static BoardStats stats     ();
+    static void       resetStats();
+
 private:
-    //the actual game board indicate what piece on what square
+    piece*      newPiece     (int playerColor, PIECES pieceType, BOARD_POINT piecePos);
+    void        clearBoard   ();
+    // moves the piece objects for the move, the captured piece is killed and
+    // the rook of a castling is moved with the signals the views expect
+    void        movePieces   (Move move);
+    // the move enters the position and the move history
+    void        commitMove   (Move move);
+    void        journalMoves ();
+    void        replayJournal(bool bFileCastling);
+    void        rebuildPositionKeys();
+
+    //the piece objects by square, in step with m_position
     piece * m_board[boardY][boardX];
+    // the game itself
+    Position m_position;
 
     //the pawn that currently  being moved
     piece * m_currentPawn;
-    //used to save the piece on the target square in order to reverse if the move is not valid
-    piece * m_prevPawn;
 
     //the square that was pressed
     BOARD_POINT  m_startSquare;
     // the square that the piece should be moved to 
     BOARD_POINT  m_targetSquare;
     BOARD_POINT  m_threatSquare;
+    // the pawn move that waits for the piece to promote to
+    Move         m_promotionMove;
 
     std::vector<piece*> m_pawnsVec[2];
     std::vector<piece*> m_deadPawnsVec[2];
 
-    king * m_kings[2];
-    int m_nAttackers;
-
-    BOARD_POINT m_attLoc;
-
-    unsigned int m_pieceCount;
-
-    int m_currentPlayer;
+    Position m_startPosition;
+    std::vector<Move> m_moveHistory;
+    // the key of every position of the game, the current one last
+    std::vector<uint64_t> m_positionKeys;
+
+    std::string m_saveFile;
+    std::string m_journalFile;
+    GameJournal m_journal;
+    bool m_journaling;
+    uint32_t m_snapshotId;      // crc of the last snapshot saved or loaded
+    size_t m_snapshotMoves;     // moves of the history in that snapshot
     bool m_gameActive;
     bool m_unitPromotion;
-    bool m_kingInThreat;
+    bool m_asyncEndGameCheck;
     std::string m_curStatus;
 
     std::vector<BOARD_POINT> m_moveSquares;
     std::vector<BOARD_POINT> m_attackSquares;
     
-    boost::signals2::signal<void (piece*)>  m_pieceCreatedSig;
-    boost::signals2::signal<void (piece*, BOARD_POINT, BOARD_POINT)>  m_pieceMovedSig;
-    boost::signals2::signal<void (piece*)>  m_pieceKilledSig;
-    boost::signals2::signal<void (std::string)> m_gameOverSig;
-    boost::signals2::signal<void (int)>         m_endTurnSig;
+    DelegateList<void (piece*)>                           m_pieceCreatedSig;
+    DelegateList<void (piece*, BOARD_POINT, BOARD_POINT)> m_pieceMovedSig;
+    DelegateList<void (piece*)>                           m_pieceKilledSig;
+    DelegateList<void (std::string)>                      m_gameOverSig;
+    DelegateList<void (int)>                              m_endTurnSig;
     
 };
 #endif // _BOARD_H_ 
@@ -0,0 +1,146 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "BoardStats.h"
+#include <sstream>
+#ifdef CHESS_BOARD_STATS
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#endif
+
+namespace
+{
+    const char* const CounterNames[BoardStats::COUNTER_NB] =
+    {
+        "findMove", "isKingInThreat", "legalMoves", "markPawnMoves", "isEndGame", "isDraw"
+    };
+
+#ifdef CHESS_BOARD_STATS
+    // every thread that counted, plus the totals of the threads that ended
+    struct CounterRegistry
+    {
+        std::mutex                       mutex;
+        std::vector<BoardStatsCounters*> threads;
+        BoardStats                       retired;
+    };
+
+    CounterRegistry& registry()
+    {
+        static CounterRegistry counterRegistry;
+        return counterRegistry;
+    }
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Name : BoardStats (constructor)
+//-----------------------------------------------------------------------------
+BoardStats::BoardStats()
+{
+    for (int i = 0; i < COUNTER_NB; i++)
+        counters[i] = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : counterName ()
+//-----------------------------------------------------------------------------
+const char* BoardStats::counterName(int counter)
+{
+    if (counter < 0 || counter >= COUNTER_NB)
+        return "";
+
+    return CounterNames[counter];
+}
+
+//-----------------------------------------------------------------------------
+// Name : toString ()
+//-----------------------------------------------------------------------------
+std::string BoardStats::toString() const
+{
+    std::ostringstream out;
+    for (int i = 0; i < COUNTER_NB; i++)
+        out << (i ? " " : "") << CounterNames[i] << " " << counters[i];
+
+    return out.str();
+}
+
+#ifdef CHESS_BOARD_STATS
+
+//-----------------------------------------------------------------------------
+// Name : BoardStatsCounters (constructor)
+//-----------------------------------------------------------------------------
+BoardStatsCounters::BoardStatsCounters()
+{
+    for (int i = 0; i < BoardStats::COUNTER_NB; i++)
+        m_values[i] = 0;
+
+    CounterRegistry& counterRegistry = registry();
+    std::lock_guard<std::mutex> lock(counterRegistry.mutex);
+    counterRegistry.threads.push_back(this);
+}
+
+//-----------------------------------------------------------------------------
+// Name : BoardStatsCounters (destructor)
+// Desc : the counts of an ending thread move to the retired totals
+//-----------------------------------------------------------------------------
+BoardStatsCounters::~BoardStatsCounters()
+{
+    CounterRegistry& counterRegistry = registry();
+    std::lock_guard<std::mutex> lock(counterRegistry.mutex);
+
+    for (int i = 0; i < BoardStats::COUNTER_NB; i++)
+        counterRegistry.retired.counters[i] += m_values[i].load(std::memory_order_relaxed);
+
+    std::vector<BoardStatsCounters*>& threads = counterRegistry.threads;
+    threads.erase(std::remove(threads.begin(), threads.end(), this), threads.end());
+}
+
+//-----------------------------------------------------------------------------
+// Name : collect ()
+//-----------------------------------------------------------------------------
+BoardStats BoardStatsCounters::collect()
+{
+    CounterRegistry& counterRegistry = registry();
+    std::lock_guard<std::mutex> lock(counterRegistry.mutex);
+
+    BoardStats stats = counterRegistry.retired;
+    for (BoardStatsCounters* curThread : counterRegistry.threads)
+        for (int i = 0; i < BoardStats::COUNTER_NB; i++)
+            stats.counters[i] += curThread->m_values[i].load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+//-----------------------------------------------------------------------------
+// Name : reset ()
+//-----------------------------------------------------------------------------
+void BoardStatsCounters::reset()
+{
+    CounterRegistry& counterRegistry = registry();
+    std::lock_guard<std::mutex> lock(counterRegistry.mutex);
+
+    counterRegistry.retired = BoardStats();
+    for (BoardStatsCounters* curThread : counterRegistry.threads)
+        for (int i = 0; i < BoardStats::COUNTER_NB; i++)
+            curThread->m_values[i].store(0, std::memory_order_relaxed);
+}
+
+#endif // CHESS_BOARD_STATS
@@ -0,0 +1,111 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BOARDSTATS_H_
+#define _BOARDSTATS_H_
+
+#include <cstdint>
+#include <string>
+#ifdef CHESS_BOARD_STATS
+#include <atomic>
+#endif
+
+// counts of the work the board move logic does. the counters are only
+// compiled in when CHESS_BOARD_STATS is defined(cmake -DCHESS_BOARD_STATS=ON),
+// otherwise BOARD_STAT() expands to nothing and the snapshot stays zero
+struct BoardStats
+{
+    enum Counter
+    {
+        MOVE_CHECKS,            // board::findMove() calls(moves the player tried)
+        KING_IN_THREAT,         // board::isKingInThreat() calls
+        LEGAL_MOVES,            // legal moves the board found for the player
+        MARK_MOVES,             // pieces the moves were marked for(highlighting)
+        END_GAME_CHECKS,        // board::isEndGame() calls(mate detection)
+        DRAW_CHECKS,            // board::isDraw() calls(stalemate detection)
+        COUNTER_NB
+    };
+
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    BoardStats();
+
+    static const char* counterName(int counter);
+    // "name value" pairs on one line
+    std::string toString() const;
+
+    uint64_t counters[COUNTER_NB];
+
+#ifdef CHESS_BOARD_STATS
+    static const bool s_enabled = true;
+#else
+    static const bool s_enabled = false;
+#endif
+};
+
+#ifdef CHESS_BOARD_STATS
+
+// the counters of one thread. each thread only adds to its own counters so
+// no increment is a locked instruction, the reader sums all the threads
+class BoardStatsCounters
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    BoardStatsCounters();
+    ~BoardStatsCounters();
+
+    void add(int counter, uint64_t amount)
+    {
+        m_values[counter].store(m_values[counter].load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    static BoardStatsCounters& local()
+    {
+        static thread_local BoardStatsCounters counters;
+        return counters;
+    }
+
+    // the counts of the threads that ended are kept, a reset while other
+    // threads count may lose the increments made at that moment
+    static BoardStats collect();
+    static void       reset  ();
+
+private:
+    BoardStatsCounters(const BoardStatsCounters&);
+    BoardStatsCounters& operator=(const BoardStatsCounters&);
+
+    std::atomic<uint64_t> m_values[BoardStats::COUNTER_NB];
+};
+
+#define BOARD_STAT_ADD(counter, amount) BoardStatsCounters::local().add(BoardStats::counter, amount)
+
+#else
+
+// the amount is not evaluated, only named so it never turns into an unused
+// variable
+#define BOARD_STAT_ADD(counter, amount) ((void)sizeof(amount))
+
+#endif // CHESS_BOARD_STATS
+
+#define BOARD_STAT(counter) BOARD_STAT_ADD(counter, 1)
+
+#endif // _BOARDSTATS_H_
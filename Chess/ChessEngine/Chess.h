@@ -24,6 +24,14 @@ const int boardX = 8;
 const int boardY = 8;
 
 enum PIECES{PAWN,KNIGHT,BISHOP,ROOK,QUEEN,KING};
+enum COLORS{BLACK = -1,WHITE = 1};
+enum SIDES {UPPER, BOTTOM};
+
+// returns the side index(UPPER/BOTTOM) that the given player color plays from
+inline int colorToSide(int playerColor)
+{
+    return (playerColor == WHITE) ? BOTTOM : UPPER;
+}
 
 struct BOARD_POINT  
 {
@@ -0,0 +1,148 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DELEGATE_H_
+#define _DELEGATE_H_
+
+#include <cstddef>
+
+// a call to a member function or a free function taken as an object pointer
+// and a plain function pointer, so it is copied and called without any
+// allocation. the object has to outlive the delegate
+template <typename Signature>
+class Delegate;
+
+template <typename... Args>
+class Delegate<void (Args...)>
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    Delegate() : m_object(nullptr), m_stub(nullptr) {}
+
+    template <class T, void (T::*Method)(Args...)>
+    static Delegate fromMethod(T* object)
+    {
+        return Delegate(object, &methodStub<T, Method>);
+    }
+
+    template <void (*Function)(Args...)>
+    static Delegate fromFunction()
+    {
+        return Delegate(nullptr, &functionStub<Function>);
+    }
+
+    void operator()(Args... args) const
+    {
+        m_stub(m_object, args...);
+    }
+
+    bool isEmpty() const
+    {
+        return m_stub == nullptr;
+    }
+
+    bool operator==(const Delegate& other) const
+    {
+        return m_object == other.m_object && m_stub == other.m_stub;
+    }
+
+private:
+    typedef void (*Stub)(void* object, Args... args);
+
+    Delegate(void* object, Stub stub) : m_object(object), m_stub(stub) {}
+
+    template <class T, void (T::*Method)(Args...)>
+    static void methodStub(void* object, Args... args)
+    {
+        (static_cast<T*>(object)->*Method)(args...);
+    }
+
+    template <void (*Function)(Args...)>
+    static void functionStub(void*, Args... args)
+    {
+        Function(args...);
+    }
+
+    void* m_object;
+    Stub  m_stub;
+};
+
+// the observers of one event, kept in place up to MaxObservers of them.
+// emitting walks the array and does nothing at all when no one listens.
+// not thread safe, the observers are connected before the events start
+template <typename Signature, size_t MaxObservers = 4>
+class DelegateList
+{
+public:
+    typedef Delegate<Signature> DelegateType;
+
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    DelegateList() : m_count(0) {}
+
+    // false when the list is full
+    bool connect(const DelegateType& observer)
+    {
+        if (m_count == MaxObservers || observer.isEmpty())
+            return false;
+
+        m_observers[m_count++] = observer;
+        return true;
+    }
+
+    void disconnect(const DelegateType& observer)
+    {
+        for (size_t i = 0; i < m_count; i++)
+        {
+            if (m_observers[i] == observer)
+            {
+                for (size_t j = i + 1; j < m_count; j++)
+                    m_observers[j - 1] = m_observers[j];
+                m_count--;
+                return;
+            }
+        }
+    }
+
+    void disconnectAll()
+    {
+        m_count = 0;
+    }
+
+    bool isEmpty() const
+    {
+        return m_count == 0;
+    }
+
+    template <typename... Args>
+    void operator()(Args&&... args) const
+    {
+        for (size_t i = 0; i < m_count; i++)
+            m_observers[i](args...);
+    }
+
+private:
+    DelegateType m_observers[MaxObservers];
+    size_t       m_count;
+};
+
+#endif // _DELEGATE_H_
@@ -0,0 +1,99 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "DrawRules.h"
+#include <algorithm>
+
+namespace
+{
+    const Bitboard DarkSquares = 0xAA55AA55AA55AA55ULL;
+}
+
+//-----------------------------------------------------------------------------
+// Name : findDraw ()
+// Desc : the last move may mate on the hundredth ply, the mate stands
+//-----------------------------------------------------------------------------
+DrawType findDraw(const Position& pos, const std::vector<uint64_t>& keys)
+{
+    if (isInsufficientMaterial(pos))
+        return DRAW_INSUFFICIENT_MATERIAL;
+
+    if (isRepetition(pos, keys, 3))
+        return DRAW_REPETITION;
+
+    bool inCheck = pos.inCheck();
+    if (pos.rule50() >= 100 && (!inCheck || pos.hasLegalMove()))
+        return DRAW_FIFTY_MOVES;
+
+    if (!inCheck && !pos.hasLegalMove())
+        return DRAW_STALEMATE;
+
+    return NO_DRAW;
+}
+
+//-----------------------------------------------------------------------------
+// Name : isRepetition ()
+// Desc : the same side is to move every second ply, so the scan starts 4
+//        plies back and steps by 2
+//-----------------------------------------------------------------------------
+bool isRepetition(const Position& pos, const std::vector<uint64_t>& keys, int times)
+{
+    int last = static_cast<int>(keys.size()) - 1;
+    int reach = std::min(pos.rule50(), last);
+    int repetitions = 1;
+
+    for (int i = 4; i <= reach; i += 2)
+        if (keys[last - i] == pos.key() && ++repetitions == times)
+            return true;
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// Name : isInsufficientMaterial ()
+//-----------------------------------------------------------------------------
+bool isInsufficientMaterial(const Position& pos)
+{
+    if (pos.piecesOfType(PAWN) || pos.piecesOfType(ROOK) || pos.piecesOfType(QUEEN))
+        return false;
+
+    Bitboard knights = pos.piecesOfType(KNIGHT);
+    Bitboard bishops = pos.piecesOfType(BISHOP);
+
+    if (popCount(knights | bishops) <= 1)
+        return true;
+
+    return !knights && (!(bishops & DarkSquares) || !(bishops & ~DarkSquares));
+}
+
+//-----------------------------------------------------------------------------
+// Name : drawTypeToString ()
+//-----------------------------------------------------------------------------
+const char* drawTypeToString(DrawType drawType)
+{
+    switch (drawType)
+    {
+    case DRAW_INSUFFICIENT_MATERIAL: return "insufficient material";
+    case DRAW_REPETITION:            return "threefold repetition";
+    case DRAW_FIFTY_MOVES:           return "fifty move rule";
+    case DRAW_STALEMATE:             return "stalemate";
+    default:                         return "";
+    }
+}
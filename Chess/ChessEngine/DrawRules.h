@@ -0,0 +1,50 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DRAWRULES_H_
+#define _DRAWRULES_H_
+
+#include <vector>
+#include "Position.h"
+
+enum DrawType
+{
+    NO_DRAW,
+    DRAW_INSUFFICIENT_MATERIAL,
+    DRAW_REPETITION,
+    DRAW_FIFTY_MOVES,
+    DRAW_STALEMATE
+};
+
+// the draw rules of a game, keys holds the keys of the positions of the
+// game with the current one last. the rules are tried from the cheapest so
+// most positions are cleared without generating a single move
+DrawType    findDraw(const Position& pos, const std::vector<uint64_t>& keys);
+
+// the current position occurred times times. only the positions since the
+// last capture or pawn move can repeat, so at most rule50 keys are read
+bool        isRepetition(const Position& pos, const std::vector<uint64_t>& keys, int times);
+// no sequence of legal moves can mate : bare kings, a single minor piece or
+// bishops that all stand on squares of one color
+bool        isInsufficientMaterial(const Position& pos);
+
+// "threefold repetition", "stalemate" and so on
+const char* drawTypeToString(DrawType drawType);
+
+#endif // _DRAWRULES_H_
@@ -0,0 +1,393 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "EngineService.h"
+
+namespace
+{
+    //-------------------------------------------------------------------------
+    // keys holds the keys of the game up to and including pos, drawType gets
+    // the rule of a draw or NO_DRAW
+    //-------------------------------------------------------------------------
+    GameStatus gameStatus(const Position& pos, const std::vector<uint64_t>& keys, DrawType& drawType)
+    {
+        drawType = findDraw(pos, keys);
+        if (drawType != NO_DRAW)
+            return (drawType == DRAW_STALEMATE) ? GAME_STALEMATE : GAME_DRAW;
+        if (pos.inCheck() && !pos.hasLegalMove())
+            return GAME_CHECKMATE;
+        return GAME_ONGOING;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : EngineService (constructor)
+//-----------------------------------------------------------------------------
+EngineService::EngineService(size_t hashSizeInMB)
+    : m_tt(hashSizeInMB), m_search(m_tt)
+{
+    m_hasPending = false;
+    m_clearHash = false;
+    m_ponderKey = 0;
+    m_ponderhit = false;
+    m_quit = false;
+    m_requestId = 0;
+    m_thinking = false;
+    m_analysisLines = 0;
+    m_searchId = 0;
+    m_analyzing = false;
+    m_random.seed(std::random_device()());
+    m_search.setInfoCallback([this](const SearchInfo& info) { onSearchInfo(info); });
+}
+
+//-----------------------------------------------------------------------------
+// Name : EngineService (destructor)
+//-----------------------------------------------------------------------------
+EngineService::~EngineService()
+{
+    shutdown();
+}
+
+//-----------------------------------------------------------------------------
+// Name : start ()
+//-----------------------------------------------------------------------------
+void EngineService::start()
+{
+    if (m_thread.joinable())
+        return;
+
+    m_quit = false;
+    m_thread = std::thread(&EngineService::workerLoop, this);
+}
+
+//-----------------------------------------------------------------------------
+// Name : shutdown ()
+//-----------------------------------------------------------------------------
+void EngineService::shutdown()
+{
+    if (!m_thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+        m_hasPending = false;
+        m_timeManager.requestStop();
+    }
+
+    m_condition.notify_one();
+    m_thread.join();
+}
+
+//-----------------------------------------------------------------------------
+// Name : openBook ()
+//-----------------------------------------------------------------------------
+bool EngineService::openBook(const std::string& path)
+{
+    if (m_thread.joinable())
+        return false;
+
+    return m_book.open(path);
+}
+
+//-----------------------------------------------------------------------------
+// Name : postTurn ()
+// Desc : replaces whatever the worker is doing with the given position.
+//        returns the id the results of this position will carry
+//-----------------------------------------------------------------------------
+unsigned EngineService::postTurn(const Position& pos, const std::vector<uint64_t>& gameHistory,
+                                 bool searchMove, const SearchLimits& limits, Move ponderMove)
+{
+    // only ponder a reply that leaves the game going, a ponderhit goes
+    // straight on to the search and the position it reaches is never
+    // checked for a mate or a draw
+    Position ponderPos = pos;
+    bool ponder = false;
+    if (!searchMove && ponderMove != MOVE_NONE && pos.isPseudoLegal(ponderMove) && pos.isLegal(ponderMove))
+    {
+        UndoInfo undo;
+        ponderPos.doMove(ponderMove, undo);
+
+        std::vector<uint64_t> ponderKeys = gameHistory;
+        ponderKeys.push_back(pos.key());
+        ponderKeys.push_back(ponderPos.key());
+        // the reply to a book position comes from the book, nothing to ponder
+        DrawType drawType;
+        ponder = gameStatus(ponderPos, ponderKeys, drawType) == GAME_ONGOING && m_book.probe(ponderPos).empty();
+    }
+
+    unsigned id;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        id = ++m_requestId;
+
+        // stopped under the lock so the stop can only reach the old search,
+        // the worker picks up the new request after we let go of the lock
+        m_timeManager.requestStop();
+
+        m_pending.id = id;
+        m_pending.pos = pos;
+        m_pending.gameHistory = gameHistory;
+        m_pending.searchMove = searchMove;
+        m_pending.ponder = ponder;
+        m_pending.ponderPos = ponderPos;
+        m_pending.limits = limits;
+        m_hasPending = true;
+
+        m_ponderKey = ponder ? ponderPos.key() : 0;
+        m_ponderhit = false;
+    }
+
+    m_condition.notify_one();
+    return id;
+}
+
+//-----------------------------------------------------------------------------
+// Name : ponderhit ()
+// Desc : called when pos was reached on the board. returns true if it is the
+//        position being pondered, the ponder search then becomes the real
+//        search of the move and its result comes under the same request id.
+//        only positions where the game goes on are pondered, any other
+//        position returns false and must be posted to get its status
+//-----------------------------------------------------------------------------
+bool EngineService::ponderhit(const Position& pos)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_ponderKey == 0 || m_ponderKey != pos.key())
+        return false;
+
+    m_ponderKey = 0;
+    m_ponderhit = true;
+    m_timeManager.ponderhit();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : cancel ()
+// Desc : stops the current work, anything it already posted is dropped
+//-----------------------------------------------------------------------------
+void EngineService::cancel()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_requestId;
+    m_hasPending = false;
+    m_ponderKey = 0;
+    m_timeManager.requestStop();
+}
+
+//-----------------------------------------------------------------------------
+// Name : newGame ()
+//-----------------------------------------------------------------------------
+void EngineService::newGame()
+{
+    cancel();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_clearHash = true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : pollResult ()
+// Desc : returns the next result of the latest posted position, must only
+//        be called from the thread that posts the requests
+//-----------------------------------------------------------------------------
+bool EngineService::pollResult(EngineResult& result)
+{
+    while (m_results.pop(result))
+    {
+        if (result.requestId == m_requestId.load())
+            return true;
+    }
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// Name : setAnalysisLines ()
+// Desc : takes effect from the next posted position
+//-----------------------------------------------------------------------------
+void EngineService::setAnalysisLines(int lines)
+{
+    m_analysisLines = std::max(0, lines);
+}
+
+//-----------------------------------------------------------------------------
+// Name : isThinking ()
+//-----------------------------------------------------------------------------
+bool EngineService::isThinking() const
+{
+    return m_thinking;
+}
+
+//-----------------------------------------------------------------------------
+// Name : workerLoop ()
+//-----------------------------------------------------------------------------
+void EngineService::workerLoop()
+{
+    for (;;)
+    {
+        Request request;
+        bool clearHash;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]{ return m_hasPending || m_quit; });
+
+            if (m_quit)
+                return;
+
+            request = std::move(m_pending);
+            m_hasPending = false;
+            clearHash = m_clearHash;
+            m_clearHash = false;
+        }
+
+        if (clearHash)
+        {
+            m_tt.clear();
+            m_search.clearHistory();
+        }
+
+        processRequest(request);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : processRequest ()
+//-----------------------------------------------------------------------------
+void EngineService::processRequest(const Request& request)
+{
+    EngineResult result;
+    result.type = EngineResult::TURN_STATUS;
+    result.requestId = request.id;
+    result.move = MOVE_NONE;
+    result.ponderMove = MOVE_NONE;
+    result.score = 0;
+    result.depth = 0;
+    result.multiPV = 1;
+
+    std::vector<uint64_t> keys = request.gameHistory;
+    keys.push_back(request.pos.key());
+
+    result.status = gameStatus(request.pos, keys, result.drawType);
+    postResult(result);
+
+    int analysisLines = m_analysisLines;
+    bool analyze = !request.searchMove && !request.ponder && analysisLines > 0;
+    if (result.status != GAME_ONGOING || (!request.searchMove && !request.ponder && !analyze))
+        return;
+
+    if (request.searchMove)
+    {
+        Move bookMove = m_book.pickMove(request.pos, m_random());
+        if (bookMove != MOVE_NONE)
+        {
+            result.type = EngineResult::BEST_MOVE;
+            result.move = bookMove;
+            postResult(result);
+            return;
+        }
+    }
+
+    const Position& root = request.ponder ? request.ponderPos : request.pos;
+    std::vector<uint64_t> gameHistory = request.gameHistory;
+    if (request.ponder)
+        gameHistory.push_back(request.pos.key());
+
+    // the analysis goes on until the player moves
+    SearchLimits limits = request.limits;
+    if (analyze)
+    {
+        limits = SearchLimits();
+        limits.infinite = true;
+    }
+
+    m_thinking = true;
+    m_searchId = request.id;
+    m_analyzing = analyze;
+    m_search.setMultiPV(analyze ? analysisLines : 1);
+    m_tt.newSearch();
+    {
+        // started under the lock so a ponderhit() can't slip in between
+        // checking for it and starting the clock
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        limits.ponder = request.ponder && !m_ponderhit;
+        m_timeManager.start(limits, root.sideToMove());
+
+        // a request posted while we were getting here already asked for a
+        // stop that start() has just cleared
+        if (request.id != m_requestId.load())
+            m_timeManager.requestStop();
+    }
+
+    SearchResult searchResult = m_search.think(root, gameHistory, limits, m_timeManager);
+    m_thinking = false;
+    m_analyzing = false;
+
+    if (analyze)
+        return;
+
+    result.type = EngineResult::BEST_MOVE;
+    result.move = searchResult.bestMove;
+    result.ponderMove = searchResult.ponderMove;
+    result.score = searchResult.score;
+    result.depth = searchResult.depth;
+    postResult(result);
+}
+
+//-----------------------------------------------------------------------------
+// Name : onSearchInfo ()
+// Desc : called by the search on the worker thread, a line is not worth
+//        stalling the search for so it is dropped when the queue is full
+//-----------------------------------------------------------------------------
+void EngineService::onSearchInfo(const SearchInfo& info)
+{
+    if (!m_analyzing || info.pv.empty())
+        return;
+
+    EngineResult result;
+    result.type = EngineResult::ANALYSIS_LINE;
+    result.requestId = m_searchId;
+    result.status = GAME_ONGOING;
+    result.drawType = NO_DRAW;
+    result.move = info.pv[0];
+    result.ponderMove = (info.pv.size() > 1) ? info.pv[1] : MOVE_NONE;
+    result.score = info.score;
+    result.depth = info.depth;
+    result.multiPV = info.multiPV;
+    m_results.push(result);
+}
+
+//-----------------------------------------------------------------------------
+// Name : postResult ()
+//-----------------------------------------------------------------------------
+void EngineService::postResult(const EngineResult& result)
+{
+    // the main thread drains the queue every frame so it is only full when
+    // the game is not drawing, wait for room unless we are shutting down
+    while (!m_results.push(result))
+    {
+        if (m_quit || result.requestId != m_requestId.load())
+            return;
+
+        std::this_thread::yield();
+    }
+}
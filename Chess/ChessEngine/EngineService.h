@@ -0,0 +1,143 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ENGINESERVICE_H_
+#define _ENGINESERVICE_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <random>
+#include "Search.h"
+#include "OpeningBook.h"
+#include "LockFreeQueue.h"
+#include "DrawRules.h"
+
+// GAME_DRAW is a draw by repetition, the fifty move rule or insufficient material
+enum GameStatus{GAME_ONGOING, GAME_CHECKMATE, GAME_STALEMATE, GAME_DRAW};
+
+// a message sent by the engine thread back to the main thread
+struct EngineResult
+{
+    enum Type{TURN_STATUS, BEST_MOVE, ANALYSIS_LINE};
+
+    Type     type;
+    unsigned requestId;
+    int      status;        // TURN_STATUS : the GameStatus of the posted position
+    DrawType drawType;      // TURN_STATUS : the rule of a GAME_DRAW or GAME_STALEMATE
+    Move     move;          // BEST_MOVE : the move to play, ANALYSIS_LINE : the first move of the line
+    Move     ponderMove;
+    int      score;
+    int      depth;
+    int      multiPV;       // ANALYSIS_LINE : the rank of the line, 1 is the best
+};
+
+// runs the engine work of a turn on a background thread.
+// the main thread posts the position after every move and then keeps
+// drawing, the worker decides if the game has ended and searches a move when
+// asked to. results come back through a lock free queue that the main thread
+// drains once per frame, results of a position that was replaced by a newer
+// one are dropped on the way out
+class EngineService
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    explicit EngineService(size_t hashSizeInMB = 32);
+    ~EngineService();
+
+    EngineService(const EngineService&) = delete;
+    EngineService& operator=(const EngineService&) = delete;
+
+    void start   ();
+    void shutdown();
+
+    // the book is read by both threads, it must be opened before start()
+    bool openBook(const std::string& path);
+
+    //-------------------------------------------------------------------------
+    // Functions called by the main thread
+    //-------------------------------------------------------------------------
+    // gameHistory holds the keys of the positions played before pos, oldest first.
+    // when it is not the engine turn and ponderMove is the expected reply the
+    // worker searches the position after it until ponderhit() or a new post.
+    // a ponderhit posts no TURN_STATUS, the reply is only pondered when the
+    // game goes on after it
+    unsigned postTurn  (const Position& pos, const std::vector<uint64_t>& gameHistory,
+                        bool searchMove, const SearchLimits& limits, Move ponderMove = MOVE_NONE);
+    bool     ponderhit (const Position& pos);
+    void     cancel    ();
+    void     newGame   ();
+    bool     pollResult(EngineResult& result);
+    // when not zero a position posted for the player is analyzed until the
+    // next post instead of pondering, the best lines of every depth come back
+    // as ANALYSIS_LINE results
+    void     setAnalysisLines(int lines);
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    bool isThinking() const;
+
+private:
+    struct Request
+    {
+        unsigned              id;
+        Position              pos;
+        std::vector<uint64_t> gameHistory;
+        bool                  searchMove;
+        bool                  ponder;
+        Position              ponderPos;
+        SearchLimits          limits;
+    };
+
+    void workerLoop    ();
+    void processRequest(const Request& request);
+    void postResult    (const EngineResult& result);
+    void onSearchInfo  (const SearchInfo& info);
+
+    std::thread             m_thread;
+    std::mutex              m_mutex;
+    std::condition_variable m_condition;
+    Request                 m_pending;
+    bool                    m_hasPending;
+    bool                    m_clearHash;
+    uint64_t                m_ponderKey;    // key of the position being pondered, 0 when not pondering
+    bool                    m_ponderhit;
+    std::atomic<bool>       m_quit;
+
+    std::atomic<unsigned>   m_requestId;
+    std::atomic<bool>       m_thinking;
+    std::atomic<int>        m_analysisLines;
+    unsigned                m_searchId;     // the request being searched, worker thread only
+    bool                    m_analyzing;
+
+    TranspositionTable      m_tt;
+    Search                  m_search;
+    TimeManager             m_timeManager;
+    OpeningBook             m_book;
+    std::mt19937            m_random;
+
+    LockFreeQueue<EngineResult, 64> m_results;
+};
+
+#endif // _ENGINESERVICE_H_
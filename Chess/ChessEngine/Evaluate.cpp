@@ -0,0 +1,234 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Evaluate.h"
+
+namespace
+{
+    const int PieceValueMg[KING + 1] = {100, 320, 330, 500, 950, 0};
+    const int PieceValueEg[KING + 1] = {120, 300, 310, 540, 1000, 0};
+
+    // game phase weight of each piece, 24 is a full board
+    const int PhaseWeight[KING + 1] = {0, 1, 1, 2, 4, 0};
+    const int MaxPhase = 24;
+
+    const int BishopPairMg = 30, BishopPairEg = 50;
+    const int RookOpenFileMg = 25, RookOpenFileEg = 10;
+    const int RookSemiOpenFileMg = 12, RookSemiOpenFileEg = 6;
+    const int Tempo = 10;
+
+    // piece square tables from the bottom(white) side point of view, listed
+    // in the board square order so the first line is the 8th rank.
+    // upper(black) pieces use the vertically mirrored square
+    const int PawnTable[SQUARE_NB] =
+    {
+         0,  0,  0,  0,  0,  0,  0,  0,
+        50, 50, 50, 50, 50, 50, 50, 50,
+        10, 10, 20, 30, 30, 20, 10, 10,
+         5,  5, 10, 25, 25, 10,  5,  5,
+         0,  0,  0, 20, 20,  0,  0,  0,
+         5, -5,-10,  0,  0,-10, -5,  5,
+         5, 10, 10,-20,-20, 10, 10,  5,
+         0,  0,  0,  0,  0,  0,  0,  0
+    };
+
+    const int KnightTable[SQUARE_NB] =
+    {
+        -50,-40,-30,-30,-30,-30,-40,-50,
+        -40,-20,  0,  0,  0,  0,-20,-40,
+        -30,  0, 10, 15, 15, 10,  0,-30,
+        -30,  5, 15, 20, 20, 15,  5,-30,
+        -30,  0, 15, 20, 20, 15,  0,-30,
+        -30,  5, 10, 15, 15, 10,  5,-30,
+        -40,-20,  0,  5,  5,  0,-20,-40,
+        -50,-40,-30,-30,-30,-30,-40,-50
+    };
+
+    const int BishopTable[SQUARE_NB] =
+    {
+        -20,-10,-10,-10,-10,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5, 10, 10,  5,  0,-10,
+        -10,  5,  5, 10, 10,  5,  5,-10,
+        -10,  0, 10, 10, 10, 10,  0,-10,
+        -10, 10, 10, 10, 10, 10, 10,-10,
+        -10,  5,  0,  0,  0,  0,  5,-10,
+        -20,-10,-10,-10,-10,-10,-10,-20
+    };
+
+    const int RookTable[SQUARE_NB] =
+    {
+         0,  0,  0,  0,  0,  0,  0,  0,
+         5, 10, 10, 10, 10, 10, 10,  5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+        -5,  0,  0,  0,  0,  0,  0, -5,
+         0,  0,  0,  5,  5,  0,  0,  0
+    };
+
+    const int QueenTable[SQUARE_NB] =
+    {
+        -20,-10,-10, -5, -5,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5,  5,  5,  5,  0,-10,
+         -5,  0,  5,  5,  5,  5,  0, -5,
+          0,  0,  5,  5,  5,  5,  0, -5,
+        -10,  5,  5,  5,  5,  5,  0,-10,
+        -10,  0,  5,  0,  0,  0,  0,-10,
+        -20,-10,-10, -5, -5,-10,-10,-20
+    };
+
+    const int KingTableMg[SQUARE_NB] =
+    {
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -20,-30,-30,-40,-40,-30,-30,-20,
+        -10,-20,-20,-20,-20,-20,-20,-10,
+         20, 20,  0,  0,  0,  0, 20, 20,
+         20, 30, 10,  0,  0, 10, 30, 20
+    };
+
+    const int KingTableEg[SQUARE_NB] =
+    {
+        -50,-40,-30,-20,-20,-30,-40,-50,
+        -30,-20,-10,  0,  0,-10,-20,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-30,  0,  0,  0,  0,-30,-30,
+        -50,-30,-30,-30,-30,-30,-30,-50
+    };
+
+    const int* const PieceTablesMg[KING + 1] = {PawnTable, KnightTable, BishopTable, RookTable, QueenTable, KingTableMg};
+    const int* const PieceTablesEg[KING + 1] = {PawnTable, KnightTable, BishopTable, RookTable, QueenTable, KingTableEg};
+}
+
+//-----------------------------------------------------------------------------
+// Name : Evaluator (constructor)
+//-----------------------------------------------------------------------------
+Evaluator::Evaluator(unsigned int pawnHashSizeKB) : m_pawnTable(pawnHashSizeKB)
+{}
+
+//-----------------------------------------------------------------------------
+// Name : evaluate ()
+//-----------------------------------------------------------------------------
+int Evaluator::evaluate(const Position& pos)
+{
+    int mg[2] = {0, 0};
+    int eg[2] = {0, 0};
+    int phase = 0;
+
+    //----------------------------------------------------------------
+    // material and piece placement
+    //----------------------------------------------------------------
+    for (int side = 0; side < 2; side++)
+    {
+        for (int type = PAWN; type <= KING; type++)
+        {
+            Bitboard curPieces = pos.pieces(side, type);
+            while (curPieces)
+            {
+                int square = popLsb(curPieces);
+                int tableSquare = (side == BOTTOM) ? square : square ^ 56;
+
+                mg[side] += PieceValueMg[type] + PieceTablesMg[type][tableSquare];
+                eg[side] += PieceValueEg[type] + PieceTablesEg[type][tableSquare];
+                phase += PhaseWeight[type];
+            }
+        }
+
+        if (popCount(pos.pieces(side, BISHOP)) >= 2)
+        {
+            mg[side] += BishopPairMg;
+            eg[side] += BishopPairEg;
+        }
+    }
+
+    //----------------------------------------------------------------
+    // pawn structure, taken from the pawn hash most of the time
+    //----------------------------------------------------------------
+    Bitboard pawns[2] = {pos.pieces(UPPER, PAWN), pos.pieces(BOTTOM, PAWN)};
+    PawnEntry* pawnEntry = m_pawnTable.probe(pos.pawnKey(), pawns);
+
+    for (int side = 0; side < 2; side++)
+    {
+        mg[side] += pawnEntry->mgScore[side];
+        eg[side] += pawnEntry->egScore[side];
+
+        // the shelter only matters while there are pieces to attack the king
+        if (pos.hasNonPawnMaterial(1 - side))
+            mg[side] += pawnEntry->kingShelter(side, pos.kingSquare(side));
+
+        Bitboard rooks = pos.pieces(side, ROOK);
+        while (rooks)
+        {
+            int file = squareRow(popLsb(rooks));
+            if (!(pawnEntry->semiOpenFiles[side] & (1 << file)))
+                continue;
+
+            if (pawnEntry->semiOpenFiles[1 - side] & (1 << file))
+            {
+                mg[side] += RookOpenFileMg;
+                eg[side] += RookOpenFileEg;
+            }
+            else
+            {
+                mg[side] += RookSemiOpenFileMg;
+                eg[side] += RookSemiOpenFileEg;
+            }
+        }
+    }
+
+    //----------------------------------------------------------------
+    // blend the middle game and end game scores by the game phase
+    //----------------------------------------------------------------
+    if (phase > MaxPhase)
+        phase = MaxPhase;
+
+    int mgScore = mg[BOTTOM] - mg[UPPER];
+    int egScore = eg[BOTTOM] - eg[UPPER];
+    int score = (mgScore * phase + egScore * (MaxPhase - phase)) / MaxPhase;
+
+    return ((pos.sideToMove() == BOTTOM) ? score : -score) + Tempo;
+}
+
+//-----------------------------------------------------------------------------
+// Name : getPawnTable ()
+//-----------------------------------------------------------------------------
+PawnHashTable& Evaluator::getPawnTable()
+{
+    return m_pawnTable;
+}
+
+//-----------------------------------------------------------------------------
+// Name : pieceValue ()
+//-----------------------------------------------------------------------------
+int Evaluator::pieceValue(int pieceType)
+{
+    if (pieceType < PAWN || pieceType > KING)
+        return 0;
+
+    return (pieceType == KING) ? 20000 : PieceValueMg[pieceType];
+}
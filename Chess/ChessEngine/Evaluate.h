@@ -0,0 +1,56 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _EVALUATE_H_
+#define _EVALUATE_H_
+
+#include "Position.h"
+#include "PawnHash.h"
+
+const int VALUE_ZERO     = 0;
+const int VALUE_DRAW     = 0;
+const int VALUE_MATE     = 32000;
+const int VALUE_INFINITE = 32001;
+const int VALUE_NONE     = 32002;
+// scores above this are mate scores
+const int VALUE_MATE_IN_MAX_PLY = VALUE_MATE - MAX_PLY;
+
+// static evaluation of positions.
+// holds its own pawn hash table so every searching thread needs its own
+// evaluator
+class Evaluator
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    explicit Evaluator(unsigned int pawnHashSizeKB = 512);
+
+    // returns the score in centipawns from the side to move point of view
+    int evaluate(const Position& pos);
+
+    PawnHashTable& getPawnTable();
+
+    static int pieceValue(int pieceType);
+
+private:
+    PawnHashTable m_pawnTable;
+};
+
+#endif // _EVALUATE_H_
@@ -0,0 +1,611 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "GameDatabase.h"
+#include "Serialization.h"
+#include <cstring>
+#include <cstdlib>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // every file starts with 16 bytes : magic(4) format version(2) reserved(10)
+    const char     DataMagic[4]    = {'C', 'G', 'D', 'D'};
+    const char     IndexMagic[4]   = {'C', 'G', 'D', 'I'};
+    const char     PlayersMagic[4] = {'C', 'G', 'D', 'P'};
+    const uint16_t FormatVersion   = 1;
+    const int      HeaderSize      = 16;
+
+    // index entry flags
+    const uint8_t  CustomStart     = 1;     // the game starts with a packed position
+
+    const uint32_t MaxPlies        = 0xFFFF;
+    const size_t   MaxNameLength   = 0xFFFF;
+
+    //-------------------------------------------------------------------------
+    // the standard start position and its packed form, most games start there
+    // and store no position at all
+    //-------------------------------------------------------------------------
+    const Position& standardStart()
+    {
+        static const Position start = []()
+        {
+            Position pos;
+            pos.setStartPosition();
+            return pos;
+        }();
+        return start;
+    }
+
+    struct PackedStart
+    {
+        PackedStart() { standardStart().pack(data); }
+        uint8_t data[PACKED_POSITION_SIZE];
+    };
+
+    const uint8_t* packedStandardStart()
+    {
+        static const PackedStart packed;
+        return packed.data;
+    }
+
+    void writeEntry(uint8_t* data, const GameIndexEntry& entry)
+    {
+        writeLE64(data, entry.offset);
+        writeLE32(data + 8, entry.length);
+        writeLE32(data + 12, entry.checksum);
+        writeLE32(data + 16, entry.whitePlayer);
+        writeLE32(data + 20, entry.blackPlayer);
+        writeLE32(data + 24, entry.date);
+        writeLE16(data + 28, entry.plyCount);
+        data[30] = entry.result;
+        data[31] = entry.flags;
+    }
+
+    void readEntry(const uint8_t* data, GameIndexEntry& entry)
+    {
+        entry.offset      = readLE64(data);
+        entry.length      = readLE32(data + 8);
+        entry.checksum    = readLE32(data + 12);
+        entry.whitePlayer = readLE32(data + 16);
+        entry.blackPlayer = readLE32(data + 20);
+        entry.date        = readLE32(data + 24);
+        entry.plyCount    = readLE16(data + 28);
+        entry.result      = data[30];
+        entry.flags       = data[31];
+    }
+
+    // creates the file with only its header when it does not exist yet
+    bool createFile(const std::string& path, const char* magic)
+    {
+        if (std::ifstream(path.c_str(), std::ios::binary).good())
+            return true;
+
+        uint8_t header[HeaderSize] = {};
+        std::memcpy(header, magic, 4);
+        writeLE16(header + 4, FormatVersion);
+
+        std::ofstream file(path.c_str(), std::ios::binary);
+        file.write(reinterpret_cast<const char*>(header), HeaderSize);
+        return file.good();
+    }
+
+    bool readFile(const std::string& path, const char* magic, std::vector<uint8_t>& content)
+    {
+        std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+        if (!file.good())
+            return false;
+
+        content.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(content.data()), content.size());
+
+        return file.good() && content.size() >= HeaderSize &&
+               std::memcmp(content.data(), magic, 4) == 0 && readLE16(&content[4]) == FormatVersion;
+    }
+
+    // cuts off the tail an interrupted append left behind
+    bool truncateFile(const std::string& path, uint64_t size)
+    {
+#ifdef _WIN32
+        int file = _open(path.c_str(), _O_RDWR | _O_BINARY);
+        if (file < 0)
+            return false;
+        bool truncated = _chsize_s(file, size) == 0;
+        _close(file);
+        return truncated;
+#else
+        return truncate(path.c_str(), static_cast<off_t>(size)) == 0;
+#endif
+    }
+
+    bool isNumber(const std::string& text)
+    {
+        if (text.empty())
+            return false;
+
+        for (char c : text)
+            if (c < '0' || c > '9')
+                return false;
+
+        return true;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : GameDatabase (constructor)
+//-----------------------------------------------------------------------------
+GameDatabase::GameDatabase()
+{
+    m_open = false;
+    m_dataSize = 0;
+    m_players.assign(1, "?");
+}
+
+//-----------------------------------------------------------------------------
+// Name : GameDatabase (destructor)
+//-----------------------------------------------------------------------------
+GameDatabase::~GameDatabase()
+{
+    close();
+}
+
+//-----------------------------------------------------------------------------
+// Name : open ()
+//-----------------------------------------------------------------------------
+bool GameDatabase::open(const std::string& path)
+{
+    close();
+    m_path = path;
+
+    if (!createFile(m_path + ".cgd", DataMagic) || !createFile(m_path + ".cgi", IndexMagic) ||
+        !createFile(m_path + ".cgp", PlayersMagic))
+        return false;
+
+    if (!loadPlayers() || !loadIndex())
+    {
+        close();
+        return false;
+    }
+
+    m_dataOut.open((m_path + ".cgd").c_str(), std::ios::binary | std::ios::app);
+    m_indexOut.open((m_path + ".cgi").c_str(), std::ios::binary | std::ios::app);
+    m_playersOut.open((m_path + ".cgp").c_str(), std::ios::binary | std::ios::app);
+    if (!m_dataOut.good() || !m_indexOut.good() || !m_playersOut.good())
+    {
+        close();
+        return false;
+    }
+
+    m_open = true;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : close ()
+//-----------------------------------------------------------------------------
+void GameDatabase::close()
+{
+    if (m_open)
+        sync();
+
+    m_dataOut.close();
+    m_indexOut.close();
+    m_playersOut.close();
+    m_data.close();
+
+    m_index.clear();
+    m_players.assign(1, "?");
+    m_playerIds.clear();
+    m_dataSize = 0;
+    m_open = false;
+}
+
+//-----------------------------------------------------------------------------
+// Name : sync ()
+// Desc : the players and the games are synced before the index, so once the
+//        index is on the disk everything it points at is too. the streams
+//        may still flush on their own between syncs, loadIndex checks each
+//        entry against its game for that case
+//-----------------------------------------------------------------------------
+bool GameDatabase::sync()
+{
+    if (!m_open)
+        return false;
+
+    m_playersOut.flush();
+    m_dataOut.flush();
+    if (!m_playersOut.good() || !m_dataOut.good() ||
+        !syncFile(m_path + ".cgp") || !syncFile(m_path + ".cgd"))
+        return false;
+
+    m_indexOut.flush();
+    return m_indexOut.good() && syncFile(m_path + ".cgi");
+}
+
+//-----------------------------------------------------------------------------
+// Name : loadPlayers ()
+// Desc : names are stored as length(2) followed by the characters
+//-----------------------------------------------------------------------------
+bool GameDatabase::loadPlayers()
+{
+    std::vector<uint8_t> content;
+    if (!readFile(m_path + ".cgp", PlayersMagic, content))
+        return false;
+
+    m_players.assign(1, "?");
+    m_playerIds.clear();
+
+    size_t pos = HeaderSize;
+    while (pos + 2 <= content.size())
+    {
+        size_t length = readLE16(&content[pos]);
+        if (pos + 2 + length > content.size())
+            break;
+
+        std::string name(reinterpret_cast<const char*>(&content[pos + 2]), length);
+        m_playerIds[name] = static_cast<uint32_t>(m_players.size());
+        m_players.push_back(name);
+        pos += 2 + length;
+    }
+
+    if (pos != content.size() && !truncateFile(m_path + ".cgp", pos))
+        return false;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : loadIndex ()
+// Desc : entries whose game is not entirely in the data file, or does not match
+//        its checksum, are dropped and both files are cut back to the last
+//        good game
+//-----------------------------------------------------------------------------
+bool GameDatabase::loadIndex()
+{
+    std::vector<uint8_t> content;
+    if (!readFile(m_path + ".cgi", IndexMagic, content))
+        return false;
+
+    if (!m_data.open(m_path + ".cgd") || m_data.size() < HeaderSize ||
+        std::memcmp(m_data.data(), DataMagic, 4) != 0 || readLE16(m_data.data() + 4) != FormatVersion)
+        return false;
+
+    uint64_t dataSize = m_data.size();
+    uint64_t dataEnd = HeaderSize;
+    size_t entryCount = (content.size() - HeaderSize) / s_entrySize;
+    m_index.clear();
+    m_index.reserve(entryCount);
+
+    for (size_t i = 0; i < entryCount; i++)
+    {
+        GameIndexEntry entry;
+        readEntry(&content[HeaderSize + i * s_entrySize], entry);
+        if (entry.offset != dataEnd || entry.offset + entry.length > dataSize)
+            break;
+
+        // the entry may have reached the disk ahead of its game
+        if (crc32(m_data.data() + entry.offset, entry.length) != entry.checksum)
+            break;
+
+        m_index.push_back(entry);
+        dataEnd = entry.offset + entry.length;
+    }
+
+    uint64_t indexSize = HeaderSize + static_cast<uint64_t>(m_index.size()) * s_entrySize;
+    if (indexSize != content.size() && !truncateFile(m_path + ".cgi", indexSize))
+        return false;
+
+    if (dataEnd != dataSize)
+    {
+        m_data.close();
+        if (!truncateFile(m_path + ".cgd", dataEnd) || !m_data.open(m_path + ".cgd"))
+            return false;
+    }
+
+    m_dataSize = dataEnd;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : addGame ()
+//-----------------------------------------------------------------------------
+uint32_t GameDatabase::addGame(const StoredGame& game)
+{
+    if (!m_open || game.moves.size() > MaxPlies || m_index.size() >= s_invalidId)
+        return s_invalidId;
+
+    uint8_t packedStart[PACKED_POSITION_SIZE];
+    game.start.pack(packedStart);
+    bool customStart = std::memcmp(packedStart, packedStandardStart(), PACKED_POSITION_SIZE) != 0;
+
+    std::vector<uint8_t> record;
+    record.reserve(PACKED_POSITION_SIZE + game.moves.size() * 2);
+    if (customStart)
+        record.insert(record.end(), packedStart, packedStart + PACKED_POSITION_SIZE);
+
+    record.resize(record.size() + game.moves.size() * 2);
+    uint8_t* moveData = record.data() + (customStart ? PACKED_POSITION_SIZE : 0);
+    for (size_t i = 0; i < game.moves.size(); i++)
+        writeLE16(moveData + i * 2, game.moves[i]);
+
+    GameIndexEntry entry;
+    entry.offset      = m_dataSize;
+    entry.length      = static_cast<uint32_t>(record.size());
+    entry.checksum    = crc32(record.data(), record.size());
+    entry.whitePlayer = (game.whitePlayer < m_players.size()) ? game.whitePlayer : s_unknownPlayer;
+    entry.blackPlayer = (game.blackPlayer < m_players.size()) ? game.blackPlayer : s_unknownPlayer;
+    entry.date        = game.date;
+    entry.plyCount    = static_cast<uint16_t>(game.moves.size());
+    entry.result      = static_cast<uint8_t>(game.result);
+    entry.flags       = customStart ? CustomStart : 0;
+
+    uint8_t entryData[s_entrySize];
+    writeEntry(entryData, entry);
+
+    m_dataOut.write(reinterpret_cast<const char*>(record.data()), record.size());
+    m_indexOut.write(reinterpret_cast<const char*>(entryData), s_entrySize);
+    if (!m_dataOut.good() || !m_indexOut.good())
+        return s_invalidId;
+
+    m_index.push_back(entry);
+    m_dataSize += record.size();
+    return static_cast<uint32_t>(m_index.size() - 1);
+}
+
+//-----------------------------------------------------------------------------
+// Name : addPlayer ()
+//-----------------------------------------------------------------------------
+uint32_t GameDatabase::addPlayer(const std::string& name)
+{
+    if (name.empty() || name == "?")
+        return s_unknownPlayer;
+
+    uint32_t id = findPlayer(name);
+    if (id != s_invalidId)
+        return id;
+
+    if (!m_open || name.size() > MaxNameLength)
+        return s_unknownPlayer;
+
+    uint8_t length[2];
+    writeLE16(length, static_cast<uint16_t>(name.size()));
+    m_playersOut.write(reinterpret_cast<const char*>(length), 2);
+    m_playersOut.write(name.data(), name.size());
+    if (!m_playersOut.good())
+        return s_unknownPlayer;
+
+    id = static_cast<uint32_t>(m_players.size());
+    m_players.push_back(name);
+    m_playerIds[name] = id;
+    return id;
+}
+
+//-----------------------------------------------------------------------------
+// Name : refresh ()
+//-----------------------------------------------------------------------------
+bool GameDatabase::refresh()
+{
+    if (!sync())
+        return false;
+
+    if (m_data.size() == m_dataSize)
+        return true;
+
+    return m_data.open(m_path + ".cgd") && m_data.size() >= m_dataSize;
+}
+
+//-----------------------------------------------------------------------------
+// Name : getGame ()
+//-----------------------------------------------------------------------------
+bool GameDatabase::getGame(uint32_t id, StoredGame& game)
+{
+    if (id >= m_index.size())
+        return false;
+
+    const GameIndexEntry& entry = m_index[id];
+    if (entry.offset + entry.length > m_data.size() && !refresh())
+        return false;
+
+    return decodeGame(entry, game);
+}
+
+//-----------------------------------------------------------------------------
+// Name : readGame ()
+//-----------------------------------------------------------------------------
+bool GameDatabase::readGame(uint32_t id, StoredGame& game) const
+{
+    if (id >= m_index.size())
+        return false;
+
+    return decodeGame(m_index[id], game);
+}
+
+//-----------------------------------------------------------------------------
+// Name : scan ()
+// Desc : the games are laid out in id order so the data file is read
+//        front to back, game holds its moves buffer across the whole scan
+//-----------------------------------------------------------------------------
+bool GameDatabase::scan(const GameVisitor& visitor, uint32_t firstId) const
+{
+    StoredGame game;
+    for (size_t id = firstId; id < m_index.size(); id++)
+    {
+        if (!decodeGame(m_index[id], game))
+            return false;
+
+        if (!visitor(static_cast<uint32_t>(id), game))
+            break;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : decodeGame ()
+//-----------------------------------------------------------------------------
+bool GameDatabase::decodeGame(const GameIndexEntry& entry, StoredGame& game) const
+{
+    if (entry.offset + entry.length > m_data.size())
+        return false;
+
+    const uint8_t* data = m_data.data() + entry.offset;
+    if (crc32(data, entry.length) != entry.checksum)
+        return false;
+
+    size_t startSize = (entry.flags & CustomStart) ? PACKED_POSITION_SIZE : 0;
+    if (entry.length != startSize + entry.plyCount * 2u)
+        return false;
+
+    if (startSize)
+    {
+        if (!game.start.unpack(data))
+            return false;
+    }
+    else
+        game.start = standardStart();
+
+    game.whitePlayer = entry.whitePlayer;
+    game.blackPlayer = entry.blackPlayer;
+    game.date        = entry.date;
+    game.result      = static_cast<GameResult>(entry.result);
+
+    game.moves.resize(entry.plyCount);
+    for (size_t i = 0; i < entry.plyCount; i++)
+        game.moves[i] = readLE16(data + startSize + i * 2);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : parseResult ()
+//-----------------------------------------------------------------------------
+GameResult GameDatabase::parseResult(const std::string& result)
+{
+    if (result == "1-0")
+        return RESULT_WHITE_WINS;
+    if (result == "0-1")
+        return RESULT_BLACK_WINS;
+    if (result == "1/2-1/2")
+        return RESULT_DRAW;
+
+    return RESULT_UNKNOWN;
+}
+
+//-----------------------------------------------------------------------------
+// Name : resultString ()
+//-----------------------------------------------------------------------------
+const char* GameDatabase::resultString(GameResult result)
+{
+    switch (result)
+    {
+    case RESULT_WHITE_WINS: return "1-0";
+    case RESULT_BLACK_WINS: return "0-1";
+    case RESULT_DRAW:       return "1/2-1/2";
+    default:                return "*";
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : parseDate ()
+//-----------------------------------------------------------------------------
+uint32_t GameDatabase::parseDate(const std::string& date)
+{
+    const uint32_t scale[3] = {10000, 100, 1};
+    const uint32_t limit[3] = {9999, 12, 31};
+
+    uint32_t value = 0;
+    size_t begin = 0;
+    for (int part = 0; part < 3 && begin <= date.size(); part++)
+    {
+        size_t end = date.find('.', begin);
+        if (end == std::string::npos)
+            end = date.size();
+
+        std::string text = date.substr(begin, end - begin);
+        if (isNumber(text) && text.size() <= 4)
+        {
+            uint32_t number = static_cast<uint32_t>(std::atoi(text.c_str()));
+            if (number <= limit[part])
+                value += number * scale[part];
+        }
+
+        begin = end + 1;
+    }
+
+    return value;
+}
+
+//-----------------------------------------------------------------------------
+// Name : isOpen ()
+//-----------------------------------------------------------------------------
+bool GameDatabase::isOpen() const
+{
+    return m_open;
+}
+
+//-----------------------------------------------------------------------------
+// Name : getGameCount ()
+//-----------------------------------------------------------------------------
+uint32_t GameDatabase::getGameCount() const
+{
+    return static_cast<uint32_t>(m_index.size());
+}
+
+//-----------------------------------------------------------------------------
+// Name : getEntry ()
+//-----------------------------------------------------------------------------
+const GameIndexEntry& GameDatabase::getEntry(uint32_t id) const
+{
+    return m_index[id];
+}
+
+//-----------------------------------------------------------------------------
+// Name : getPlayerCount ()
+//-----------------------------------------------------------------------------
+uint32_t GameDatabase::getPlayerCount() const
+{
+    return static_cast<uint32_t>(m_players.size());
+}
+
+//-----------------------------------------------------------------------------
+// Name : getPlayerName ()
+//-----------------------------------------------------------------------------
+const std::string& GameDatabase::getPlayerName(uint32_t id) const
+{
+    return (id < m_players.size()) ? m_players[id] : m_players[s_unknownPlayer];
+}
+
+//-----------------------------------------------------------------------------
+// Name : findPlayer ()
+//-----------------------------------------------------------------------------
+uint32_t GameDatabase::findPlayer(const std::string& name) const
+{
+    if (name.empty() || name == "?")
+        return s_unknownPlayer;
+
+    std::unordered_map<std::string, uint32_t>::const_iterator it = m_playerIds.find(name);
+    return (it != m_playerIds.end()) ? it->second : s_invalidId;
+}
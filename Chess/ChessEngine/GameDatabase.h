@@ -0,0 +1,156 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _GAMEDATABASE_H_
+#define _GAMEDATABASE_H_
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <functional>
+#include <unordered_map>
+#include <cstdint>
+#include "MappedFile.h"
+#include "Position.h"
+
+enum GameResult
+{
+    RESULT_UNKNOWN    = 0,
+    RESULT_WHITE_WINS = 1,
+    RESULT_BLACK_WINS = 2,
+    RESULT_DRAW       = 3
+};
+
+// a game as the database stores it, the players are ids of its player table
+// and the date is yyyymmdd with 0 for an unknown part
+struct StoredGame
+{
+    uint32_t          whitePlayer;
+    uint32_t          blackPlayer;
+    uint32_t          date;
+    GameResult        result;
+    Position          start;
+    std::vector<Move> moves;
+};
+
+// fixed size record of the index file, one per game in the order they were
+// added so the id of a game is its position in the index
+struct GameIndexEntry
+{
+    uint64_t offset;        // of the game in the data file
+    uint32_t length;        // bytes of the game in the data file
+    uint32_t checksum;      // crc of those bytes
+    uint32_t whitePlayer;
+    uint32_t blackPlayer;
+    uint32_t date;
+    uint16_t plyCount;
+    uint8_t  result;
+    uint8_t  flags;
+};
+
+// append only store of played games for collections of millions of games.
+// three files share the database path :
+//   .cgd  the games, each one its packed start position when it is not the
+//         standard one followed by its moves in the engine 2 bytes encoding
+//   .cgi  a 32 bytes entry per game(offset, length, checksum, players, date,
+//         plies, result), loaded at open so a game is found in O(1) by id
+//   .cgp  the player names, an id is the position of a name in the table
+// the data file is memory mapped for reading, a scan walks it in file order.
+// games are only ever appended, a crash in the middle of an append leaves a
+// tail that is cut off the next time the database is opened
+class GameDatabase
+{
+public:
+    // return false to stop a scan
+    typedef std::function<bool (uint32_t id, const StoredGame& game)> GameVisitor;
+
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    GameDatabase();
+    ~GameDatabase();
+
+    GameDatabase(const GameDatabase&) = delete;
+    GameDatabase& operator=(const GameDatabase&) = delete;
+
+    // opens the database at path(without extension), creating it when missing
+    bool open (const std::string& path);
+    void close();
+    // writes the buffered games and players to the files and syncs them to the disk
+    bool sync ();
+
+    //-------------------------------------------------------------------------
+    // Functions that add to the database
+    //-------------------------------------------------------------------------
+    // returns the id of the new game or s_invalidId
+    uint32_t addGame  (const StoredGame& game);
+    // returns the id of the player, adding the name when it is new
+    uint32_t addPlayer(const std::string& name);
+
+    //-------------------------------------------------------------------------
+    // Functions that read the games
+    //-------------------------------------------------------------------------
+    // maps the games added since the last refresh
+    bool refresh ();
+    bool getGame (uint32_t id, StoredGame& game);
+    // const reads only see the games mapped by open() or refresh() and may
+    // run on several threads at once
+    bool readGame(uint32_t id, StoredGame& game) const;
+    bool scan    (const GameVisitor& visitor, uint32_t firstId = 0) const;
+
+    static GameResult  parseResult (const std::string& result);
+    static const char* resultString(GameResult result);
+    // "2020.05.17" to 20200517, unknown parts("??") are 0
+    static uint32_t    parseDate   (const std::string& date);
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    bool                  isOpen        () const;
+    uint32_t              getGameCount  () const;
+    const GameIndexEntry& getEntry      (uint32_t id) const;
+    uint32_t              getPlayerCount() const;
+    const std::string&    getPlayerName (uint32_t id) const;
+    // s_invalidId when the name is unknown
+    uint32_t              findPlayer    (const std::string& name) const;
+
+    static const uint32_t s_invalidId     = 0xFFFFFFFF;
+    static const uint32_t s_unknownPlayer = 0;      // "?" of pgn games
+    static const int      s_entrySize     = 32;
+
+private:
+    bool loadPlayers();
+    bool loadIndex  ();
+    bool decodeGame (const GameIndexEntry& entry, StoredGame& game) const;
+
+    std::string m_path;
+    bool        m_open;
+
+    std::vector<GameIndexEntry> m_index;
+    std::vector<std::string>    m_players;
+    std::unordered_map<std::string, uint32_t> m_playerIds;
+
+    std::ofstream m_dataOut;
+    std::ofstream m_indexOut;
+    std::ofstream m_playersOut;
+    uint64_t      m_dataSize;       // including the buffered games
+    MappedFile    m_data;
+};
+
+#endif // _GAMEDATABASE_H_
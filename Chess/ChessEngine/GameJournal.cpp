@@ -0,0 +1,177 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "GameJournal.h"
+#include "Serialization.h"
+#include <fstream>
+#include <cstring>
+#include <fcntl.h>
+
+namespace
+{
+    // bytes 0-3   "CJRN"
+    // bytes 4-5   format version
+    // bytes 6-7   reserved
+    // bytes 8-11  id(crc) of the snapshot the moves follow
+    // bytes 12-15 number of moves in that snapshot
+    const char     JournalMagic[4]   = {'C', 'J', 'R', 'N'};
+    const uint16_t JournalVersion    = 1;
+    const int      JournalHeaderSize = 16;
+}
+
+//-----------------------------------------------------------------------------
+// Name : GameJournal (constructor)
+//-----------------------------------------------------------------------------
+GameJournal::GameJournal()
+{
+    m_file = -1;
+    m_moveCount = 0;
+    m_unsynced = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : GameJournal (destructor)
+//-----------------------------------------------------------------------------
+GameJournal::~GameJournal()
+{
+    close();
+}
+
+//-----------------------------------------------------------------------------
+// Name : create ()
+// Desc : the header replaces the old journal in one step so there is
+//        always either the old or the new journal on the disk
+//-----------------------------------------------------------------------------
+bool GameJournal::create(const std::string& path, uint32_t snapshotId, uint32_t snapshotMoves)
+{
+    close();
+
+    uint8_t header[JournalHeaderSize] = {};
+    std::memcpy(header, JournalMagic, 4);
+    writeLE16(header + 4, JournalVersion);
+    writeLE32(header + 8, snapshotId);
+    writeLE32(header + 12, snapshotMoves);
+
+    if (!replaceFile(path, header, JournalHeaderSize))
+        return false;
+
+    m_file = openFile(path.c_str(), O_WRONLY | O_APPEND);
+    m_moveCount = 0;
+    m_unsynced = 0;
+    return m_file >= 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : append ()
+// Desc : the move reaches the os at once, which is enough to survive a crash
+//        of the game, the disk itself is only synced every few moves
+//-----------------------------------------------------------------------------
+bool GameJournal::append(Move move)
+{
+    if (m_file < 0)
+        return false;
+
+    uint8_t record[2];
+    writeLE16(record, move);
+    if (!writeFile(m_file, record, 2))
+        return false;
+
+    m_moveCount++;
+    if (++m_unsynced >= s_syncInterval)
+        sync();
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : sync ()
+//-----------------------------------------------------------------------------
+void GameJournal::sync()
+{
+    if (m_file >= 0 && m_unsynced > 0)
+    {
+        syncFd(m_file);
+        m_unsynced = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : close ()
+//-----------------------------------------------------------------------------
+void GameJournal::close()
+{
+    if (m_file < 0)
+        return;
+
+    sync();
+    closeFile(m_file);
+    m_file = -1;
+    m_moveCount = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : read ()
+//-----------------------------------------------------------------------------
+bool GameJournal::read(const std::string& path, uint32_t& snapshotId, uint32_t& snapshotMoves,
+                       std::vector<Move>& moves)
+{
+    moves.clear();
+
+    std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+    if (!file.good())
+        return false;
+
+    std::streamoff fileSize = file.tellg();
+    if (fileSize < JournalHeaderSize)
+        return false;
+
+    std::vector<uint8_t> data(static_cast<size_t>(fileSize));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(&data[0]), fileSize))
+        return false;
+
+    if (std::memcmp(&data[0], JournalMagic, 4) != 0 || readLE16(&data[4]) != JournalVersion)
+        return false;
+
+    snapshotId = readLE32(&data[8]);
+    snapshotMoves = readLE32(&data[12]);
+
+    // an odd byte at the end is a move the crash cut in half
+    for (size_t offset = JournalHeaderSize; offset + 2 <= data.size(); offset += 2)
+        moves.push_back(readLE16(&data[offset]));
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : isOpen ()
+//-----------------------------------------------------------------------------
+bool GameJournal::isOpen() const
+{
+    return m_file >= 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : getMoveCount ()
+//-----------------------------------------------------------------------------
+uint32_t GameJournal::getMoveCount() const
+{
+    return m_moveCount;
+}
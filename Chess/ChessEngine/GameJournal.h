@@ -0,0 +1,70 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _GAMEJOURNAL_H_
+#define _GAMEJOURNAL_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Move.h"
+
+// append only log of the moves played on top of a saved snapshot.
+// each move costs 2 bytes and one write, the file is flushed to the disk
+// every few moves so a crash loses at most the last unsynced moves.
+// the header names the snapshot the moves follow, a journal left behind by
+// an older snapshot is recognized and ignored
+class GameJournal
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    GameJournal();
+    // syncs the moves written so far
+    ~GameJournal();
+
+    GameJournal(const GameJournal&) = delete;
+    GameJournal& operator=(const GameJournal&) = delete;
+
+    // replaces the journal with an empty one following the given snapshot
+    bool create(const std::string& path, uint32_t snapshotId, uint32_t snapshotMoves);
+    bool append(Move move);
+    void sync  ();
+    void close ();
+
+    // reads the moves of a journal, a torn last move is dropped
+    static bool read(const std::string& path, uint32_t& snapshotId, uint32_t& snapshotMoves,
+                     std::vector<Move>& moves);
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    bool     isOpen      () const;
+    uint32_t getMoveCount() const;
+
+    static const int s_syncInterval = 8;    // moves written between flushes to the disk
+
+private:
+    int      m_file;
+    uint32_t m_moveCount;
+    int      m_unsynced;
+};
+
+#endif // _GAMEJOURNAL_H_
@@ -19,7 +19,6 @@
 //
 
 #include "King.h"
-#include <cmath>
 
 PIECES king::type = KING;
 //-----------------------------------------------------------------------------
@@ -27,12 +26,7 @@ PIECES king::type = KING;
 //-----------------------------------------------------------------------------
 king::king(int playerColor, BOARD_POINT _boardPoistion)
     :piece(playerColor, _boardPoistion)
-{
-    dx[0]=-1;
-    dx[1]=2;
-    dy[0]=dx[0];
-    dy[1]=dx[1];
-}
+{}
 
 //-----------------------------------------------------------------------------
 // Name : King (destructor)
@@ -40,40 +34,6 @@ king::king(int playerColor, BOARD_POINT _boardPoistion)
 king::~king(void)
 {}
 
-//-----------------------------------------------------------------------------
-// Name : validateNewPos (destructor)
-//-----------------------------------------------------------------------------
-bool king::validateNewPos(int dx,int dy, BOARD_POINT startSqaure, BOARD_POINT targetSquare,piece * SBoard[boardY][boardX])
-{
-    piece * targetPiece = SBoard[targetSquare.col][targetSquare.row];
-
-    if(dx == 0 && dy ==0 )
-        return false;
-
-    if (abs(dx)<= 1 && abs(dy) <= 1)
-    {
-        if (targetPiece != NULL)
-        {
-            if(targetPiece->getColor() != this->getColor())
-                return true;
-            else
-                return false;
-        }
-        
-        return true;
-    }
-
-    if ((dx == -2 || dx == 3) && dy == 0 && m_onStartPoint) //check if the player tried to do a castling move
-    {
-        DIR_VEC castlingDir;
-        castlingDir.x = dx / abs(dx);
-        castlingDir.y = 0;
-        return isPieceInWay(startSqaure,targetSquare,castlingDir,SBoard);
-    }
-
-    return false;
-}
-
 //-----------------------------------------------------------------------------
 // Name : getType
 //-----------------------------------------------------------------------------
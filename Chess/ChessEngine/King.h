@@ -27,7 +27,6 @@ class king : public piece
 public:
     king(int playerColor, BOARD_POINT _boardPoistion);
     ~king(void);
-    bool validateNewPos(int dx,int dy, BOARD_POINT startSqaure, BOARD_POINT targetSquare,piece * SBoard[boardY][boardX]);
     int   getType();
 
 private:
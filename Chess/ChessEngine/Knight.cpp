@@ -19,7 +19,6 @@
 //
 
 #include "Knight.h"
-#include <cmath>
 
 PIECES knight::type = KNIGHT;
 //-----------------------------------------------------------------------------
@@ -27,12 +26,7 @@ PIECES knight::type = KNIGHT;
 //-----------------------------------------------------------------------------
 knight::knight(int playerColor, BOARD_POINT _boardPoistion)
     :piece(playerColor, _boardPoistion)
-{
-    dx[0]=-2;
-    dx[1]=3;
-    dy[0]=-2;
-    dy[1]=3;
-}
+{}
 
 //-----------------------------------------------------------------------------
 // Name : knight (destructor)
@@ -40,32 +34,6 @@ knight::knight(int playerColor, BOARD_POINT _boardPoistion)
 knight::~knight(void)
 {}
 
-//-----------------------------------------------------------------------------
-// Name : validateNewPos
-//-----------------------------------------------------------------------------
-bool knight::validateNewPos(int dx,int dy, BOARD_POINT startSqaure, BOARD_POINT targetSquare,piece * SBoard[boardY][boardX])
-{
-    piece * targetPiece = SBoard[targetSquare.col][targetSquare.row];
-
-    if (dx==0 || dy==0)
-        return false;
-
-    if (( std::abs(dx) + std::abs(dy) == 3))
-    {
-        if (targetPiece != NULL)
-        {
-            if(targetPiece->getColor() != this->getColor())
-                return true;
-            else
-                return false;
-        }
-        else
-            return true;
-    }
-    
-    return false;
-}
-
 //-----------------------------------------------------------------------------
 // Name : getType
 //-----------------------------------------------------------------------------
@@ -27,7 +27,6 @@ class knight : public piece
 public:
     knight(int playerColor, BOARD_POINT _boardPoistion);
     ~knight(void);
-    bool validateNewPos(int dx,int dy, BOARD_POINT startSqaure, BOARD_POINT targetSquare,piece * SBoard[boardY][boardX]);
     int   getType();
 
 private:
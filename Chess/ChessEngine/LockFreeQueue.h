@@ -0,0 +1,88 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LOCKFREEQUEUE_H_
+#define _LOCKFREEQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+
+// bounded single producer single consumer queue.
+// one thread may push and one other thread may pop without any locking, the
+// head and tail are kept on separate cache lines so the two threads don't
+// keep stealing the same line from each other.
+// Capacity must be a power of 2, one slot is always left empty
+template <typename T, size_t Capacity>
+class LockFreeQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    LockFreeQueue() : m_head(0), m_tail(0)
+    {}
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    //-------------------------------------------------------------------------
+    // called only by the producer thread, returns false when the queue is full
+    //-------------------------------------------------------------------------
+    bool push(const T& item)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) & (Capacity - 1);
+
+        if (next == m_head.load(std::memory_order_acquire))
+            return false;
+
+        m_items[tail] = item;
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    // called only by the consumer thread, returns false when the queue is empty
+    //-------------------------------------------------------------------------
+    bool pop(T& item)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+
+        item = m_items[head];
+        m_head.store((head + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+    alignas(64) T m_items[Capacity];
+};
+
+#endif // _LOCKFREEQUEUE_H_
@@ -0,0 +1,167 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// Name : MappedFile (constructor)
+//-----------------------------------------------------------------------------
+MappedFile::MappedFile()
+{
+    m_data = nullptr;
+    m_size = 0;
+
+#ifdef _WIN32
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = nullptr;
+#else
+    m_file = -1;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Name : MappedFile (destructor)
+//-----------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+//-----------------------------------------------------------------------------
+// Name : open ()
+//-----------------------------------------------------------------------------
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+#ifdef _WIN32
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        close();
+        return false;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping == nullptr)
+    {
+        close();
+        return false;
+    }
+
+    m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    m_file = ::open(path.c_str(), O_RDONLY);
+    if (m_file == -1)
+        return false;
+
+    struct stat fileStat;
+    if (fstat(m_file, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+        close();
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_SHARED, m_file, 0);
+    if (mapping == MAP_FAILED)
+    {
+        close();
+        return false;
+    }
+
+    m_data = static_cast<const unsigned char*>(mapping);
+    m_size = static_cast<size_t>(fileStat.st_size);
+#endif
+
+    if (m_data == nullptr)
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : close ()
+//-----------------------------------------------------------------------------
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (m_data != nullptr)
+        UnmapViewOfFile(m_data);
+    if (m_mapping != nullptr)
+        CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE)
+        CloseHandle(m_file);
+
+    m_mapping = nullptr;
+    m_file = INVALID_HANDLE_VALUE;
+#else
+    if (m_data != nullptr)
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+    if (m_file != -1)
+        ::close(m_file);
+
+    m_file = -1;
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : isOpen ()
+//-----------------------------------------------------------------------------
+bool MappedFile::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// Name : data ()
+//-----------------------------------------------------------------------------
+const unsigned char* MappedFile::data() const
+{
+    return m_data;
+}
+
+//-----------------------------------------------------------------------------
+// Name : size ()
+//-----------------------------------------------------------------------------
+size_t MappedFile::size() const
+{
+    return m_size;
+}
@@ -0,0 +1,63 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MAPPEDFILE_H_
+#define _MAPPEDFILE_H_
+
+#include <string>
+#include <cstddef>
+
+// a read only view of a whole file mapped into memory.
+// the pages are loaded by the os on first touch and are shared through the
+// page cache with every other process that maps the same file
+class MappedFile
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open (const std::string& path);
+    void close();
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    bool                 isOpen() const;
+    const unsigned char* data  () const;
+    size_t               size  () const;
+
+private:
+    const unsigned char* m_data;
+    size_t m_size;
+
+#ifdef _WIN32
+    void*  m_file;
+    void*  m_mapping;
+#else
+    int    m_file;
+#endif
+};
+
+#endif // _MAPPEDFILE_H_
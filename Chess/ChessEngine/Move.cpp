@@ -0,0 +1,59 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Move.h"
+
+//-----------------------------------------------------------------------------
+// Name : squareToString ()
+//-----------------------------------------------------------------------------
+std::string squareToString(int square)
+{
+    std::string str;
+    str += static_cast<char>('a' + squareRow(square));
+    str += static_cast<char>('8' - squareCol(square));
+    return str;
+}
+
+//-----------------------------------------------------------------------------
+// Name : stringToSquare ()
+//-----------------------------------------------------------------------------
+int stringToSquare(const std::string& str)
+{
+    if (str.size() < 2 || str[0] < 'a' || str[0] > 'h' || str[1] < '1' || str[1] > '8')
+        return NO_SQUARE;
+
+    return makeSquare(str[0] - 'a', '8' - str[1]);
+}
+
+//-----------------------------------------------------------------------------
+// Name : moveToString ()
+// Desc : returns the move in the uci long algebraic notation(e2e4, e7e8q)
+//-----------------------------------------------------------------------------
+std::string moveToString(Move move)
+{
+    if (move == MOVE_NONE)
+        return "0000";
+
+    std::string str = squareToString(moveFrom(move)) + squareToString(moveTo(move));
+    if (moveType(move) == PROMOTION_MOVE)
+        str += "nbrq"[promotionType(move) - KNIGHT];
+
+    return str;
+}
@@ -0,0 +1,104 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MOVE_H_
+#define _MOVE_H_
+
+#include <string>
+#include "Bitboard.h"
+
+// a move packed in 16 bits :
+// bits 0-5   target square
+// bits 6-11  start square
+// bits 12-13 promotion piece type - KNIGHT
+// bits 14-15 move type
+// castling is stored as the king move(e1g1) like the uci protocol does
+typedef uint16_t Move;
+
+enum MoveType
+{
+    NORMAL_MOVE     = 0,
+    PROMOTION_MOVE  = 1 << 14,
+    EN_PASSANT_MOVE = 2 << 14,
+    CASTLING_MOVE   = 3 << 14
+};
+
+const Move MOVE_NONE = 0;
+const Move MOVE_NULL = 65;  // b8b8, like MOVE_NONE(a8a8) a move to its own square is never real
+
+const int MAX_MOVES = 256;
+const int MAX_PLY   = 128;
+
+inline Move makeMove(int from, int to, MoveType type = NORMAL_MOVE)
+{
+    return static_cast<Move>(type | (from << 6) | to);
+}
+
+inline Move makePromotion(int from, int to, int promotionType)
+{
+    return static_cast<Move>(PROMOTION_MOVE | ((promotionType - KNIGHT) << 12) | (from << 6) | to);
+}
+
+inline int moveFrom(Move move)
+{
+    return (move >> 6) & 0x3F;
+}
+
+inline int moveTo(Move move)
+{
+    return move & 0x3F;
+}
+
+inline MoveType moveType(Move move)
+{
+    return static_cast<MoveType>(move & (3 << 14));
+}
+
+inline int promotionType(Move move)
+{
+    return ((move >> 12) & 3) + KNIGHT;
+}
+
+// fixed size list of moves, lives on the stack of the move generator caller
+struct MoveList
+{
+    MoveList() : size(0) {}
+
+    void add(Move move)
+    {
+        moves[size++] = move;
+    }
+
+    bool contains(Move move) const
+    {
+        for (int i = 0; i < size; i++)
+            if (moves[i] == move)
+                return true;
+        return false;
+    }
+
+    Move moves[MAX_MOVES];
+    int  size;
+};
+
+std::string squareToString(int square);
+int         stringToSquare(const std::string& str);
+std::string moveToString(Move move);
+
+#endif // _MOVE_H_
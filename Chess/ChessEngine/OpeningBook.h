@@ -0,0 +1,79 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _OPENINGBOOK_H_
+#define _OPENINGBOOK_H_
+
+#include <vector>
+#include <string>
+#include "MappedFile.h"
+#include "Position.h"
+
+struct BookMove
+{
+    Move move;
+    int  weight;
+};
+
+// opening book in the polyglot .bin layout.
+// the file is a sorted array of 16 bytes big endian entries :
+// key(8) move(2) weight(2) learn(4), a position may have several entries.
+// the file is memory mapped and searched in place so opening it costs
+// nothing and all the games running on a machine share its pages.
+//
+// entries are keyed by polyglotKey() so books made by other programs can be
+// used as they are, OpeningBookBuilder(ChessEngineUCI book) makes them from
+// pgn files and game databases
+class OpeningBook
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    OpeningBook();
+
+    bool open (const std::string& path);
+    void close();
+
+    //-------------------------------------------------------------------------
+    // Functions that look up positions
+    //-------------------------------------------------------------------------
+    std::vector<BookMove> probe   (const Position& pos) const;
+    // random is a uniform 32 bit number, moves are picked by their weight
+    Move                  pickMove(const Position& pos, uint32_t random) const;
+
+    static uint16_t toBookMove (Move move);
+    static uint64_t polyglotKey(const Position& pos);
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    bool   isOpen       () const;
+    size_t getEntryCount() const;
+
+    static const size_t s_entrySize = 16;
+
+private:
+    uint64_t readKey(size_t index) const;
+
+    MappedFile m_file;
+    size_t     m_entryCount;
+};
+
+#endif // _OPENINGBOOK_H_
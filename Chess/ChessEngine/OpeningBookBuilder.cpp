@@ -0,0 +1,121 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "OpeningBookBuilder.h"
+#include "OpeningBook.h"
+#include "Serialization.h"
+#include <algorithm>
+
+namespace
+{
+    const uint16_t MaxWeight = 0xFFFF;
+
+    void writeBigEndian(std::vector<uint8_t>& data, uint64_t value, int bytes)
+    {
+        for (int i = bytes - 1; i >= 0; i--)
+            data.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : OpeningBookBuilder (constructor)
+//-----------------------------------------------------------------------------
+OpeningBookBuilder::OpeningBookBuilder()
+{}
+
+//-----------------------------------------------------------------------------
+// Name : addGame ()
+//-----------------------------------------------------------------------------
+void OpeningBookBuilder::addGame(const Position& start, const std::vector<Move>& moves, GameResult result, int maxPlies)
+{
+    if (result == RESULT_UNKNOWN)
+        return;
+
+    Position pos = start;
+    size_t plies = std::min(moves.size(), static_cast<size_t>(std::max(maxPlies, 0)));
+    for (size_t i = 0; i < plies; i++)
+    {
+        int weight;
+        if (result == RESULT_DRAW)
+            weight = 1;
+        else
+            weight = (result == RESULT_WHITE_WINS) == (pos.sideToMove() == BOTTOM) ? 2 : 0;
+
+        if (weight > 0)
+        {
+            MoveStats& stats = m_moves[std::make_pair(OpeningBook::polyglotKey(pos), OpeningBook::toBookMove(moves[i]))];
+            stats.games++;
+            stats.weight += weight;
+        }
+
+        UndoInfo undo;
+        pos.doMove(moves[i], undo);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : write ()
+// Desc : the weights of a position are scaled down together when the best
+//        of them does not fit in the 2 bytes of an entry
+//-----------------------------------------------------------------------------
+bool OpeningBookBuilder::write(const std::string& path, int minGames) const
+{
+    std::vector<uint8_t> data;
+
+    auto first = m_moves.begin();
+    while (first != m_moves.end())
+    {
+        auto last = first;
+        uint64_t maxWeight = 0;
+        while (last != m_moves.end() && last->first.first == first->first.first)
+        {
+            if (last->second.games >= static_cast<uint32_t>(minGames))
+                maxWeight = std::max(maxWeight, last->second.weight);
+            ++last;
+        }
+
+        for (auto it = first; it != last; ++it)
+        {
+            if (it->second.games < static_cast<uint32_t>(minGames))
+                continue;
+
+            uint64_t weight = it->second.weight;
+            if (maxWeight > MaxWeight)
+                weight = std::max<uint64_t>(1, weight * MaxWeight / maxWeight);
+
+            writeBigEndian(data, it->first.first, 8);
+            writeBigEndian(data, it->first.second, 2);
+            writeBigEndian(data, weight, 2);
+            writeBigEndian(data, 0, 4);     // learn
+        }
+
+        first = last;
+    }
+
+    return replaceFile(path, data.data(), data.size());
+}
+
+//-----------------------------------------------------------------------------
+// Name : getMoveCount ()
+//-----------------------------------------------------------------------------
+size_t OpeningBookBuilder::getMoveCount() const
+{
+    return m_moves.size();
+}
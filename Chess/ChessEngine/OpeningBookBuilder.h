@@ -0,0 +1,63 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _OPENINGBOOKBUILDER_H_
+#define _OPENINGBOOKBUILDER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Position.h"
+#include "GameDatabase.h"
+
+// collects the opening moves of played games and writes them as an
+// OpeningBook file. a move weighs 2 for every game its side won and 1 for
+// every draw, the moves of the losing side and of games without a result
+// are left out
+class OpeningBookBuilder
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    OpeningBookBuilder();
+
+    // only the first maxPlies moves of the game are added
+    void addGame(const Position& start, const std::vector<Move>& moves, GameResult result, int maxPlies);
+    // moves played in less than minGames games are left out, the file is
+    // replaced as a whole so a running game never sees half a book
+    bool write  (const std::string& path, int minGames) const;
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    size_t getMoveCount() const;
+
+private:
+    struct MoveStats
+    {
+        uint32_t games;
+        uint64_t weight;
+    };
+
+    // ordered by key and then move, the order the book is searched in
+    std::map<std::pair<uint64_t, uint16_t>, MoveStats> m_moves;
+};
+
+#endif // _OPENINGBOOKBUILDER_H_
@@ -0,0 +1,150 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ParallelSearch.h"
+#include <thread>
+
+//-----------------------------------------------------------------------------
+// Name : ParallelSearch (constructor)
+//-----------------------------------------------------------------------------
+ParallelSearch::ParallelSearch(TranspositionTable& tt, int threadCount) : m_tt(tt)
+{
+    m_copyMake = false;
+    m_features = SEARCH_ALL_FEATURES;
+    setThreadCount(threadCount);
+}
+
+//-----------------------------------------------------------------------------
+// Name : think ()
+//-----------------------------------------------------------------------------
+SearchResult ParallelSearch::think(const Position& root, const std::vector<uint64_t>& gameHistory,
+                                   const SearchLimits& limits, TimeManager& timeManager)
+{
+    // the helpers search without a clock until the main search is done
+    SearchLimits helperLimits;
+    helperLimits.depth = limits.depth;
+    helperLimits.infinite = true;
+
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < m_searches.size(); i++)
+    {
+        m_helperClocks[i]->start(helperLimits, root.sideToMove());
+        helpers.push_back(std::thread([this, i, &root, &gameHistory, &helperLimits]()
+        {
+            m_searches[i]->think(root, gameHistory, helperLimits, *m_helperClocks[i]);
+        }));
+    }
+
+    SearchResult result = m_searches[0]->think(root, gameHistory, limits, timeManager);
+
+    for (size_t i = 1; i < m_searches.size(); i++)
+        m_helperClocks[i]->requestStop();
+
+    for (size_t i = 0; i < helpers.size(); i++)
+    {
+        helpers[i].join();
+        result.nodes += m_searches[i + 1]->getNodes();
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+// Name : setThreadCount ()
+//-----------------------------------------------------------------------------
+void ParallelSearch::setThreadCount(int threadCount)
+{
+    if (threadCount < 1)
+        threadCount = 1;
+
+    m_searches.resize(threadCount);
+    m_helperClocks.resize(threadCount);
+
+    for (int i = 0; i < threadCount; i++)
+    {
+        if (!m_searches[i])
+        {
+            m_searches[i].reset(new Search(m_tt));
+            m_searches[i]->setCopyMake(m_copyMake);
+            m_searches[i]->setFeatures(m_features);
+        }
+
+        if (i > 0 && !m_helperClocks[i])
+            m_helperClocks[i].reset(new TimeManager());
+    }
+
+    m_searches[0]->setInfoCallback(m_infoCallback);
+}
+
+//-----------------------------------------------------------------------------
+// Name : setInfoCallback ()
+// Desc : only the main search reports its progress
+//-----------------------------------------------------------------------------
+void ParallelSearch::setInfoCallback(Search::InfoCallback callback)
+{
+    m_infoCallback = callback;
+    m_searches[0]->setInfoCallback(callback);
+}
+
+//-----------------------------------------------------------------------------
+// Name : setCopyMake ()
+//-----------------------------------------------------------------------------
+void ParallelSearch::setCopyMake(bool enabled)
+{
+    m_copyMake = enabled;
+    for (size_t i = 0; i < m_searches.size(); i++)
+        m_searches[i]->setCopyMake(enabled);
+}
+
+//-----------------------------------------------------------------------------
+// Name : setFeatures ()
+//-----------------------------------------------------------------------------
+void ParallelSearch::setFeatures(int features)
+{
+    m_features = features;
+    for (size_t i = 0; i < m_searches.size(); i++)
+        m_searches[i]->setFeatures(features);
+}
+
+//-----------------------------------------------------------------------------
+// Name : setMultiPV ()
+// Desc : the helpers only fill the hash, they keep searching a single line
+//-----------------------------------------------------------------------------
+void ParallelSearch::setMultiPV(int lines)
+{
+    m_searches[0]->setMultiPV(lines);
+}
+
+//-----------------------------------------------------------------------------
+// Name : clearHistory ()
+//-----------------------------------------------------------------------------
+void ParallelSearch::clearHistory()
+{
+    for (size_t i = 0; i < m_searches.size(); i++)
+        m_searches[i]->clearHistory();
+}
+
+//-----------------------------------------------------------------------------
+// Name : getThreadCount ()
+//-----------------------------------------------------------------------------
+int ParallelSearch::getThreadCount() const
+{
+    return static_cast<int>(m_searches.size());
+}
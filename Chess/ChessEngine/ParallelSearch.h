@@ -0,0 +1,70 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _PARALLELSEARCH_H_
+#define _PARALLELSEARCH_H_
+
+#include <vector>
+#include <memory>
+#include "Search.h"
+
+// lazy smp : every thread runs its own full search of the same root and they
+// only share the transposition table. the helpers fill the table with the
+// results of lines the main search reaches a bit later, the main search
+// alone decides the time and the move.
+// the helpers run under their own clocks that are stopped as soon as the main
+// search returns
+class ParallelSearch
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    explicit ParallelSearch(TranspositionTable& tt, int threadCount = 1);
+
+    ParallelSearch(const ParallelSearch&) = delete;
+    ParallelSearch& operator=(const ParallelSearch&) = delete;
+
+    // runs on the calling thread as the main search, same as Search::think()
+    SearchResult think(const Position& root, const std::vector<uint64_t>& gameHistory,
+                       const SearchLimits& limits, TimeManager& timeManager);
+
+    // must not be called while thinking
+    void setThreadCount (int threadCount);
+    void setInfoCallback(Search::InfoCallback callback);
+    void setCopyMake    (bool enabled);
+    void setFeatures    (int features);
+    void setMultiPV     (int lines);
+    void clearHistory   ();
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    int getThreadCount() const;
+
+private:
+    TranspositionTable&                       m_tt;
+    std::vector<std::unique_ptr<Search>>      m_searches;      // [0] is the main search
+    std::vector<std::unique_ptr<TimeManager>> m_helperClocks;  // [0] is unused
+    Search::InfoCallback                      m_infoCallback;
+    bool                                      m_copyMake;
+    int                                       m_features;
+};
+
+#endif // _PARALLELSEARCH_H_
@@ -27,7 +27,6 @@ class Pawn : public piece
 public:
     Pawn(int playerColor, BOARD_POINT _boardPoistion);
     ~Pawn(void);
-    bool validateNewPos(int dx,int dy, BOARD_POINT startSqaure, BOARD_POINT targetSquare,piece * SBoard[boardY][boardX]);
     int   getType();
 
 private:
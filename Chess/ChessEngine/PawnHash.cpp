@@ -0,0 +1,287 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PawnHash.h"
+
+namespace
+{
+    // penalties and bonuses, {middle game, end game}
+    const short DoubledMg  = -10, DoubledEg  = -25;
+    const short IsolatedMg = -10, IsolatedEg = -15;
+    const short BackwardMg = -8,  BackwardEg = -12;
+
+    // indexed by the relative rank of the passed pawn
+    const short PassedMg[boardY] = {0, 5, 10, 15, 30, 55, 90, 0};
+    const short PassedEg[boardY] = {0, 10, 20, 35, 60, 100, 150, 0};
+
+    // indexed by the relative rank of the closest pawn in front of the king,
+    // rank 0 means there is no such pawn on the file
+    const short ShelterPenalty[boardY] = {-35, 0, -8, -18, -26, -30, -33, -35};
+    const short OpenFilePenalty = -10;
+
+    struct PawnMasks
+    {
+        PawnMasks()
+        {
+            for (int f = 0; f < boardX; f++)
+            {
+                adjacentFiles[f] = 0;
+                if (f > 0)
+                    adjacentFiles[f] |= fileBB(f - 1);
+                if (f < boardX - 1)
+                    adjacentFiles[f] |= fileBB(f + 1);
+            }
+
+            for (int side = 0; side < 2; side++)
+            {
+                for (int col = 0; col < boardY; col++)
+                {
+                    forwardRanks[side][col] = 0;
+                    for (int c = 0; c < boardY; c++)
+                    {
+                        bool inFront = (side == BOTTOM) ? c < col : c > col;
+                        if (inFront)
+                            forwardRanks[side][col] |= 0xFFULL << (c * boardX);
+                    }
+                }
+
+                for (int square = 0; square < SQUARE_NB; square++)
+                {
+                    int f = squareRow(square);
+                    Bitboard forward = forwardRanks[side][squareCol(square)];
+
+                    forwardFile[side][square] = forward & fileBB(f);
+                    attackSpan[side][square]  = forward & adjacentFiles[f];
+                    passedMask[side][square]  = forwardFile[side][square] | attackSpan[side][square];
+
+                    pawnAttacks[side][square] = 0;
+                    int nextCol = (side == BOTTOM) ? squareCol(square) - 1 : squareCol(square) + 1;
+                    if (nextCol >= 0 && nextCol < boardY)
+                    {
+                        if (f > 0)
+                            pawnAttacks[side][square] |= squareBB(makeSquare(f - 1, nextCol));
+                        if (f < boardX - 1)
+                            pawnAttacks[side][square] |= squareBB(makeSquare(f + 1, nextCol));
+                    }
+                }
+            }
+        }
+
+        Bitboard adjacentFiles[boardX];
+        Bitboard forwardRanks[2][boardY];   // [side][col] ranks in front of the col
+        Bitboard forwardFile[2][SQUARE_NB];
+        Bitboard attackSpan[2][SQUARE_NB];
+        Bitboard passedMask[2][SQUARE_NB];
+        Bitboard pawnAttacks[2][SQUARE_NB];
+    };
+
+    const PawnMasks masks;
+}
+
+//-----------------------------------------------------------------------------
+// Name : kingShelter ()
+//-----------------------------------------------------------------------------
+int PawnEntry::kingShelter(int side, int kingSquare)
+{
+    if (shelterKingSquare[side] == kingSquare)
+        return shelterScore[side];
+
+    int other = 1 - side;
+    // the king is never sheltered by pawns behind it
+    Bitboard inFront = masks.forwardRanks[side][squareCol(kingSquare)];
+    Bitboard ours   = pawns[side]  & inFront;
+    Bitboard theirs = pawns[other] & inFront;
+
+    // a king on the edge is sheltered by the same files as a king next to it
+    int centerFile = squareRow(kingSquare);
+    if (centerFile == 0)
+        centerFile = 1;
+    if (centerFile == boardX - 1)
+        centerFile = boardX - 2;
+
+    int score = 0;
+    for (int f = centerFile - 1; f <= centerFile + 1; f++)
+    {
+        Bitboard filePawns = ours & fileBB(f);
+        if (filePawns)
+        {
+            int closest = (side == BOTTOM) ? msb(filePawns) : lsb(filePawns);
+            score += ShelterPenalty[relativeRank(side, closest)];
+        }
+        else
+        {
+            score += ShelterPenalty[0];
+            if (!(theirs & fileBB(f)))
+                score += OpenFilePenalty;
+        }
+    }
+
+    shelterKingSquare[side] = static_cast<signed char>(kingSquare);
+    shelterScore[side] = static_cast<short>(score);
+    return score;
+}
+
+//-----------------------------------------------------------------------------
+// Name : PawnHashTable (constructor)
+//-----------------------------------------------------------------------------
+PawnHashTable::PawnHashTable(unsigned int sizeInKB)
+{
+    resize(sizeInKB);
+}
+
+//-----------------------------------------------------------------------------
+// Name : resize ()
+//-----------------------------------------------------------------------------
+void PawnHashTable::resize(unsigned int sizeInKB)
+{
+    // round the entry count down to a power of 2 so the index is a mask
+    uint64_t count = (static_cast<uint64_t>(sizeInKB) * 1024) / sizeof(PawnEntry);
+    uint64_t size = 1;
+    while (size * 2 <= count)
+        size *= 2;
+
+    m_entries.resize(size);
+    m_mask = size - 1;
+    clear();
+}
+
+//-----------------------------------------------------------------------------
+// Name : clear ()
+//-----------------------------------------------------------------------------
+void PawnHashTable::clear()
+{
+    // an empty entry is a valid evaluation of the position with no pawns(key 0)
+    PawnEntry emptyEntry = {};
+    emptyEntry.shelterKingSquare[UPPER]  = NO_SQUARE;
+    emptyEntry.shelterKingSquare[BOTTOM] = NO_SQUARE;
+
+    for (PawnEntry& entry : m_entries)
+        entry = emptyEntry;
+
+    m_probes = 0;
+    m_hits = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : probe ()
+//-----------------------------------------------------------------------------
+PawnEntry* PawnHashTable::probe(uint64_t pawnKey, const Bitboard pawns[2])
+{
+    PawnEntry& entry = m_entries[pawnKey & m_mask];
+    m_probes++;
+
+    if (entry.key == pawnKey && entry.pawns[UPPER] == pawns[UPPER] && entry.pawns[BOTTOM] == pawns[BOTTOM])
+    {
+        m_hits++;
+        return &entry;
+    }
+
+    entry.key = pawnKey;
+    entry.pawns[UPPER]  = pawns[UPPER];
+    entry.pawns[BOTTOM] = pawns[BOTTOM];
+    entry.shelterKingSquare[UPPER]  = NO_SQUARE;
+    entry.shelterKingSquare[BOTTOM] = NO_SQUARE;
+
+    evaluatePawns(entry, UPPER);
+    evaluatePawns(entry, BOTTOM);
+
+    return &entry;
+}
+
+//-----------------------------------------------------------------------------
+// Name : evaluatePawns ()
+//-----------------------------------------------------------------------------
+void PawnHashTable::evaluatePawns(PawnEntry& entry, int side)
+{
+    int other = 1 - side;
+    Bitboard ours   = entry.pawns[side];
+    Bitboard theirs = entry.pawns[other];
+
+    int mg = 0, eg = 0;
+    entry.passedPawns[side] = 0;
+    entry.pawnAttacks[side] = 0;
+    entry.semiOpenFiles[side] = 0xFF;
+
+    Bitboard remaining = ours;
+    while (remaining)
+    {
+        int square = popLsb(remaining);
+        int f = squareRow(square);
+
+        entry.pawnAttacks[side] |= masks.pawnAttacks[side][square];
+        entry.semiOpenFiles[side] &= ~(1 << f);
+
+        bool doubled  = (ours & masks.forwardFile[side][square]) != 0;
+        bool isolated = (ours & masks.adjacentFiles[f]) == 0;
+        bool passed   = !doubled && (theirs & masks.passedMask[side][square]) == 0;
+
+        if (doubled)
+        {
+            mg += DoubledMg;
+            eg += DoubledEg;
+        }
+
+        if (isolated)
+        {
+            mg += IsolatedMg;
+            eg += IsolatedEg;
+        }
+        else if (!passed)
+        {
+            // backward : no pawn on the adjacent files can ever defend it and
+            // an enemy pawn already controls the square in front of it
+            Bitboard supporters = ours & masks.adjacentFiles[f] & ~masks.forwardRanks[side][squareCol(square)];
+            int stopSquare = (side == BOTTOM) ? square - boardX : square + boardX;
+
+            if (!supporters && stopSquare >= 0 && stopSquare < SQUARE_NB &&
+                (theirs & masks.pawnAttacks[side][stopSquare]))
+            {
+                mg += BackwardMg;
+                eg += BackwardEg;
+            }
+        }
+
+        if (passed)
+        {
+            entry.passedPawns[side] |= squareBB(square);
+            mg += PassedMg[relativeRank(side, square)];
+            eg += PassedEg[relativeRank(side, square)];
+        }
+    }
+
+    entry.mgScore[side] = static_cast<short>(mg);
+    entry.egScore[side] = static_cast<short>(eg);
+}
+
+//-----------------------------------------------------------------------------
+// Name : getProbes ()
+//-----------------------------------------------------------------------------
+uint64_t PawnHashTable::getProbes() const
+{
+    return m_probes;
+}
+
+//-----------------------------------------------------------------------------
+// Name : getHits ()
+//-----------------------------------------------------------------------------
+uint64_t PawnHashTable::getHits() const
+{
+    return m_hits;
+}
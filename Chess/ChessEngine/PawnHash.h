@@ -0,0 +1,77 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _PAWNHASH_H_
+#define _PAWNHASH_H_
+
+#include <vector>
+#include "Bitboard.h"
+
+// cached evaluation of one pawn structure.
+// everything here depends only on the pawns so it can be reused by every
+// position that shares the same pawn key
+struct PawnEntry
+{
+    int kingShelter(int side, int kingSquare);
+
+    uint64_t key;
+    Bitboard pawns[2];          // [side] the pawns the entry was evaluated from
+    Bitboard passedPawns[2];
+    Bitboard pawnAttacks[2];
+    short    mgScore[2];        // [side] structure score of each side pawns
+    short    egScore[2];
+    unsigned char semiOpenFiles[2]; // bit n is set when file n has no pawn of the side
+
+    // the king shelter depends on the king square as well, so the last one is
+    // cached here, most of the time the king has not moved since
+    signed char shelterKingSquare[2];
+    short       shelterScore[2];
+};
+
+// hash table of evaluated pawn structures indexed by the pawn zobrist key.
+// not thread safe, every searching thread keeps its own table
+class PawnHashTable
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    explicit PawnHashTable(unsigned int sizeInKB = 512);
+
+    void resize(unsigned int sizeInKB);
+    void clear();
+
+    PawnEntry* probe(uint64_t pawnKey, const Bitboard pawns[2]);
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    uint64_t getProbes() const;
+    uint64_t getHits  () const;
+
+private:
+    static void evaluatePawns(PawnEntry& entry, int side);
+
+    std::vector<PawnEntry> m_entries;
+    uint64_t m_mask;
+    uint64_t m_probes;
+    uint64_t m_hits;
+};
+
+#endif // _PAWNHASH_H_
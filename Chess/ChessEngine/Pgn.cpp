@@ -0,0 +1,616 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Pgn.h"
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+    const char PieceLetters[] = "PNBRQK";
+
+    bool isResult(const char* token, size_t length)
+    {
+        return (length == 3 && (std::memcmp(token, "1-0", 3) == 0 || std::memcmp(token, "0-1", 3) == 0)) ||
+               (length == 7 && std::memcmp(token, "1/2-1/2", 7) == 0) ||
+               (length == 1 && token[0] == '*');
+    }
+
+    // the en passant mark some programs write after the capture, as its own
+    // token("exf6 e.p.") or glued to the move
+    const char   EnPassantMark[]     = "e.p.";
+    const size_t EnPassantMarkLength = 4;
+
+    bool endsWithEnPassantMark(const char* token, size_t length)
+    {
+        return length >= EnPassantMarkLength &&
+               std::memcmp(token + length - EnPassantMarkLength, EnPassantMark, EnPassantMarkLength) == 0;
+    }
+
+    // the mark on its own, possibly annotated("e.p.", "e.p.!")
+    bool isEnPassantMark(const char* token, size_t length)
+    {
+        while (length > 0 && std::strchr("+#!?", token[length - 1]))
+            length--;
+        return length == EnPassantMarkLength && endsWithEnPassantMark(token, length);
+    }
+
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\v';
+    }
+
+    // characters that end a movetext token on their own
+    bool isDelimiter(char c)
+    {
+        return isSpace(c) || c == '{' || c == '}' || c == '(' || c == ')' || c == ';' || c == '[' || c == ']' || c == '$';
+    }
+
+    int letterToType(char letter)
+    {
+        const char* found = std::strchr(PieceLetters, letter);
+        return (letter != '\0' && found) ? static_cast<int>(found - PieceLetters) : -1;
+    }
+
+    const char* skipPast(const char* cur, const char* end, char c)
+    {
+        const char* found = static_cast<const char*>(std::memchr(cur, c, end - cur));
+        return found ? found + 1 : end;
+    }
+
+    const char* skipSpaces(const char* cur, const char* end)
+    {
+        while (cur < end && isSpace(*cur))
+            cur++;
+        return cur;
+    }
+
+    //-------------------------------------------------------------------------
+    // finds the next movetext token in place, stepping over comments,
+    // variations and numeric annotations. returns false at the end of the
+    // text or at a tag, which starts the next game
+    //-------------------------------------------------------------------------
+    bool nextToken(const char*& cur, const char* end, const char*& token, size_t& length)
+    {
+        for (;;)
+        {
+            cur = skipSpaces(cur, end);
+            if (cur == end || *cur == '[')
+                return false;
+
+            char c = *cur++;
+            if (c == '{')
+                cur = skipPast(cur, end, '}');
+            else if (c == ';' || c == '%')
+                cur = skipPast(cur, end, '\n');
+            else if (c == '(')
+            {
+                // variations nest and may hold comments with parentheses in them
+                int depth = 1;
+                while (depth > 0 && cur < end)
+                {
+                    c = *cur++;
+                    if (c == '(')
+                        depth++;
+                    else if (c == ')')
+                        depth--;
+                    else if (c == '{')
+                        cur = skipPast(cur, end, '}');
+                }
+            }
+            else if (c == '$')
+            {
+                while (cur < end && *cur >= '0' && *cur <= '9')
+                    cur++;
+            }
+            else if (!isDelimiter(c))
+            {
+                token = cur - 1;
+                while (cur < end && !isDelimiter(*cur))
+                    cur++;
+                length = cur - token;
+                return true;
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // [Name "value"], the value may hold escaped quotes
+    //-------------------------------------------------------------------------
+    const char* parseTag(const char* cur, const char* end, PgnGame& game)
+    {
+        const char* lineEnd = skipPast(cur, end, '\n');
+        cur++;     // [
+
+        const char* name = cur;
+        while (cur < lineEnd && !isSpace(*cur) && *cur != ']' && *cur != '"')
+            cur++;
+        size_t nameLength = cur - name;
+
+        while (cur < lineEnd && *cur != '"' && *cur != ']')
+            cur++;
+
+        if (nameLength == 0 || cur == lineEnd || *cur != '"')
+            return lineEnd;
+
+        std::string value;
+        for (cur++; cur < lineEnd && *cur != '"'; cur++)
+        {
+            if (*cur == '\\' && cur + 1 < lineEnd)
+                cur++;
+            value += *cur;
+        }
+
+        game.setTag(std::string(name, nameLength), value);
+        return lineEnd;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : clear ()
+//-----------------------------------------------------------------------------
+void PgnGame::clear()
+{
+    tags.clear();
+    start.setStartPosition();
+    moves.clear();
+    result = "*";
+    error.clear();
+}
+
+//-----------------------------------------------------------------------------
+// Name : getTag ()
+//-----------------------------------------------------------------------------
+std::string PgnGame::getTag(const std::string& name) const
+{
+    for (size_t i = 0; i < tags.size(); i++)
+        if (tags[i].first == name)
+            return tags[i].second;
+
+    return std::string();
+}
+
+//-----------------------------------------------------------------------------
+// Name : setTag ()
+//-----------------------------------------------------------------------------
+void PgnGame::setTag(const std::string& name, const std::string& value)
+{
+    for (size_t i = 0; i < tags.size(); i++)
+        if (tags[i].first == name)
+        {
+            tags[i].second = value;
+            return;
+        }
+
+    tags.push_back(Tag(name, value));
+}
+
+//-----------------------------------------------------------------------------
+// Name : PgnReader (constructor)
+//-----------------------------------------------------------------------------
+PgnReader::PgnReader()
+{
+    m_begin = m_end = m_cur = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// Name : PgnReader (constructor)
+//-----------------------------------------------------------------------------
+PgnReader::PgnReader(const char* data, size_t size)
+{
+    m_begin = m_cur = data;
+    m_end = data + size;
+}
+
+//-----------------------------------------------------------------------------
+// Name : open ()
+//-----------------------------------------------------------------------------
+bool PgnReader::open(const std::string& path)
+{
+    close();
+
+    if (!m_file.open(path))
+        return false;
+
+    m_begin = m_cur = reinterpret_cast<const char*>(m_file.data());
+    m_end = m_begin + m_file.size();
+
+    // utf-8 byte order mark
+    if (m_end - m_begin >= 3 && std::memcmp(m_begin, "\xEF\xBB\xBF", 3) == 0)
+        m_cur += 3;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : close ()
+//-----------------------------------------------------------------------------
+void PgnReader::close()
+{
+    m_file.close();
+    m_begin = m_end = m_cur = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// Name : nextGame ()
+// Desc : a game is its tag lines followed by movetext up to the result, or up
+//        to the tags of the next game when the result is missing
+//-----------------------------------------------------------------------------
+bool PgnReader::nextGame(PgnGameText& text)
+{
+    const char* cur = skipSpaces(m_cur, m_end);
+    if (cur == m_end)
+    {
+        m_cur = m_end;
+        return false;
+    }
+
+    text.begin = cur;
+    text.offset = cur - m_begin;
+
+    while (cur < m_end && *cur == '[')
+        cur = skipSpaces(skipPast(cur, m_end, '\n'), m_end);
+
+    const char* token;
+    size_t length;
+    while (nextToken(cur, m_end, token, length))
+        if (isResult(token, length))
+            break;
+
+    // stray closing brackets are the only text that neither forms a tag nor
+    // a token, step over them so the scan always moves on
+    if (cur == text.begin)
+        cur++;
+
+    text.end = cur;
+    m_cur = cur;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : readGame ()
+//-----------------------------------------------------------------------------
+bool PgnReader::readGame(PgnGame& game)
+{
+    PgnGameText text;
+    if (!nextGame(text))
+        return false;
+
+    parseGame(text, game);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : parseGame ()
+//-----------------------------------------------------------------------------
+bool PgnReader::parseGame(const PgnGameText& text, PgnGame& game)
+{
+    game.clear();
+
+    const char* cur = text.begin;
+    const char* end = text.end;
+
+    for (cur = skipSpaces(cur, end); cur < end && *cur == '['; cur = skipSpaces(cur, end))
+        cur = parseTag(cur, end, game);
+
+    std::string fen = game.getTag("FEN");
+    if (!fen.empty() && !game.start.setFromFEN(fen))
+    {
+        game.start.setStartPosition();
+        game.error = "invalid FEN " + fen;
+        return false;
+    }
+
+    Position pos = game.start;
+    const char* token;
+    size_t length;
+
+    while (nextToken(cur, end, token, length))
+    {
+        if (isResult(token, length))
+        {
+            game.result.assign(token, length);
+            break;
+        }
+
+        // a mark that stands on its own belongs to the move before it
+        if (isEnPassantMark(token, length))
+            continue;
+
+        // move numbers, possibly glued to the move("12.e4", "12...Nf6")
+        size_t moveStart = 0;
+        while (moveStart < length && ((token[moveStart] >= '0' && token[moveStart] <= '9') || token[moveStart] == '.'))
+            moveStart++;
+        if (moveStart == length || !game.error.empty())
+            continue;
+
+        Move move = parseSAN(pos, token + moveStart, length - moveStart);
+        if (move == MOVE_NONE)
+        {
+            std::ostringstream ss;
+            ss << "move " << pos.fullMoveNumber() << (pos.sideToMove() == BOTTOM ? ". " : "... ")
+               << std::string(token + moveStart, length - moveStart) << " is not legal";
+            game.error = ss.str();
+            continue;
+        }
+
+        UndoInfo undo;
+        pos.doMove(move, undo);
+        game.moves.push_back(move);
+    }
+
+    return game.error.empty();
+}
+
+//-----------------------------------------------------------------------------
+// Name : isOpen ()
+//-----------------------------------------------------------------------------
+bool PgnReader::isOpen() const
+{
+    return m_begin != nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// Name : size ()
+//-----------------------------------------------------------------------------
+size_t PgnReader::size() const
+{
+    return m_end - m_begin;
+}
+
+//-----------------------------------------------------------------------------
+// Name : moveToSAN ()
+//-----------------------------------------------------------------------------
+std::string moveToSAN(const Position& pos, Move move)
+{
+    int from = moveFrom(move);
+    int to = moveTo(move);
+    std::string san;
+
+    if (moveType(move) == CASTLING_MOVE)
+        san = (squareRow(to) == 6) ? "O-O" : "O-O-O";
+    else
+    {
+        int type = pieceType(pos.pieceOn(from));
+        bool capture = pos.isCapture(move);
+
+        if (type == PAWN)
+        {
+            if (capture)
+                san += static_cast<char>('a' + squareRow(from));
+        }
+        else
+        {
+            san += PieceLetters[type];
+
+            // name the file, the rank or both when another piece of the
+            // same type can reach the same square
+            MoveList moveList;
+            pos.generateLegalMoves(moveList);
+
+            bool ambiguous = false, sameFile = false, sameRank = false;
+            for (int i = 0; i < moveList.size; i++)
+            {
+                int otherFrom = moveFrom(moveList.moves[i]);
+                if (otherFrom == from || moveTo(moveList.moves[i]) != to || pieceType(pos.pieceOn(otherFrom)) != type)
+                    continue;
+
+                ambiguous = true;
+                sameFile |= squareRow(otherFrom) == squareRow(from);
+                sameRank |= squareCol(otherFrom) == squareCol(from);
+            }
+
+            if (ambiguous)
+            {
+                if (!sameFile || sameRank)
+                    san += static_cast<char>('a' + squareRow(from));
+                if (sameFile)
+                    san += static_cast<char>('8' - squareCol(from));
+            }
+        }
+
+        if (capture)
+            san += 'x';
+        san += squareToString(to);
+
+        if (moveType(move) == PROMOTION_MOVE)
+        {
+            san += '=';
+            san += PieceLetters[promotionType(move)];
+        }
+    }
+
+    Position next = pos;
+    UndoInfo undo;
+    next.doMove(move, undo);
+    if (next.inCheck())
+        san += next.hasLegalMove() ? '+' : '#';
+
+    return san;
+}
+
+//-----------------------------------------------------------------------------
+// Name : parseSAN ()
+// Desc : works on the text in place, a pgn file is parsed without a string
+//        per move
+//-----------------------------------------------------------------------------
+Move parseSAN(const Position& pos, const char* san, size_t length)
+{
+    for (;;)
+    {
+        if (length > 0 && std::strchr("+#!?", san[length - 1]))
+            length--;
+        else if (length > EnPassantMarkLength && endsWithEnPassantMark(san, length))
+            length -= EnPassantMarkLength;
+        else
+            break;
+    }
+
+    // only the few moves that fit the text are checked for legality
+    MoveList moveList;
+    pos.generateMoves(moveList);
+
+    bool shortCastle = (length == 3 && (std::memcmp(san, "O-O", 3) == 0 || std::memcmp(san, "0-0", 3) == 0));
+    bool longCastle = (length == 5 && (std::memcmp(san, "O-O-O", 5) == 0 || std::memcmp(san, "0-0-0", 5) == 0));
+    if (shortCastle || longCastle)
+    {
+        int file = shortCastle ? 6 : 2;
+        for (int i = 0; i < moveList.size; i++)
+            if (moveType(moveList.moves[i]) == CASTLING_MOVE && squareRow(moveTo(moveList.moves[i])) == file &&
+                pos.isLegal(moveList.moves[i]))
+                return moveList.moves[i];
+        return MOVE_NONE;
+    }
+
+    int type = PAWN;
+    size_t start = 0;
+    if (length > 0 && san[0] >= 'A' && san[0] <= 'Z')
+    {
+        type = letterToType(san[0]);
+        if (type <= PAWN)
+            return MOVE_NONE;
+        start = 1;
+    }
+
+    // promotion as e8=Q or e8Q
+    int promotion = -1;
+    size_t end = length;
+    if (end > 0 && type == PAWN && letterToType(san[end - 1]) > PAWN)
+    {
+        promotion = letterToType(san[end - 1]);
+        end -= (end > 1 && san[end - 2] == '=') ? 2 : 1;
+    }
+
+    // the origin hints and the target square, without capture signs
+    char squares[4];
+    size_t count = 0;
+    for (size_t i = start; i < end; i++)
+    {
+        if (san[i] == 'x' || san[i] == '-' || san[i] == ':')
+            continue;
+        if (count == sizeof(squares))
+            return MOVE_NONE;
+        squares[count++] = san[i];
+    }
+
+    if (count < 2)
+        return MOVE_NONE;
+
+    char file = squares[count - 2], rank = squares[count - 1];
+    if (file < 'a' || file > 'h' || rank < '1' || rank > '8')
+        return MOVE_NONE;
+    int to = makeSquare(file - 'a', '8' - rank);
+
+    int fromFile = -1, fromRank = -1;
+    for (size_t i = 0; i + 2 < count; i++)
+    {
+        if (squares[i] >= 'a' && squares[i] <= 'h')
+            fromFile = squares[i] - 'a';
+        else if (squares[i] >= '1' && squares[i] <= '8')
+            fromRank = '8' - squares[i];
+        else
+            return MOVE_NONE;
+    }
+
+    Move found = MOVE_NONE;
+    for (int i = 0; i < moveList.size; i++)
+    {
+        Move move = moveList.moves[i];
+        int from = moveFrom(move);
+
+        if (moveTo(move) != to || moveType(move) == CASTLING_MOVE || pieceType(pos.pieceOn(from)) != type)
+            continue;
+        if ((fromFile >= 0 && squareRow(from) != fromFile) || (fromRank >= 0 && squareCol(from) != fromRank))
+            continue;
+        if ((moveType(move) == PROMOTION_MOVE) != (promotion >= 0) ||
+            (promotion >= 0 && promotionType(move) != promotion) || !pos.isLegal(move))
+            continue;
+
+        // two matches means the move was not disambiguated enough
+        if (found != MOVE_NONE)
+            return MOVE_NONE;
+        found = move;
+    }
+
+    return found;
+}
+
+//-----------------------------------------------------------------------------
+// Name : parseSAN ()
+//-----------------------------------------------------------------------------
+Move parseSAN(const Position& pos, const std::string& san)
+{
+    return parseSAN(pos, san.data(), san.size());
+}
+
+//-----------------------------------------------------------------------------
+// Name : writePgn ()
+//-----------------------------------------------------------------------------
+void writePgn(std::ostream& out, const PgnGame& game, const std::vector<std::string>& comments)
+{
+    for (size_t i = 0; i < game.tags.size(); i++)
+    {
+        out << "[" << game.tags[i].first << " \"";
+        for (size_t c = 0; c < game.tags[i].second.size(); c++)
+        {
+            char ch = game.tags[i].second[c];
+            if (ch == '"' || ch == '\\')
+                out << '\\';
+            out << ch;
+        }
+        out << "\"]\n";
+    }
+    out << "\n";
+
+    // movetext lines are kept under 80 characters
+    std::string line;
+    Position pos = game.start;
+
+    for (size_t i = 0; i < game.moves.size(); i++)
+    {
+        std::string text;
+        if (pos.sideToMove() == BOTTOM)
+            text = std::to_string(pos.fullMoveNumber()) + ". ";
+        else if (i == 0 || (i <= comments.size() && !comments[i - 1].empty()))
+            text = std::to_string(pos.fullMoveNumber()) + "... ";
+
+        text += moveToSAN(pos, game.moves[i]);
+        if (i < comments.size() && !comments[i].empty())
+            text += " {" + comments[i] + "}";
+
+        if (!line.empty() && line.size() + text.size() + 1 > 79)
+        {
+            out << line << "\n";
+            line.clear();
+        }
+        line += (line.empty() ? "" : " ") + text;
+
+        UndoInfo undo;
+        pos.doMove(game.moves[i], undo);
+    }
+
+    if (!line.empty() && line.size() + game.result.size() + 1 > 79)
+    {
+        out << line << "\n";
+        line.clear();
+    }
+    line += (line.empty() ? "" : " ") + game.result;
+    out << line << "\n\n";
+}
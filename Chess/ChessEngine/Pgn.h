@@ -0,0 +1,112 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _PGN_H_
+#define _PGN_H_
+
+#include <iostream>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+#include "Position.h"
+#include "MappedFile.h"
+
+// a game as a pgn file holds it : the tag pairs, the start position(the
+// standard one unless a FEN tag says otherwise) and the moves played
+struct PgnGame
+{
+    typedef std::pair<std::string, std::string> Tag;
+
+    void        clear ();
+    std::string getTag(const std::string& name) const;
+    void        setTag(const std::string& name, const std::string& value);
+
+    std::vector<Tag>  tags;
+    Position          start;
+    std::vector<Move> moves;
+    std::string       result;       // "1-0", "0-1", "1/2-1/2" or "*"
+    // why the moves stopped short of the movetext, empty for a valid game
+    std::string       error;
+};
+
+// the raw text of one game inside the reader's buffer
+struct PgnGameText
+{
+    const char* begin;
+    const char* end;
+    size_t      offset;             // of begin from the start of the file
+};
+
+// reads the games of a pgn file one after the other.
+// the file is memory mapped and split into games by a scan that only looks
+// for tag lines and results, parsing a game is a separate step so the split
+// can run on one thread and the parsing on many. movetext is tokenized in
+// place and every move is checked against the legal move generator, the
+// first move that is not legal ends the moves of its game.
+// comments, variations and numeric annotations are skipped
+class PgnReader
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    PgnReader();
+    // reads from memory the caller keeps alive
+    PgnReader(const char* data, size_t size);
+
+    PgnReader(const PgnReader&) = delete;
+    PgnReader& operator=(const PgnReader&) = delete;
+
+    bool open (const std::string& path);
+    void close();
+
+    // returns false once there are no more games
+    bool nextGame(PgnGameText& text);
+    bool readGame(PgnGame& game);
+    // returns false when the game holds a move that is not legal
+    static bool parseGame(const PgnGameText& text, PgnGame& game);
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    bool   isOpen() const;
+    size_t size  () const;
+
+private:
+    MappedFile  m_file;
+    const char* m_begin;
+    const char* m_end;
+    const char* m_cur;
+};
+
+//-----------------------------------------------------------------------------
+// Standard algebraic notation(Nf3, exd5, O-O, e8=Q+)
+//-----------------------------------------------------------------------------
+std::string moveToSAN(const Position& pos, Move move);
+// accepts the usual annotation suffixes and an "e.p." mark, MOVE_NONE when
+// illegal or ambiguous
+Move        parseSAN (const Position& pos, const char* san, size_t length);
+Move        parseSAN (const Position& pos, const std::string& san);
+
+// writes the game with an optional comment after each move
+void        writePgn (std::ostream& out, const PgnGame& game,
+                      const std::vector<std::string>& comments = std::vector<std::string>());
+
+#endif // _PGN_H_
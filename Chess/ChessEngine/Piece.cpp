@@ -74,46 +74,3 @@ bool piece::isMoved()
 {
     return !m_onStartPoint;
 }
-
-//-----------------------------------------------------------------------------
-// Name : getDx 
-//-----------------------------------------------------------------------------
-void piece::getDx(int inputArray[])
-{
-    inputArray[0] = dx[0];
-    inputArray[1] = dx[1];
-}
-
-//-----------------------------------------------------------------------------
-// Name : getDy 
-//-----------------------------------------------------------------------------
-void piece::getDy(int inputArray[])
-{
-    inputArray[0] = dy[0];
-    inputArray[1] = dy[1];
-}
-
-
-//-----------------------------------------------------------------------------
-// Name : isPieceInWay 
-//-----------------------------------------------------------------------------
-bool piece::isPieceInWay(BOARD_POINT startSquare, BOARD_POINT targetSquare, DIR_VEC dirVec, piece * sBoard[boardY][boardX])
-{
-    BOARD_POINT curSquare = startSquare;
-    piece * curPiece;
-
-    curSquare.col -= dirVec.y;
-    curSquare.row -= dirVec.x;
-
-    while (curSquare.col != targetSquare.col || curSquare.row != targetSquare.row)
-    {
-        curPiece = sBoard[curSquare.col][curSquare.row];//gets the piece on the current square
-        if (curPiece != nullptr)//if there is a piece return false as there should be no piece in the way to the target square
-            return false;
-
-        curSquare.col -= dirVec.y;
-        curSquare.row -= dirVec.x;
-    }
-
-    return true;
-} 
@@ -22,7 +22,8 @@
 
 #include "Chess.h"
 
-// the base class to all the chess pieces
+// the base class to all the chess pieces the views draw, the rules they move
+// by live in Position
 class piece
 {
 public:
@@ -36,14 +37,12 @@ public:
     //-------------------------------------------------------------------------
     // Pure Virtual functions of this class
     //-------------------------------------------------------------------------
-    virtual bool  validateNewPos(int dx,int dy, BOARD_POINT startSqaure, BOARD_POINT targetSquare,piece * SBoard[boardY][boardX])=0; 
     // returns the piece type PAWN,KNIGHT,BISHOP,ROOK,QUEEN,KING
     virtual int   getType() = 0; 
 
     //-------------------------------------------------------------------------
     // misc Functions
     //-------------------------------------------------------------------------
-    bool isPieceInWay(BOARD_POINT startSquare, BOARD_POINT targetSquare, DIR_VEC dirVec, piece * sBoard[boardY][boardX]);
     bool isMoved();
 
     //-------------------------------------------------------------------------
@@ -57,15 +56,11 @@ public:
     //-------------------------------------------------------------------------
     int getColor();
     BOARD_POINT getPosition();
-    void getDx(int inputArray[]);
-    void getDy(int inputArray[]);
 
 protected:
     BOARD_POINT boardPoistion;
     int color;
     bool m_onStartPoint;
-    int dx[2];
-    int dy[2];
 };
 
 #endif // _PIECE_H_
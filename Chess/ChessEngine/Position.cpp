@@ -0,0 +1,934 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Position.h"
+#include "Attacks.h"
+#include "Zobrist.h"
+#include <sstream>
+#include <cstring>
+
+namespace
+{
+    const char* StartFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    const char* PieceChars = "pnbrqk";
+
+    // king and rook squares of each castling move
+    struct CastlingInfo
+    {
+        int right;
+        int kingFrom, kingTo;
+        int rookFrom, rookTo;
+    };
+
+    const CastlingInfo Castlings[4] =
+    {
+        {WHITE_OO,  60, 62, 63, 61},
+        {WHITE_OOO, 60, 58, 56, 59},
+        {BLACK_OO,   4,  6,  7,  5},
+        {BLACK_OOO,  4,  2,  0,  3}
+    };
+
+    //-----------------------------------------------------------------------------
+    // Name : castlingMask ()
+    // Desc : the castling rights lost when a piece moves from/to the square
+    //-----------------------------------------------------------------------------
+    int castlingMask(int square)
+    {
+        switch (square)
+        {
+        case 60: return WHITE_OO | WHITE_OOO;
+        case 63: return WHITE_OO;
+        case 56: return WHITE_OOO;
+        case 4:  return BLACK_OO | BLACK_OOO;
+        case 7:  return BLACK_OO;
+        case 0:  return BLACK_OOO;
+        default: return 0;
+        }
+    }
+
+    const CastlingInfo* findCastling(Move move)
+    {
+        for (const CastlingInfo& castling : Castlings)
+            if (castling.kingFrom == moveFrom(move) && castling.kingTo == moveTo(move))
+                return &castling;
+        return nullptr;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : Position (constructor)
+//-----------------------------------------------------------------------------
+Position::Position()
+{
+    clear();
+}
+
+//-----------------------------------------------------------------------------
+// Name : clear ()
+//-----------------------------------------------------------------------------
+void Position::clear()
+{
+    std::memset(m_squares, NO_PIECE, sizeof(m_squares));
+    for (int type = PAWN; type <= KING; type++)
+        m_byType[type] = 0;
+    m_bySide[UPPER] = 0;
+    m_bySide[BOTTOM] = 0;
+
+    m_key = 0;
+    m_pawnKey = 0;
+    m_sideToMove = BOTTOM;
+    m_castling = NO_CASTLING;
+    m_epSquare = NO_SQUARE;
+    m_rule50 = 0;
+    m_fullMove = 1;
+}
+
+//-----------------------------------------------------------------------------
+// Name : setStartPosition ()
+//-----------------------------------------------------------------------------
+void Position::setStartPosition()
+{
+    setFromFEN(StartFEN);
+}
+
+//-----------------------------------------------------------------------------
+// Name : setFromFEN ()
+//-----------------------------------------------------------------------------
+bool Position::setFromFEN(const std::string& fen)
+{
+    std::istringstream fenStream(fen);
+    std::string placement, side, castling, enPassant;
+    int rule50 = 0, fullMove = 1;
+
+    fenStream >> placement >> side >> castling >> enPassant;
+    if (placement.empty())
+        return false;
+
+    if (!(fenStream >> rule50))
+        rule50 = 0;
+    if (!(fenStream >> fullMove))
+        fullMove = 1;
+
+    if (side != "w" && side != "b")
+        return false;
+
+    clear();
+
+    // fen lists the squares from a8 to h1 which is the board square order,
+    // every rank has to add up to 8 squares on its own
+    int square = 0;
+    int file = 0;
+    for (char c : placement)
+    {
+        if (c == '/')
+        {
+            if (file != boardX || square >= SQUARE_NB)
+                return false;
+
+            file = 0;
+            continue;
+        }
+
+        if (c >= '1' && c <= '8')
+        {
+            file += c - '0';
+            square += c - '0';
+            if (file > boardX)
+                return false;
+            continue;
+        }
+
+        const char* found = std::strchr(PieceChars, c >= 'a' ? c : c - 'A' + 'a');
+        if (found == nullptr || *found == '\0' || file >= boardX)
+            return false;
+
+        putPiece(c >= 'a' ? UPPER : BOTTOM, static_cast<int>(found - PieceChars), square);
+        file++;
+        square++;
+    }
+
+    if (square != SQUARE_NB || file != boardX || !isValid())
+        return false;
+
+    int sideToMove = (side == "b") ? UPPER : BOTTOM;
+    int epSquare = NO_SQUARE;
+    if (enPassant != "-")
+    {
+        epSquare = stringToSquare(enPassant);
+        if (enPassant.size() != 2 || !isValidEnPassant(sideToMove, epSquare))
+            return false;
+    }
+
+    int castlingRights = NO_CASTLING;
+    for (char c : castling)
+    {
+        switch (c)
+        {
+        case 'K': castlingRights |= WHITE_OO;  break;
+        case 'Q': castlingRights |= WHITE_OOO; break;
+        case 'k': castlingRights |= BLACK_OO;  break;
+        case 'q': castlingRights |= BLACK_OOO; break;
+        default: break;
+        }
+    }
+
+    setState(sideToMove, supportedCastling(castlingRights), epSquare, rule50, fullMove);
+    return !isSquareAttacked(kingSquare(1 - sideToMove), sideToMove);
+}
+
+//-----------------------------------------------------------------------------
+// Name : isValid ()
+//-----------------------------------------------------------------------------
+bool Position::isValid() const
+{
+    const Bitboard BackRanks = 0xFF000000000000FFULL;
+
+    return popCount(pieces(BOTTOM, KING)) == 1 && popCount(pieces(UPPER, KING)) == 1 &&
+           !(piecesOfType(PAWN) & BackRanks);
+}
+
+//-----------------------------------------------------------------------------
+// Name : isValidEnPassant ()
+// Desc : the square was just passed by a double pawn push of the side that
+//        is not to move : the pawn stands in front of it and the square and
+//        the one the pawn came from are empty
+//-----------------------------------------------------------------------------
+bool Position::isValidEnPassant(int sideToMove, int square) const
+{
+    if (square == NO_SQUARE)
+        return false;
+
+    // the rank index counts from the 8th rank, so white captures on the 6th
+    // rank(index 2) and black on the 3rd(index 5)
+    int forward = (sideToMove == BOTTOM) ? 8 : -8;
+    if (squareCol(square) != ((sideToMove == BOTTOM) ? 2 : 5))
+        return false;
+
+    return m_squares[square + forward] == makePiece(1 - sideToMove, PAWN) &&
+           m_squares[square] == NO_PIECE && m_squares[square - forward] == NO_PIECE;
+}
+
+//-----------------------------------------------------------------------------
+// Name : supportedCastling ()
+// Desc : drops the rights the pieces on the board can not back up
+//-----------------------------------------------------------------------------
+int Position::supportedCastling(int castlingRights) const
+{
+    for (const CastlingInfo& info : Castlings)
+    {
+        int side = (info.right & (WHITE_OO | WHITE_OOO)) ? BOTTOM : UPPER;
+        if (m_squares[info.kingFrom] != makePiece(side, KING) || m_squares[info.rookFrom] != makePiece(side, ROOK))
+            castlingRights &= ~info.right;
+    }
+
+    return castlingRights;
+}
+
+//-----------------------------------------------------------------------------
+// Name : pack ()
+// Desc : bytes 0-7   occupied squares
+//        bytes 8-23  the piece of each occupied square in square order, 4 bits each
+//        byte  24    side to move
+//        byte  25    castling rights
+//        byte  26    en passant square, 0xFF for none
+//        byte  27    rule50 counter
+//        bytes 28-29 full move number
+//-----------------------------------------------------------------------------
+void Position::pack(uint8_t* data) const
+{
+    std::memset(data, 0, PACKED_POSITION_SIZE);
+
+    Bitboard occupied = pieces();
+    for (int i = 0; i < 8; i++)
+        data[i] = static_cast<uint8_t>(occupied >> (i * 8));
+
+    // a position never holds more than 32 pieces as every side has one king
+    // and promotions only replace pawns
+    int index = 0;
+    while (occupied && index < 32)
+    {
+        int piece = m_squares[popLsb(occupied)];
+        data[8 + index / 2] |= static_cast<uint8_t>(piece << ((index & 1) * 4));
+        index++;
+    }
+
+    data[24] = static_cast<uint8_t>(m_sideToMove);
+    data[25] = m_castling;
+    data[26] = (m_epSquare == NO_SQUARE) ? 0xFF : static_cast<uint8_t>(m_epSquare);
+    data[27] = m_rule50;
+    data[28] = static_cast<uint8_t>(m_fullMove);
+    data[29] = static_cast<uint8_t>(m_fullMove >> 8);
+}
+
+//-----------------------------------------------------------------------------
+// Name : unpack ()
+//-----------------------------------------------------------------------------
+bool Position::unpack(const uint8_t* data)
+{
+    clear();
+
+    Bitboard occupied = 0;
+    for (int i = 0; i < 8; i++)
+        occupied |= static_cast<Bitboard>(data[i]) << (i * 8);
+
+    if (popCount(occupied) > 32)
+        return false;
+
+    int index = 0;
+    while (occupied)
+    {
+        int square = popLsb(occupied);
+        int piece = (data[8 + index / 2] >> ((index & 1) * 4)) & 0xF;
+        index++;
+
+        int type = pieceType(piece);
+        if (type < PAWN || type > KING)
+            return false;
+
+        putPiece(pieceSide(piece), type, square);
+    }
+
+    if (!isValid() || data[24] > BOTTOM)
+        return false;
+
+    int epSquare = (data[26] < SQUARE_NB) ? data[26] : NO_SQUARE;
+    int fullMove = data[28] | (data[29] << 8);
+    if (epSquare != NO_SQUARE && !isValidEnPassant(data[24], epSquare))
+        return false;
+
+    setState(data[24], supportedCastling(data[25] & ALL_CASTLING), epSquare, data[27], fullMove);
+    return !isSquareAttacked(kingSquare(1 - data[24]), data[24]);
+}
+
+//-----------------------------------------------------------------------------
+// Name : toFEN ()
+//-----------------------------------------------------------------------------
+std::string Position::toFEN() const
+{
+    std::string fen;
+
+    for (int col = 0; col < boardY; col++)
+    {
+        int empty = 0;
+        for (int row = 0; row < boardX; row++)
+        {
+            int piece = m_squares[makeSquare(row, col)];
+            if (piece == NO_PIECE)
+            {
+                empty++;
+                continue;
+            }
+
+            if (empty)
+                fen += static_cast<char>('0' + empty);
+            empty = 0;
+
+            char c = PieceChars[pieceType(piece)];
+            fen += (pieceSide(piece) == BOTTOM) ? static_cast<char>(c - 'a' + 'A') : c;
+        }
+
+        if (empty)
+            fen += static_cast<char>('0' + empty);
+        if (col != boardY - 1)
+            fen += '/';
+    }
+
+    fen += (m_sideToMove == BOTTOM) ? " w " : " b ";
+
+    if (m_castling == NO_CASTLING)
+        fen += '-';
+    if (m_castling & WHITE_OO)
+        fen += 'K';
+    if (m_castling & WHITE_OOO)
+        fen += 'Q';
+    if (m_castling & BLACK_OO)
+        fen += 'k';
+    if (m_castling & BLACK_OOO)
+        fen += 'q';
+
+    fen += ' ';
+    fen += (m_epSquare == NO_SQUARE) ? std::string("-") : squareToString(m_epSquare);
+
+    std::ostringstream counters;
+    counters << ' ' << static_cast<int>(m_rule50) << ' ' << m_fullMove;
+    return fen + counters.str();
+}
+
+//-----------------------------------------------------------------------------
+// Name : putPiece ()
+//-----------------------------------------------------------------------------
+void Position::putPiece(int side, int type, int square)
+{
+    if (m_squares[square] != NO_PIECE)
+        removePiece(square);
+
+    addPiece(makePiece(side, type), square);
+}
+
+//-----------------------------------------------------------------------------
+// Name : setState ()
+//-----------------------------------------------------------------------------
+void Position::setState(int sideToMove, int castlingRights, int epSquare, int rule50, int fullMove)
+{
+    if (m_sideToMove == BOTTOM)
+        m_key ^= Zobrist::sideToMove;
+    m_key ^= Zobrist::castling[m_castling];
+    if (m_epSquare != NO_SQUARE)
+        m_key ^= Zobrist::enPassant[squareRow(m_epSquare)];
+
+    m_sideToMove = static_cast<int8_t>(sideToMove);
+    m_castling = static_cast<uint8_t>(castlingRights);
+    m_epSquare = NO_SQUARE;
+    m_rule50 = static_cast<uint8_t>(rule50);
+    m_fullMove = static_cast<uint16_t>(fullMove > 0 ? fullMove : 1);
+
+    if (m_sideToMove == BOTTOM)
+        m_key ^= Zobrist::sideToMove;
+    m_key ^= Zobrist::castling[m_castling];
+
+    if (epSquare != NO_SQUARE)
+        updateEnPassant(epSquare);
+}
+
+//-----------------------------------------------------------------------------
+// Name : updateEnPassant ()
+// Desc : sets the en passant square only when a pawn can actually capture
+//        there so that transpositions get the same key
+//-----------------------------------------------------------------------------
+void Position::updateEnPassant(int square)
+{
+    if (Attacks::pawn(1 - m_sideToMove, square) & pieces(m_sideToMove, PAWN))
+    {
+        m_epSquare = static_cast<int8_t>(square);
+        m_key ^= Zobrist::enPassant[squareRow(square)];
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : addPiece ()
+//-----------------------------------------------------------------------------
+void Position::addPiece(int piece, int square)
+{
+    int side = pieceSide(piece);
+    int type = pieceType(piece);
+
+    m_squares[square] = static_cast<int8_t>(piece);
+    m_byType[type] |= squareBB(square);
+    m_bySide[side] |= squareBB(square);
+
+    m_key ^= Zobrist::pieces[side][type][square];
+    if (type == PAWN)
+        m_pawnKey ^= Zobrist::pieces[side][type][square];
+}
+
+//-----------------------------------------------------------------------------
+// Name : removePiece ()
+//-----------------------------------------------------------------------------
+void Position::removePiece(int square)
+{
+    int piece = m_squares[square];
+    int side = pieceSide(piece);
+    int type = pieceType(piece);
+
+    m_squares[square] = NO_PIECE;
+    m_byType[type] ^= squareBB(square);
+    m_bySide[side] ^= squareBB(square);
+
+    m_key ^= Zobrist::pieces[side][type][square];
+    if (type == PAWN)
+        m_pawnKey ^= Zobrist::pieces[side][type][square];
+}
+
+//-----------------------------------------------------------------------------
+// Name : movePiece ()
+//-----------------------------------------------------------------------------
+void Position::movePiece(int from, int to)
+{
+    int piece = m_squares[from];
+    int side = pieceSide(piece);
+    int type = pieceType(piece);
+    Bitboard fromTo = squareBB(from) | squareBB(to);
+
+    m_squares[to] = static_cast<int8_t>(piece);
+    m_squares[from] = NO_PIECE;
+    m_byType[type] ^= fromTo;
+    m_bySide[side] ^= fromTo;
+
+    uint64_t keyDelta = Zobrist::pieces[side][type][from] ^ Zobrist::pieces[side][type][to];
+    m_key ^= keyDelta;
+    if (type == PAWN)
+        m_pawnKey ^= keyDelta;
+}
+
+//-----------------------------------------------------------------------------
+// Name : generateMoves ()
+// Desc : generates all the pseudo legal moves, moves may leave the king in check
+//-----------------------------------------------------------------------------
+void Position::generateMoves(MoveList& moveList) const
+{
+    int us = m_sideToMove;
+    int them = 1 - us;
+    Bitboard occupied = pieces();
+    Bitboard targets = ~m_bySide[us];
+    int forward = (us == BOTTOM) ? -boardX : boardX;
+
+    // pawns
+    Bitboard pawns = pieces(us, PAWN);
+    while (pawns)
+    {
+        int from = popLsb(pawns);
+        int to = from + forward;
+        bool promotion = relativeRank(us, from) == 6;
+
+        if (!(occupied & squareBB(to)))
+        {
+            if (promotion)
+            {
+                for (int type = QUEEN; type >= KNIGHT; type--)
+                    moveList.add(makePromotion(from, to, type));
+            }
+            else
+            {
+                moveList.add(makeMove(from, to));
+                if (relativeRank(us, from) == 1 && !(occupied & squareBB(to + forward)))
+                    moveList.add(makeMove(from, to + forward));
+            }
+        }
+
+        Bitboard captures = Attacks::pawn(us, from) & m_bySide[them];
+        while (captures)
+        {
+            int target = popLsb(captures);
+            if (promotion)
+            {
+                for (int type = QUEEN; type >= KNIGHT; type--)
+                    moveList.add(makePromotion(from, target, type));
+            }
+            else
+                moveList.add(makeMove(from, target));
+        }
+
+        if (m_epSquare != NO_SQUARE && (Attacks::pawn(us, from) & squareBB(m_epSquare)))
+            moveList.add(makeMove(from, m_epSquare, EN_PASSANT_MOVE));
+    }
+
+    // pieces
+    for (int type = KNIGHT; type <= KING; type++)
+    {
+        Bitboard curPieces = pieces(us, type);
+        while (curPieces)
+        {
+            int from = popLsb(curPieces);
+            Bitboard attacks = Attacks::pieceAttacks(type, from, occupied) & targets;
+            while (attacks)
+                moveList.add(makeMove(from, popLsb(attacks)));
+        }
+    }
+
+    // castling, the king may not be in check or pass through an attacked square
+    if (m_castling && !inCheck())
+    {
+        for (const CastlingInfo& info : Castlings)
+        {
+            if (!(m_castling & info.right) || m_squares[info.kingFrom] != makePiece(us, KING))
+                continue;
+
+            Bitboard path = 0;
+            int step = (info.rookFrom > info.kingFrom) ? 1 : -1;
+            for (int square = info.kingFrom + step; square != info.rookFrom; square += step)
+                path |= squareBB(square);
+
+            if (path & occupied)
+                continue;
+
+            if (isSquareAttacked(info.kingFrom + step, them) || isSquareAttacked(info.kingTo, them))
+                continue;
+
+            moveList.add(makeMove(info.kingFrom, info.kingTo, CASTLING_MOVE));
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : generateCaptures ()
+// Desc : generates the pseudo legal captures and queen promotions
+//-----------------------------------------------------------------------------
+void Position::generateCaptures(MoveList& moveList) const
+{
+    int us = m_sideToMove;
+    int them = 1 - us;
+    Bitboard occupied = pieces();
+    int forward = (us == BOTTOM) ? -boardX : boardX;
+
+    Bitboard pawns = pieces(us, PAWN);
+    while (pawns)
+    {
+        int from = popLsb(pawns);
+        bool promotion = relativeRank(us, from) == 6;
+
+        if (promotion && !(occupied & squareBB(from + forward)))
+            moveList.add(makePromotion(from, from + forward, QUEEN));
+
+        Bitboard captures = Attacks::pawn(us, from) & m_bySide[them];
+        while (captures)
+        {
+            int target = popLsb(captures);
+            if (promotion)
+                moveList.add(makePromotion(from, target, QUEEN));
+            else
+                moveList.add(makeMove(from, target));
+        }
+
+        if (m_epSquare != NO_SQUARE && (Attacks::pawn(us, from) & squareBB(m_epSquare)))
+            moveList.add(makeMove(from, m_epSquare, EN_PASSANT_MOVE));
+    }
+
+    for (int type = KNIGHT; type <= KING; type++)
+    {
+        Bitboard curPieces = pieces(us, type);
+        while (curPieces)
+        {
+            int from = popLsb(curPieces);
+            Bitboard attacks = Attacks::pieceAttacks(type, from, occupied) & m_bySide[them];
+            while (attacks)
+                moveList.add(makeMove(from, popLsb(attacks)));
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : generateLegalMoves ()
+//-----------------------------------------------------------------------------
+void Position::generateLegalMoves(MoveList& moveList) const
+{
+    MoveList pseudoLegal;
+    generateMoves(pseudoLegal);
+
+    for (int i = 0; i < pseudoLegal.size; i++)
+        if (isLegal(pseudoLegal.moves[i]))
+            moveList.add(pseudoLegal.moves[i]);
+}
+
+//-----------------------------------------------------------------------------
+// Name : isLegal ()
+// Desc : checks that a pseudo legal move does not leave the king in check
+//-----------------------------------------------------------------------------
+bool Position::isLegal(Move move) const
+{
+    // the castling path was already checked by the generator
+    if (moveType(move) == CASTLING_MOVE)
+        return true;
+
+    int us = m_sideToMove;
+    int from = moveFrom(move);
+    int to = moveTo(move);
+
+    Bitboard occupied = (pieces() ^ squareBB(from)) | squareBB(to);
+    Bitboard captured = squareBB(to);
+
+    if (moveType(move) == EN_PASSANT_MOVE)
+    {
+        int capturedSquare = (us == BOTTOM) ? to + boardX : to - boardX;
+        occupied ^= squareBB(capturedSquare);
+        captured = squareBB(capturedSquare);
+    }
+
+    int kingSq = (pieceType(m_squares[from]) == KING) ? to : kingSquare(us);
+    return !(attackersTo(kingSq, occupied) & m_bySide[1 - us] & ~captured);
+}
+
+//-----------------------------------------------------------------------------
+// Name : isPseudoLegal ()
+// Desc : used to verify moves coming from the hash table, which may belong to
+//        another position with the same hash index
+//-----------------------------------------------------------------------------
+bool Position::isPseudoLegal(Move move) const
+{
+    if (move == MOVE_NONE || move == MOVE_NULL)
+        return false;
+
+    int piece = m_squares[moveFrom(move)];
+    if (piece == NO_PIECE || pieceSide(piece) != m_sideToMove)
+        return false;
+
+    MoveList moveList;
+    generateMoves(moveList);
+    return moveList.contains(move);
+}
+
+//-----------------------------------------------------------------------------
+// Name : hasLegalMove ()
+//-----------------------------------------------------------------------------
+bool Position::hasLegalMove() const
+{
+    MoveList moveList;
+    generateMoves(moveList);
+
+    for (int i = 0; i < moveList.size; i++)
+        if (isLegal(moveList.moves[i]))
+            return true;
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// Name : parseMove ()
+// Desc : converts a uci move string to a legal move or MOVE_NONE
+//-----------------------------------------------------------------------------
+Move Position::parseMove(const std::string& moveString) const
+{
+    MoveList moveList;
+    generateLegalMoves(moveList);
+
+    std::string lowered = moveString;
+    if (lowered.size() == 5)
+        lowered[4] = static_cast<char>(lowered[4] | 0x20);
+
+    for (int i = 0; i < moveList.size; i++)
+        if (moveToString(moveList.moves[i]) == lowered)
+            return moveList.moves[i];
+
+    return MOVE_NONE;
+}
+
+//-----------------------------------------------------------------------------
+// Name : doMove ()
+//-----------------------------------------------------------------------------
+void Position::doMove(Move move, UndoInfo& undo)
+{
+    undo.key = m_key;
+    undo.pawnKey = m_pawnKey;
+    undo.castling = m_castling;
+    undo.epSquare = m_epSquare;
+    undo.rule50 = m_rule50;
+    undo.captured = NO_PIECE;
+
+    int us = m_sideToMove;
+    int from = moveFrom(move);
+    int to = moveTo(move);
+    int movedType = pieceType(m_squares[from]);
+
+    m_rule50++;
+    if (m_epSquare != NO_SQUARE)
+    {
+        m_key ^= Zobrist::enPassant[squareRow(m_epSquare)];
+        m_epSquare = NO_SQUARE;
+    }
+
+    if (moveType(move) == CASTLING_MOVE)
+    {
+        const CastlingInfo* info = findCastling(move);
+        movePiece(info->kingFrom, info->kingTo);
+        movePiece(info->rookFrom, info->rookTo);
+    }
+    else
+    {
+        int capturedSquare = to;
+        if (moveType(move) == EN_PASSANT_MOVE)
+            capturedSquare = (us == BOTTOM) ? to + boardX : to - boardX;
+
+        undo.captured = m_squares[capturedSquare];
+        if (undo.captured != NO_PIECE)
+        {
+            removePiece(capturedSquare);
+            m_rule50 = 0;
+        }
+
+        movePiece(from, to);
+
+        if (movedType == PAWN)
+        {
+            m_rule50 = 0;
+
+            if (moveType(move) == PROMOTION_MOVE)
+            {
+                removePiece(to);
+                addPiece(makePiece(us, promotionType(move)), to);
+            }
+        }
+    }
+
+    int lostRights = castlingMask(from) | castlingMask(to);
+    if (m_castling & lostRights)
+    {
+        m_key ^= Zobrist::castling[m_castling];
+        m_castling &= ~lostRights;
+        m_key ^= Zobrist::castling[m_castling];
+    }
+
+    if (us == UPPER)
+        m_fullMove++;
+
+    m_sideToMove = static_cast<int8_t>(1 - us);
+    m_key ^= Zobrist::sideToMove;
+
+    if (movedType == PAWN && (to - from == 2 * boardX || from - to == 2 * boardX))
+        updateEnPassant((from + to) / 2);
+}
+
+//-----------------------------------------------------------------------------
+// Name : undoMove ()
+//-----------------------------------------------------------------------------
+void Position::undoMove(Move move, const UndoInfo& undo)
+{
+    m_sideToMove = static_cast<int8_t>(1 - m_sideToMove);
+    int us = m_sideToMove;
+    int from = moveFrom(move);
+    int to = moveTo(move);
+
+    if (moveType(move) == CASTLING_MOVE)
+    {
+        const CastlingInfo* info = findCastling(move);
+        movePiece(info->rookTo, info->rookFrom);
+        movePiece(info->kingTo, info->kingFrom);
+    }
+    else
+    {
+        if (moveType(move) == PROMOTION_MOVE)
+        {
+            removePiece(to);
+            addPiece(makePiece(us, PAWN), to);
+        }
+
+        movePiece(to, from);
+
+        if (undo.captured != NO_PIECE)
+        {
+            int capturedSquare = to;
+            if (moveType(move) == EN_PASSANT_MOVE)
+                capturedSquare = (us == BOTTOM) ? to + boardX : to - boardX;
+            addPiece(undo.captured, capturedSquare);
+        }
+    }
+
+    if (us == UPPER)
+        m_fullMove--;
+
+    m_key = undo.key;
+    m_pawnKey = undo.pawnKey;
+    m_castling = undo.castling;
+    m_epSquare = undo.epSquare;
+    m_rule50 = undo.rule50;
+}
+
+//-----------------------------------------------------------------------------
+// Name : doNullMove ()
+//-----------------------------------------------------------------------------
+void Position::doNullMove(UndoInfo& undo)
+{
+    undo.key = m_key;
+    undo.pawnKey = m_pawnKey;
+    undo.castling = m_castling;
+    undo.epSquare = m_epSquare;
+    undo.rule50 = m_rule50;
+    undo.captured = NO_PIECE;
+
+    if (m_epSquare != NO_SQUARE)
+    {
+        m_key ^= Zobrist::enPassant[squareRow(m_epSquare)];
+        m_epSquare = NO_SQUARE;
+    }
+
+    m_rule50++;
+    m_sideToMove = static_cast<int8_t>(1 - m_sideToMove);
+    m_key ^= Zobrist::sideToMove;
+}
+
+//-----------------------------------------------------------------------------
+// Name : undoNullMove ()
+//-----------------------------------------------------------------------------
+void Position::undoNullMove(const UndoInfo& undo)
+{
+    m_sideToMove = static_cast<int8_t>(1 - m_sideToMove);
+    m_key = undo.key;
+    m_epSquare = undo.epSquare;
+    m_rule50 = undo.rule50;
+}
+
+//-----------------------------------------------------------------------------
+// Name : attackersTo ()
+// Desc : returns the pieces of both sides that attack the square
+//-----------------------------------------------------------------------------
+Bitboard Position::attackersTo(int square, Bitboard occupied) const
+{
+    Bitboard bishopsQueens = m_byType[BISHOP] | m_byType[QUEEN];
+    Bitboard rooksQueens   = m_byType[ROOK]   | m_byType[QUEEN];
+
+    return (Attacks::pawn(BOTTOM, square) & pieces(UPPER, PAWN))
+         | (Attacks::pawn(UPPER, square)  & pieces(BOTTOM, PAWN))
+         | (Attacks::knight(square) & m_byType[KNIGHT])
+         | (Attacks::king(square)   & m_byType[KING])
+         | (Attacks::bishop(square, occupied) & bishopsQueens)
+         | (Attacks::rook(square, occupied)   & rooksQueens);
+}
+
+//-----------------------------------------------------------------------------
+// Name : isSquareAttacked ()
+//-----------------------------------------------------------------------------
+bool Position::isSquareAttacked(int square, int bySide) const
+{
+    return (attackersTo(square, pieces()) & m_bySide[bySide]) != 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : inCheck ()
+//-----------------------------------------------------------------------------
+bool Position::inCheck() const
+{
+    return isSquareAttacked(kingSquare(m_sideToMove), 1 - m_sideToMove);
+}
+
+//-----------------------------------------------------------------------------
+// Name : checkers ()
+//-----------------------------------------------------------------------------
+Bitboard Position::checkers() const
+{
+    return attackersTo(kingSquare(m_sideToMove), pieces()) & m_bySide[1 - m_sideToMove];
+}
+
+//-----------------------------------------------------------------------------
+// Name : isCapture ()
+//-----------------------------------------------------------------------------
+bool Position::isCapture(Move move) const
+{
+    return (m_squares[moveTo(move)] != NO_PIECE && moveType(move) != CASTLING_MOVE) ||
+           moveType(move) == EN_PASSANT_MOVE;
+}
+
+//-----------------------------------------------------------------------------
+// Name : capturedPiece ()
+//-----------------------------------------------------------------------------
+int Position::capturedPiece(Move move) const
+{
+    if (moveType(move) == EN_PASSANT_MOVE)
+        return makePiece(1 - m_sideToMove, PAWN);
+    if (moveType(move) == CASTLING_MOVE)
+        return NO_PIECE;
+
+    return m_squares[moveTo(move)];
+}
+
+//-----------------------------------------------------------------------------
+// Name : hasNonPawnMaterial ()
+//-----------------------------------------------------------------------------
+bool Position::hasNonPawnMaterial(int side) const
+{
+    return (m_bySide[side] & ~m_byType[PAWN] & ~m_byType[KING]) != 0;
+}
@@ -0,0 +1,175 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _POSITION_H_
+#define _POSITION_H_
+
+#include <string>
+#include <type_traits>
+#include "Bitboard.h"
+#include "Move.h"
+
+enum CastlingRights
+{
+    NO_CASTLING  = 0,
+    WHITE_OO     = 1,
+    WHITE_OOO    = 2,
+    BLACK_OO     = 4,
+    BLACK_OOO    = 8,
+    ALL_CASTLING = 15
+};
+
+// a piece on a Position square, 0 is an empty square
+const int NO_PIECE = 0;
+
+inline int makePiece(int side, int type)
+{
+    return (side << 3) | (type + 1);
+}
+
+inline int pieceType(int piece)
+{
+    return (piece & 7) - 1;
+}
+
+inline int pieceSide(int piece)
+{
+    return piece >> 3;
+}
+
+// size of Position::pack(), the pieces take 4 bits each after an occupancy mask
+const int PACKED_POSITION_SIZE = 32;
+
+// everything doMove() can not recompute when taking the move back
+struct UndoInfo
+{
+    uint64_t key;
+    uint64_t pawnKey;
+    int8_t   captured;
+    uint8_t  castling;
+    int8_t   epSquare;
+    uint8_t  rule50;
+};
+
+// a chess position as the engine sees it.
+// unlike board it holds no pointers and no ui state so it can be copied
+// freely between threads. it follows the standard chess rules including
+// en passant and castling to the c/g files
+class Position
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    Position();
+
+    void clear();
+    void setStartPosition();
+    // fails on any position that can not come up in a game : ranks that are
+    // not 8 squares, pawns on the back ranks, an en passant square no double
+    // push left behind or the side that just moved in check
+    bool setFromFEN(const std::string& fen);
+    std::string toFEN() const;
+
+    // fixed size little endian snapshot, unpack() validates like setFromFEN()
+    void pack  (uint8_t* data) const;
+    bool unpack(const uint8_t* data);
+
+    // build a position piece by piece, setState() must be called last
+    void putPiece(int side, int type, int square);
+    void setState(int sideToMove, int castlingRights, int epSquare, int rule50, int fullMove);
+
+    //-------------------------------------------------------------------------
+    // Functions that generate and validate moves
+    //-------------------------------------------------------------------------
+    void generateMoves     (MoveList& moveList) const;
+    void generateCaptures  (MoveList& moveList) const;
+    void generateLegalMoves(MoveList& moveList) const;
+    bool isLegal      (Move move) const;
+    bool isPseudoLegal(Move move) const;
+    bool hasLegalMove () const;
+    Move parseMove    (const std::string& moveString) const;
+
+    //-------------------------------------------------------------------------
+    // Functions that make and take back moves
+    //-------------------------------------------------------------------------
+    void doMove      (Move move, UndoInfo& undo);
+    void undoMove    (Move move, const UndoInfo& undo);
+    void doNullMove  (UndoInfo& undo);
+    void undoNullMove(const UndoInfo& undo);
+
+    //-------------------------------------------------------------------------
+    // Functions that detect attacks on squares
+    //-------------------------------------------------------------------------
+    Bitboard attackersTo    (int square, Bitboard occupied) const;
+    bool     isSquareAttacked(int square, int bySide) const;
+    bool     inCheck        () const;
+    Bitboard checkers       () const;
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    int      pieceOn(int square) const          { return m_squares[square]; }
+    Bitboard pieces() const                     { return m_bySide[UPPER] | m_bySide[BOTTOM]; }
+    Bitboard pieces(int side) const             { return m_bySide[side]; }
+    Bitboard pieces(int side, int type) const   { return m_bySide[side] & m_byType[type]; }
+    Bitboard piecesOfType(int type) const       { return m_byType[type]; }
+    int      kingSquare(int side) const         { return lsb(pieces(side, KING)); }
+
+    int      sideToMove() const                 { return m_sideToMove; }
+    int      castlingRights() const             { return m_castling; }
+    int      epSquare() const                   { return m_epSquare; }
+    int      rule50() const                     { return m_rule50; }
+    int      fullMoveNumber() const             { return m_fullMove; }
+    uint64_t key() const                        { return m_key; }
+    uint64_t pawnKey() const                    { return m_pawnKey; }
+
+    bool     isCapture(Move move) const;
+    int      capturedPiece(Move move) const;
+    bool     hasNonPawnMaterial(int side) const;
+
+private:
+    void addPiece   (int piece, int square);
+    void removePiece(int square);
+    void movePiece  (int from, int to);
+    void updateEnPassant(int square);
+    int  supportedCastling(int castlingRights) const;
+    // the pieces could stand like this in a game : a king per side and no
+    // pawn on the first or last rank
+    bool isValid() const;
+    bool isValidEnPassant(int sideToMove, int square) const;
+
+    int8_t   m_squares[SQUARE_NB];
+    Bitboard m_byType[KING + 1];
+    Bitboard m_bySide[2];
+    uint64_t m_key;
+    uint64_t m_pawnKey;
+    int8_t   m_sideToMove;  // UPPER(black) or BOTTOM(white)
+    uint8_t  m_castling;
+    int8_t   m_epSquare;
+    uint8_t  m_rule50;
+    uint16_t m_fullMove;
+};
+
+// the search copies a position per ply(copy-make) and every thread keeps its
+// own, so it has to stay a plain block of a few cache lines
+static_assert(std::is_trivially_copyable<Position>::value, "Position must be trivially copyable");
+static_assert(sizeof(Position) <= 192, "Position must fit in 3 cache lines");
+
+#endif // _POSITION_H_
@@ -0,0 +1,445 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PositionIndex.h"
+#include "Serialization.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    // bytes 0-3   "CPIX"
+    // bytes 4-5   format version
+    // bytes 6-7   reserved
+    // bytes 8-11  games covered
+    // bytes 12-15 reserved
+    // bytes 16-23 offset of the key table
+    // bytes 24-31 number of keys
+    // bytes 32-39 number of postings
+    const char     IndexMagic[4] = {'C', 'P', 'I', 'X'};
+    const uint16_t IndexVersion  = 1;
+    const int      HeaderSize    = 40;
+    const int      KeyEntrySize  = 16;
+
+    // games replayed by one task of the build
+    const uint32_t GamesPerTask  = 1024;
+
+    struct Posting
+    {
+        uint64_t key;
+        uint32_t gameId;
+        uint16_t ply;
+
+        bool operator<(const Posting& other) const
+        {
+            if (key != other.key)
+                return key < other.key;
+            if (gameId != other.gameId)
+                return gameId < other.gameId;
+            return ply < other.ply;
+        }
+    };
+
+    // keys are random so their high bits split them into even ranges, in
+    // increasing key order
+    uint64_t keyRange(uint64_t key, uint64_t rangeCount)
+    {
+        return ((key >> 32) * rangeCount) >> 32;
+    }
+
+    void writeVarint(std::vector<uint8_t>& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool readVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && data < end; shift += 7)
+        {
+            uint8_t byte = *data++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    //-------------------------------------------------------------------------
+    // adds the positions of a game whose key falls in the range being built.
+    // the games were checked when they were stored and their checksum holds,
+    // a full legality test would double the build time so the replay only
+    // stops on a move that does not move a piece of the side to move
+    //-------------------------------------------------------------------------
+    void collectPostings(uint32_t gameId, const StoredGame& game, uint64_t range, uint64_t rangeCount,
+                         std::vector<Posting>& postings)
+    {
+        Position pos = game.start;
+        UndoInfo undo;
+
+        for (size_t ply = 0; ; ply++)
+        {
+            uint64_t key = pos.key();
+            if (keyRange(key, rangeCount) == range)
+            {
+                Posting posting;
+                posting.key = key;
+                posting.gameId = gameId;
+                posting.ply = static_cast<uint16_t>(ply);
+                postings.push_back(posting);
+            }
+
+            if (ply == game.moves.size())
+                break;
+
+            Move move = game.moves[ply];
+            int piece = pos.pieceOn(moveFrom(move));
+            if (piece == NO_PIECE || pieceSide(piece) != pos.sideToMove())
+                break;
+
+            pos.doMove(move, undo);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : PositionIndex (constructor)
+//-----------------------------------------------------------------------------
+PositionIndex::PositionIndex()
+{
+    m_keys = nullptr;
+    m_keyCount = 0;
+    m_postingCount = 0;
+    m_gameCount = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : build ()
+// Desc : each range replays all the games. the workers collect the postings
+//        of the range in their own buffer and sort it, the buffers are then
+//        merged into the posting lists. the lists are written as the file
+//        body and the key table is kept aside and appended once complete
+//-----------------------------------------------------------------------------
+bool PositionIndex::build(const GameDatabase& database, const std::string& path, int threadCount, size_t memoryMB)
+{
+    uint32_t gameCount = database.getGameCount();
+
+    uint64_t estimatedPostings = 0;
+    for (uint32_t id = 0; id < gameCount; id++)
+        estimatedPostings += database.getEntry(id).plyCount + 1;
+
+    uint64_t budget = static_cast<uint64_t>(std::max<size_t>(memoryMB, 1)) << 20;
+    uint64_t rangeCount = std::max<uint64_t>(1, (estimatedPostings * sizeof(Posting) + budget - 1) / budget);
+
+    std::string tempPath = path + ".tmp";
+    std::string keysPath = path + ".keys.tmp";
+    std::ofstream out(tempPath.c_str(), std::ios::binary);
+    std::ofstream keysOut(keysPath.c_str(), std::ios::binary);
+    if (!out || !keysOut)
+        return false;
+
+    uint8_t header[HeaderSize] = {};
+    out.write(reinterpret_cast<const char*>(header), HeaderSize);
+
+    ThreadPool pool(threadCount);
+    std::vector<std::vector<Posting>> workerPostings(pool.getThreadCount());
+    std::atomic<bool> damaged(false);
+
+    uint64_t offset = HeaderSize;
+    uint64_t keyCount = 0;
+    uint64_t postingCount = 0;
+    std::vector<uint8_t> list;
+
+    for (uint64_t range = 0; range < rangeCount; range++)
+    {
+        //----------------------------------------------------------------
+        // replay the games and sort the postings of the range
+        //----------------------------------------------------------------
+        for (size_t i = 0; i < workerPostings.size(); i++)
+            workerPostings[i].clear();
+
+        for (uint32_t first = 0; first < gameCount; first += GamesPerTask)
+        {
+            pool.submit([&, first, range](int worker)
+            {
+                uint32_t last = std::min(gameCount, first + GamesPerTask);
+                StoredGame game;
+
+                for (uint32_t id = first; id < last; id++)
+                {
+                    if (database.readGame(id, game))
+                        collectPostings(id, game, range, rangeCount, workerPostings[worker]);
+                    else
+                        damaged = true;
+                }
+            });
+        }
+        pool.wait();
+
+        for (size_t i = 0; i < workerPostings.size(); i++)
+        {
+            std::vector<Posting>* postings = &workerPostings[i];
+            pool.submit([postings](int) { std::sort(postings->begin(), postings->end()); });
+        }
+        pool.wait();
+
+        //----------------------------------------------------------------
+        // merge the worker buffers into one list per key
+        //----------------------------------------------------------------
+        std::vector<size_t> heads(workerPostings.size(), 0);
+        std::vector<Posting> keyPostings;
+
+        for (;;)
+        {
+            int best = -1;
+            for (size_t i = 0; i < workerPostings.size(); i++)
+            {
+                if (heads[i] < workerPostings[i].size() &&
+                    (best < 0 || workerPostings[i][heads[i]] < workerPostings[best][heads[best]]))
+                    best = static_cast<int>(i);
+            }
+
+            if (!keyPostings.empty() && (best < 0 || workerPostings[best][heads[best]].key != keyPostings[0].key))
+            {
+                list.clear();
+                writeVarint(list, keyPostings.size());
+
+                uint32_t prevGame = 0;
+                for (size_t i = 0; i < keyPostings.size(); i++)
+                {
+                    writeVarint(list, keyPostings[i].gameId - prevGame);
+                    writeVarint(list, keyPostings[i].ply);
+                    prevGame = keyPostings[i].gameId;
+                }
+
+                uint8_t keyEntry[KeyEntrySize];
+                writeLE64(keyEntry, keyPostings[0].key);
+                writeLE64(keyEntry + 8, offset);
+                keysOut.write(reinterpret_cast<const char*>(keyEntry), KeyEntrySize);
+                out.write(reinterpret_cast<const char*>(list.data()), list.size());
+
+                offset += list.size();
+                keyCount++;
+                postingCount += keyPostings.size();
+                keyPostings.clear();
+            }
+
+            if (best < 0)
+                break;
+
+            keyPostings.push_back(workerPostings[best][heads[best]++]);
+        }
+
+        // give the memory of the range back before the next one
+        for (size_t i = 0; i < workerPostings.size(); i++)
+            std::vector<Posting>().swap(workerPostings[i]);
+    }
+
+    //----------------------------------------------------------------
+    // append the key table and fill in the header
+    //----------------------------------------------------------------
+    keysOut.close();
+    std::ifstream keysIn(keysPath.c_str(), std::ios::binary);
+    std::vector<char> buffer(1 << 20);
+    while (keysIn.read(buffer.data(), buffer.size()) || keysIn.gcount() > 0)
+        out.write(buffer.data(), keysIn.gcount());
+    keysIn.close();
+    std::remove(keysPath.c_str());
+
+    std::memcpy(header, IndexMagic, 4);
+    writeLE16(header + 4, IndexVersion);
+    writeLE32(header + 8, gameCount);
+    writeLE64(header + 16, offset);
+    writeLE64(header + 24, keyCount);
+    writeLE64(header + 32, postingCount);
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(header), HeaderSize);
+    out.close();
+
+    if (!out || damaged)
+    {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    std::remove(path.c_str());
+    return std::rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : open ()
+//-----------------------------------------------------------------------------
+bool PositionIndex::open(const std::string& path)
+{
+    close();
+
+    if (!m_file.open(path))
+        return false;
+
+    const uint8_t* data = m_file.data();
+    size_t size = m_file.size();
+    if (size < HeaderSize || std::memcmp(data, IndexMagic, 4) != 0 || readLE16(data + 4) != IndexVersion)
+    {
+        close();
+        return false;
+    }
+
+    uint64_t keyTable = readLE64(data + 16);
+    uint64_t keyCount = readLE64(data + 24);
+    if (keyTable < HeaderSize || keyTable > size || (size - keyTable) / KeyEntrySize != keyCount ||
+        (size - keyTable) % KeyEntrySize != 0)
+    {
+        close();
+        return false;
+    }
+
+    m_keys = data + keyTable;
+    m_keyCount = keyCount;
+    m_gameCount = readLE32(data + 8);
+    m_postingCount = readLE64(data + 32);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : close ()
+//-----------------------------------------------------------------------------
+void PositionIndex::close()
+{
+    m_file.close();
+    m_keys = nullptr;
+    m_keyCount = 0;
+    m_postingCount = 0;
+    m_gameCount = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : find ()
+//-----------------------------------------------------------------------------
+bool PositionIndex::find(uint64_t key, std::vector<PositionHit>& hits) const
+{
+    hits.clear();
+    if (m_keys == nullptr)
+        return false;
+
+    uint64_t first = 0;
+    uint64_t count = m_keyCount;
+    while (count > 0)
+    {
+        uint64_t step = count / 2;
+        if (readLE64(m_keys + (first + step) * KeyEntrySize) < key)
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+            count = step;
+    }
+
+    if (first == m_keyCount || readLE64(m_keys + first * KeyEntrySize) != key)
+        return false;
+
+    const uint8_t* data = m_file.data() + readLE64(m_keys + first * KeyEntrySize + 8);
+    const uint8_t* end = m_keys;
+
+    uint64_t postings;
+    if (!readVarint(data, end, postings))
+        return false;
+
+    hits.reserve(static_cast<size_t>(std::min<uint64_t>(postings, end - data)));
+    uint64_t gameId = 0;
+    for (uint64_t i = 0; i < postings; i++)
+    {
+        uint64_t gameDelta, ply;
+        if (!readVarint(data, end, gameDelta) || !readVarint(data, end, ply))
+            return false;
+
+        gameId += gameDelta;
+        PositionHit hit;
+        hit.gameId = static_cast<uint32_t>(gameId);
+        hit.ply = static_cast<uint16_t>(ply);
+        hits.push_back(hit);
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : find ()
+//-----------------------------------------------------------------------------
+bool PositionIndex::find(const Position& pos, std::vector<PositionHit>& hits) const
+{
+    return find(pos.key(), hits);
+}
+
+//-----------------------------------------------------------------------------
+// Name : find ()
+//-----------------------------------------------------------------------------
+bool PositionIndex::find(const std::string& fen, std::vector<PositionHit>& hits) const
+{
+    Position pos;
+    if (!pos.setFromFEN(fen))
+    {
+        hits.clear();
+        return false;
+    }
+
+    return find(pos.key(), hits);
+}
+
+//-----------------------------------------------------------------------------
+// Name : isOpen ()
+//-----------------------------------------------------------------------------
+bool PositionIndex::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+//-----------------------------------------------------------------------------
+// Name : getGameCount ()
+//-----------------------------------------------------------------------------
+uint32_t PositionIndex::getGameCount() const
+{
+    return m_gameCount;
+}
+
+//-----------------------------------------------------------------------------
+// Name : getKeyCount ()
+//-----------------------------------------------------------------------------
+uint64_t PositionIndex::getKeyCount() const
+{
+    return m_keyCount;
+}
+
+//-----------------------------------------------------------------------------
+// Name : getPostingCount ()
+//-----------------------------------------------------------------------------
+uint64_t PositionIndex::getPostingCount() const
+{
+    return m_postingCount;
+}
@@ -0,0 +1,92 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _POSITIONINDEX_H_
+#define _POSITIONINDEX_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "MappedFile.h"
+#include "GameDatabase.h"
+
+// a game that reached an indexed position, ply is the number of moves
+// played from the start of the game to it
+struct PositionHit
+{
+    uint32_t gameId;
+    uint16_t ply;
+};
+
+// finds the games of a game database that went through a position.
+// the index maps every Position::key() reached in the games to a posting
+// list of (game id, ply), sorted by game id and delta compressed as varints.
+// the keys are a sorted table of key(8) offset(8) entries at the end of the
+// file, a query is a binary search of the mapped table followed by the
+// decoding of one list.
+// it is built by replaying every game on several threads, the keys are split
+// into as many ranges as it takes to keep the postings of a range within the
+// memory budget and the ranges are built one after the other.
+// games added to the database after the build are not covered
+class PositionIndex
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    PositionIndex();
+
+    PositionIndex(const PositionIndex&) = delete;
+    PositionIndex& operator=(const PositionIndex&) = delete;
+
+    // writes the index of the games the database has mapped, 0 threads uses
+    // one per hardware thread
+    static bool build(const GameDatabase& database, const std::string& path,
+                      int threadCount = 0, size_t memoryMB = s_defaultMemoryMB);
+
+    bool open (const std::string& path);
+    void close();
+
+    //-------------------------------------------------------------------------
+    // Functions that look up positions
+    //-------------------------------------------------------------------------
+    // the hits are sorted by game id, false when the position is not indexed
+    bool find(uint64_t key, std::vector<PositionHit>& hits) const;
+    bool find(const Position& pos, std::vector<PositionHit>& hits) const;
+    bool find(const std::string& fen, std::vector<PositionHit>& hits) const;
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    bool     isOpen         () const;
+    uint32_t getGameCount   () const;     // games covered by the index
+    uint64_t getKeyCount    () const;
+    uint64_t getPostingCount() const;
+
+    static const size_t s_defaultMemoryMB = 1024;
+
+private:
+    MappedFile     m_file;
+    const uint8_t* m_keys;
+    uint64_t       m_keyCount;
+    uint64_t       m_postingCount;
+    uint32_t       m_gameCount;
+};
+
+#endif // _POSITIONINDEX_H_
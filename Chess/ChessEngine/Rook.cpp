@@ -19,7 +19,6 @@
 //
 
 #include "Rook.h"
-#include <cmath>
 
 PIECES rook::type = ROOK;
 //-----------------------------------------------------------------------------
@@ -27,12 +26,7 @@ PIECES rook::type = ROOK;
 //-----------------------------------------------------------------------------
 rook::rook(int playerColor, BOARD_POINT _boardPoistion)
     :piece(playerColor, _boardPoistion)
-{
-    dx[0] = -1;
-    dx[1] =  2;
-    dy[0] = dx[0];
-    dy[1] = dx[1];
-}
+{}
 
 //-----------------------------------------------------------------------------
 // Name : Rook (destructor)
@@ -40,45 +34,6 @@ rook::rook(int playerColor, BOARD_POINT _boardPoistion)
 rook::~rook(void)
 {}
 
-//-----------------------------------------------------------------------------
-// Name : validateNewPos
-//-----------------------------------------------------------------------------
-bool rook::validateNewPos(int dx,int dy, BOARD_POINT startSqaure, BOARD_POINT targetSquare,piece * SBoard[boardY][boardX])
-{
-    if (dx == 0 && dy == 0)//if both dx and dy are 0 than there was no movement therefore move is illegal
-        return false;
-
-    if (dx * dy == 0)// if dx * dy = 0 it means we are moving horizontally or vertically
-    {
-        piece * targetPiece = SBoard[targetSquare.col][targetSquare.row];
-
-        DIR_VEC dirVec;
-        if (dx != 0)
-            dirVec.x = dx / std::abs(dx);
-        else
-            dirVec.x = 0;
-
-        if (dy != 0)
-            dirVec.y = dy / std::abs(dy);
-        else
-            dirVec.y = 0;
-
-        if (targetPiece != nullptr)//check if there is a piece on the target square
-        {
-            if (targetPiece->getColor() != this->getColor()) //check if it is belong to the other player so we can eat it 
-            {
-                return isPieceInWay(startSqaure,targetSquare,dirVec,SBoard);//check that there was no piece in the middle of the way
-            }
-        }
-        else//else square is empty just need to check that there was no piece in the middle of the way
-        {
-            return isPieceInWay(startSqaure,targetSquare,dirVec,SBoard);//check that there was no piece in the middle of the way
-        }
-    }
-    
-    return false;
-}
-
 //-----------------------------------------------------------------------------
 // Name : getType
 //-----------------------------------------------------------------------------
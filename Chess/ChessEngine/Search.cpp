@@ -0,0 +1,802 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Search.h"
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+    // move ordering scores, the hash move first then captures, killers and
+    // quiet moves by their history
+    const int TTMoveScore      = 1 << 30;
+    const int CaptureScore     = 1 << 28;
+    const int PromotionScore   = 1 << 27;
+    const int KillerScore      = 1 << 26;
+    const int HistoryMax       = 1 << 20;
+
+    // the iterations before this depth search the root with a full window
+    const int AspirationDepth  = 5;
+    const int AspirationWindow = 25;
+
+    // the null move is searched this much shallower than the real moves
+    const int NullMoveDepth     = 3;
+    const int NullMoveReduction = 3;
+    // with this few pieces besides the pawns and the king zugzwang is
+    // likely, a null move cutoff is verified by a shallow normal search
+    const int NullMoveVerifyPieces = 2;
+
+    // the first moves are searched to full depth, the later quiet ones
+    // reduced as the move ordering says they are unlikely to be best
+    const int LmrDepth      = 3;
+    const int LmrFullMoves  = 3;
+
+    // how much a quiet move may gain over the static evaluation by depth
+    const int FutilityDepth = 3;
+    const int FutilityMargin[FutilityDepth + 1] = {0, 150, 300, 500};
+
+    //-------------------------------------------------------------------------
+    // Name : previousScore ()
+    // Desc : the score the last complete iteration gave the best root move
+    //        the better lines have not taken yet, the line about to be
+    //        searched most likely starts with it
+    //-------------------------------------------------------------------------
+    int previousScore(const std::vector<SearchInfo>& lines, const std::vector<Move>& excludedMoves)
+    {
+        for (const SearchInfo& line : lines)
+            if (!line.pv.empty() && std::find(excludedMoves.begin(), excludedMoves.end(), line.pv[0]) == excludedMoves.end())
+                return line.score;
+
+        return lines.empty() ? 0 : lines.back().score;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : SearchInfo (constructor)
+//-----------------------------------------------------------------------------
+SearchInfo::SearchInfo()
+{
+    depth = 0;
+    selDepth = 0;
+    score = VALUE_NONE;
+    nodes = 0;
+    time = 0;
+    hashfull = 0;
+    multiPV = 1;
+}
+
+//-----------------------------------------------------------------------------
+// Name : SearchResult (constructor)
+//-----------------------------------------------------------------------------
+SearchResult::SearchResult()
+{
+    bestMove = MOVE_NONE;
+    ponderMove = MOVE_NONE;
+    score = VALUE_NONE;
+    depth = 0;
+    nodes = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : Search (constructor)
+//-----------------------------------------------------------------------------
+Search::Search(TranspositionTable& tt) : m_tt(tt)
+{
+    m_pos = &m_positions[0];
+    m_copyMake = false;
+    m_features = SEARCH_ALL_FEATURES;
+    m_multiPV = 1;
+    m_timeManager = nullptr;
+    m_rootBestMove = MOVE_NONE;
+    m_nodes = 0;
+    m_selDepth = 0;
+    m_stopped = false;
+    m_verifying = false;
+    clearHistory();
+}
+
+//-----------------------------------------------------------------------------
+// Name : think ()
+//-----------------------------------------------------------------------------
+SearchResult Search::think(const Position& root, const std::vector<uint64_t>& gameHistory,
+                           const SearchLimits& limits, TimeManager& timeManager)
+{
+    SearchResult result;
+
+    m_positions[0] = root;
+    m_pos = &m_positions[0];
+    m_timeManager = &timeManager;
+    m_keys = gameHistory;
+    m_keys.push_back(root.key());
+    m_nodes = 0;
+    m_stopped = false;
+    m_verifying = false;
+    std::memset(m_killers, 0, sizeof(m_killers));
+
+    MoveList rootMoves;
+    root.generateLegalMoves(rootMoves);
+    if (rootMoves.size == 0)
+        return result;
+
+    // always have something to play even if stopped right away
+    result.bestMove = rootMoves.moves[0];
+
+    int maxDepth = (limits.depth > 0 && limits.depth < MAX_PLY) ? limits.depth : MAX_PLY - 1;
+
+    // every line is searched with the moves of the better lines left out,
+    // the deeper lines find most of what they need in the hash the earlier
+    // ones filled. lines holds the last complete iteration, only it is
+    // reported, a cut iteration never mixes its lines with the older ones
+    int multiPV = std::min(m_multiPV, rootMoves.size);
+    std::vector<SearchInfo> lines;
+    std::vector<SearchInfo> depthLines;
+
+    int score = 0;
+    for (int depth = 1; depth <= maxDepth; depth++)
+    {
+        m_selDepth = 0;
+        m_excludedMoves.clear();
+        depthLines.clear();
+
+        while (static_cast<int>(depthLines.size()) < multiPV)
+        {
+            m_rootBestMove = MOVE_NONE;
+            int lineScore = aspiration(depth, previousScore(lines, m_excludedMoves));
+
+            if (m_stopped)
+                break;
+
+            SearchInfo curLine;
+            curLine.score = lineScore;
+            curLine.pv.assign(m_pv[0], m_pv[0] + m_pvLength[0]);
+            depthLines.push_back(curLine);
+            m_excludedMoves.push_back(m_pv[0][0]);
+
+            // a line searched without the better moves can still come out
+            // ahead of them, the pruning saw a different tree
+            std::stable_sort(depthLines.begin(), depthLines.end(),
+                             [](const SearchInfo& a, const SearchInfo& b) { return a.score > b.score; });
+        }
+
+        // the first line of a cut iteration is a complete search of every
+        // root move, it is played even though the other lines are not reported
+        if (!depthLines.empty())
+        {
+            score = depthLines[0].score;
+            result.bestMove = depthLines[0].pv[0];
+            result.ponderMove = (depthLines[0].pv.size() > 1) ? depthLines[0].pv[1] : MOVE_NONE;
+            result.score = score;
+            result.depth = depth;
+        }
+
+        if (m_stopped)
+        {
+            // the moves searched so far in the cut iteration include the
+            // previous best one, so a better move found there can be trusted
+            if (depthLines.empty() && m_rootBestMove != MOVE_NONE)
+                result.bestMove = m_rootBestMove;
+            break;
+        }
+
+        lines.swap(depthLines);
+
+        if (m_infoCallback)
+        {
+            for (int line = 0; line < multiPV; line++)
+            {
+                SearchInfo& info = lines[line];
+                info.depth = depth;
+                info.selDepth = m_selDepth;
+                info.nodes = m_nodes;
+                info.time = timeManager.getElapsed();
+                info.hashfull = m_tt.hashfull();
+                info.multiPV = line + 1;
+                m_infoCallback(info);
+            }
+        }
+
+        timeManager.onIterationComplete(depth, result.bestMove);
+
+        // a forced move needs no thinking when the clock is running
+        if (rootMoves.size == 1 && limits.useTimeManagement() && !timeManager.isPondering())
+            break;
+
+        // deeper iterations can not find a shorter mate than one already proven
+        if (!limits.infinite && !timeManager.isPondering() && isMateScore(score) && VALUE_MATE - std::abs(score) <= depth)
+            break;
+
+        if (!timeManager.shouldStartIteration())
+            break;
+    }
+
+    // an infinite or pondering search may only answer once it is told to,
+    // even when it ran out of depth to search
+    while ((limits.infinite || timeManager.isPondering()) && !timeManager.isStopped())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    result.nodes = m_nodes;
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+// Name : aspiration ()
+// Desc : the window grows by half again on every failure so a score that
+//        moved a lot is found in a few searches
+//-----------------------------------------------------------------------------
+int Search::aspiration(int depth, int prevScore)
+{
+    if (!(m_features & SEARCH_PVS) || depth < AspirationDepth || isMateScore(prevScore))
+        return alphaBeta(-VALUE_INFINITE, VALUE_INFINITE, depth, 0);
+
+    int window = AspirationWindow;
+    int alpha = std::max(prevScore - window, -VALUE_INFINITE);
+    int beta  = std::min(prevScore + window, VALUE_INFINITE);
+
+    while (true)
+    {
+        int score = alphaBeta(alpha, beta, depth, 0);
+        if (m_stopped)
+            return score;
+
+        if (score <= alpha)
+        {
+            beta = (alpha + beta) / 2;
+            alpha = std::max(score - window, -VALUE_INFINITE);
+        }
+        else if (score >= beta)
+            beta = std::min(score + window, VALUE_INFINITE);
+        else
+            return score;
+
+        window += window / 2;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : alphaBeta ()
+//-----------------------------------------------------------------------------
+int Search::alphaBeta(int alpha, int beta, int depth, int ply)
+{
+    m_pvLength[ply] = ply;
+
+    if (depth <= 0)
+        return quiescence(alpha, beta, ply);
+
+    m_nodes++;
+    if (m_timeManager->checkTime(m_nodes))
+    {
+        m_stopped = true;
+        return 0;
+    }
+
+    if (ply >= MAX_PLY - 1)
+        return m_evaluator.evaluate(*m_pos);
+
+    if (ply > 0)
+    {
+        if (isDraw())
+            return VALUE_DRAW;
+
+        // no line from here can beat a mate that was already found closer to root
+        alpha = std::max(alpha, -VALUE_MATE + ply);
+        beta  = std::min(beta, VALUE_MATE - ply - 1);
+        if (alpha >= beta)
+            return alpha;
+    }
+
+    bool pvNode = beta - alpha > 1;
+    uint64_t key = m_pos->key();
+
+    TTData ttData;
+    bool ttHit = m_tt.probe(key, ttData);
+    Move ttMove = ttHit ? ttData.move : MOVE_NONE;
+
+    if (ttHit && !pvNode && ttData.depth >= depth)
+    {
+        int ttScore = scoreFromTT(ttData.score, ply);
+        if (ttData.bound == BOUND_EXACT ||
+            (ttData.bound == BOUND_LOWER && ttScore >= beta) ||
+            (ttData.bound == BOUND_UPPER && ttScore <= alpha))
+            return ttScore;
+    }
+
+    bool inCheck = m_pos->inCheck();
+    if (inCheck)
+        depth++;
+
+    // the static evaluation only decides the pruning, a position in check
+    // has to try its evasions whatever it is worth
+    int staticEval = VALUE_NONE;
+    if (!inCheck)
+        staticEval = (ttHit && ttData.eval != VALUE_NONE) ? ttData.eval : m_evaluator.evaluate(*m_pos);
+
+    //----------------------------------------------------------------
+    // null move : when passing still fails high the position is good
+    // enough that searching the real moves is a waste
+    //----------------------------------------------------------------
+    int side = m_pos->sideToMove();
+    if ((m_features & SEARCH_NULL_MOVE) && !pvNode && !inCheck && !m_verifying &&
+        ply > 0 && m_playedMoves[ply - 1] != MOVE_NONE && depth >= NullMoveDepth &&
+        staticEval >= beta && m_pos->hasNonPawnMaterial(side))
+    {
+        int nullDepth = depth - 1 - NullMoveReduction - depth / 6;
+
+        UndoInfo undo;
+        m_playedMoves[ply] = MOVE_NONE;
+        doNullMove(undo);
+        int score = -alphaBeta(-beta, -beta + 1, nullDepth, ply + 1);
+        undoNullMove(undo);
+
+        if (m_stopped)
+            return 0;
+
+        if (score >= beta)
+        {
+            // a mate found after passing is not proven
+            if (score >= VALUE_MATE_IN_MAX_PLY)
+                score = beta;
+
+            Bitboard sidePieces = m_pos->pieces(side) & ~m_pos->piecesOfType(PAWN) & ~m_pos->piecesOfType(KING);
+            if (popCount(sidePieces) > NullMoveVerifyPieces)
+                return score;
+
+            m_verifying = true;
+            int verifyScore = alphaBeta(beta - 1, beta, nullDepth, ply);
+            m_verifying = false;
+
+            if (m_stopped)
+                return 0;
+
+            if (verifyScore >= beta)
+                return score;
+        }
+    }
+
+    MoveList moveList;
+    int scores[MAX_MOVES];
+    m_pos->generateMoves(moveList);
+    scoreMoves(moveList, scores, ttMove, ply);
+
+    // quiet moves near the leaves are only tried when they have a chance to
+    // raise alpha, mates are never pruned away
+    bool futile = (m_features & SEARCH_FUTILITY) && !pvNode && !inCheck && depth <= FutilityDepth &&
+                  std::abs(alpha) < VALUE_MATE_IN_MAX_PLY &&
+                  staticEval + FutilityMargin[depth] <= alpha;
+
+    int oldAlpha = alpha;
+    int bestScore = -VALUE_INFINITE;
+    Move bestMove = MOVE_NONE;
+    int legalMoves = 0;
+
+    for (int i = 0; i < moveList.size; i++)
+    {
+        Move move = pickMove(moveList, scores, i);
+        if (!m_pos->isLegal(move))
+            continue;
+
+        if (ply == 0 && std::find(m_excludedMoves.begin(), m_excludedMoves.end(), move) != m_excludedMoves.end())
+            continue;
+
+        legalMoves++;
+        bool quiet = !m_pos->isCapture(move) && moveType(move) != PROMOTION_MOVE;
+        bool killer = move == m_killers[ply][0] || move == m_killers[ply][1];
+
+        UndoInfo undo;
+        m_playedMoves[ply] = move;
+        doMove(move, undo);
+        bool givesCheck = m_pos->inCheck();
+
+        if (futile && quiet && !givesCheck && legalMoves > 1)
+        {
+            undoMove(move, undo);
+            bestScore = std::max(bestScore, staticEval + FutilityMargin[depth]);
+            continue;
+        }
+
+        // the late quiet moves are searched shallower first, only a move
+        // that beats alpha there is searched again to full depth
+        int newDepth = depth - 1;
+        int reduction = 0;
+        if ((m_features & SEARCH_LMR) && depth >= LmrDepth && legalMoves > LmrFullMoves &&
+            quiet && !killer && !inCheck && !givesCheck)
+        {
+            reduction = 1;
+            if (legalMoves > 2 * LmrFullMoves)
+                reduction++;
+            if (!pvNode && depth >= 6)
+                reduction++;
+            reduction = std::min(reduction, newDepth - 1);
+        }
+
+        // after the first move the rest are expected to fail low, a zero
+        // window proves it for less and only a move that beats alpha is
+        // searched again with the full window
+        bool pvs = (m_features & SEARCH_PVS) && legalMoves > 1;
+        int score = 0;
+        bool fullDepth = true;
+        if (reduction > 0)
+        {
+            score = -alphaBeta(pvs ? -alpha - 1 : -beta, -alpha, newDepth - reduction, ply + 1);
+            fullDepth = score > alpha;
+        }
+
+        if (fullDepth && pvs)
+        {
+            score = -alphaBeta(-alpha - 1, -alpha, newDepth, ply + 1);
+            if (score > alpha && score < beta)
+                score = -alphaBeta(-beta, -alpha, newDepth, ply + 1);
+        }
+        else if (fullDepth)
+            score = -alphaBeta(-beta, -alpha, newDepth, ply + 1);
+
+        undoMove(move, undo);
+
+        if (m_stopped)
+            return 0;
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+
+            if (score > alpha)
+            {
+                alpha = score;
+                bestMove = move;
+                updatePV(ply, move);
+
+                if (ply == 0)
+                    m_rootBestMove = move;
+
+                if (alpha >= beta)
+                {
+                    if (quiet)
+                    {
+                        if (m_killers[ply][0] != move)
+                        {
+                            m_killers[ply][1] = m_killers[ply][0];
+                            m_killers[ply][0] = move;
+                        }
+
+                        int& history = m_history[side][moveFrom(move)][moveTo(move)];
+                        history += depth * depth;
+                        if (history > HistoryMax)
+                            for (int s = 0; s < 2; s++)
+                                for (int from = 0; from < SQUARE_NB; from++)
+                                    for (int to = 0; to < SQUARE_NB; to++)
+                                        m_history[s][from][to] /= 2;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    if (legalMoves == 0)
+        return inCheck ? -VALUE_MATE + ply : VALUE_DRAW;
+
+    // a root with moves left out did not search the whole position
+    if (ply > 0 || m_excludedMoves.empty())
+    {
+        int bound = (bestScore >= beta) ? BOUND_LOWER : (alpha > oldAlpha) ? BOUND_EXACT : BOUND_UPPER;
+        m_tt.store(key, bestMove, scoreToTT(bestScore, ply), staticEval, depth, bound);
+    }
+
+    return bestScore;
+}
+
+//-----------------------------------------------------------------------------
+// Name : quiescence ()
+// Desc : searches captures only until the position is quiet
+//-----------------------------------------------------------------------------
+int Search::quiescence(int alpha, int beta, int ply)
+{
+    m_nodes++;
+    if (m_timeManager->checkTime(m_nodes))
+    {
+        m_stopped = true;
+        return 0;
+    }
+
+    if (ply > m_selDepth)
+        m_selDepth = ply;
+
+    if (isDraw())
+        return VALUE_DRAW;
+
+    if (ply >= MAX_PLY - 1)
+        return m_evaluator.evaluate(*m_pos);
+
+    bool inCheck = m_pos->inCheck();
+    int bestScore = -VALUE_INFINITE;
+
+    // when in check every evasion has to be tried, there is no standing pat
+    if (!inCheck)
+    {
+        bestScore = m_evaluator.evaluate(*m_pos);
+        if (bestScore >= beta)
+            return bestScore;
+        if (bestScore > alpha)
+            alpha = bestScore;
+    }
+
+    MoveList moveList;
+    int scores[MAX_MOVES];
+    if (inCheck)
+        m_pos->generateMoves(moveList);
+    else
+        m_pos->generateCaptures(moveList);
+    scoreMoves(moveList, scores, MOVE_NONE, ply);
+
+    int legalMoves = 0;
+    for (int i = 0; i < moveList.size; i++)
+    {
+        Move move = pickMove(moveList, scores, i);
+        if (!m_pos->isLegal(move))
+            continue;
+
+        legalMoves++;
+
+        UndoInfo undo;
+        doMove(move, undo);
+        int score = -quiescence(-beta, -alpha, ply + 1);
+        undoMove(move, undo);
+
+        if (m_stopped)
+            return 0;
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            if (score > alpha)
+            {
+                alpha = score;
+                if (alpha >= beta)
+                    break;
+            }
+        }
+    }
+
+    if (inCheck && legalMoves == 0)
+        return -VALUE_MATE + ply;
+
+    return bestScore;
+}
+
+//-----------------------------------------------------------------------------
+// Name : isDraw ()
+// Desc : fifty moves rule and repetitions, inside the search a single
+//        repetition is enough to call the line a draw. a mate given on the
+//        move that completes the fifty moves stands, as in findDraw()
+//-----------------------------------------------------------------------------
+bool Search::isDraw() const
+{
+    if (m_pos->rule50() >= 100 && (!m_pos->inCheck() || m_pos->hasLegalMove()))
+        return true;
+
+    int last = static_cast<int>(m_keys.size()) - 1;
+    int stop = std::max(0, last - m_pos->rule50());
+    for (int i = last - 2; i >= stop; i -= 2)
+        if (m_keys[i] == m_keys[last])
+            return true;
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// Name : scoreMoves ()
+//-----------------------------------------------------------------------------
+void Search::scoreMoves(const MoveList& moveList, int scores[], Move ttMove, int ply) const
+{
+    int side = m_pos->sideToMove();
+
+    for (int i = 0; i < moveList.size; i++)
+    {
+        Move move = moveList.moves[i];
+
+        if (move == ttMove)
+            scores[i] = TTMoveScore;
+        else if (m_pos->isCapture(move))
+        {
+            // most valuable victim first, then least valuable attacker
+            int victim = pieceType(m_pos->capturedPiece(move));
+            int attacker = pieceType(m_pos->pieceOn(moveFrom(move)));
+            scores[i] = CaptureScore + victim * 16 - attacker;
+        }
+        else if (moveType(move) == PROMOTION_MOVE)
+            scores[i] = PromotionScore + promotionType(move);
+        else if (move == m_killers[ply][0])
+            scores[i] = KillerScore + 1;
+        else if (move == m_killers[ply][1])
+            scores[i] = KillerScore;
+        else
+            scores[i] = m_history[side][moveFrom(move)][moveTo(move)];
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : pickMove ()
+// Desc : moves the best scored remaining move to index, a full sort is
+//        wasted work as most nodes cut off after a move or two
+//-----------------------------------------------------------------------------
+Move Search::pickMove(MoveList& moveList, int scores[], int index) const
+{
+    int best = index;
+    for (int i = index + 1; i < moveList.size; i++)
+        if (scores[i] > scores[best])
+            best = i;
+
+    std::swap(moveList.moves[index], moveList.moves[best]);
+    std::swap(scores[index], scores[best]);
+    return moveList.moves[index];
+}
+
+//-----------------------------------------------------------------------------
+// Name : updatePV ()
+//-----------------------------------------------------------------------------
+void Search::updatePV(int ply, Move move)
+{
+    m_pv[ply][ply] = move;
+    for (int i = ply + 1; i < m_pvLength[ply + 1]; i++)
+        m_pv[ply][i] = m_pv[ply + 1][i];
+    m_pvLength[ply] = std::max(ply + 1, m_pvLength[ply + 1]);
+}
+
+//-----------------------------------------------------------------------------
+// Name : doMove ()
+// Desc : with copy-make the move is played on a copy of the position one ply
+//        up the stack, the parent stays as it was
+//-----------------------------------------------------------------------------
+void Search::doMove(Move move, UndoInfo& undo)
+{
+    if (m_copyMake)
+    {
+        m_pos[1] = m_pos[0];
+        m_pos++;
+    }
+
+    m_pos->doMove(move, undo);
+    m_keys.push_back(m_pos->key());
+}
+
+//-----------------------------------------------------------------------------
+// Name : undoMove ()
+//-----------------------------------------------------------------------------
+void Search::undoMove(Move move, const UndoInfo& undo)
+{
+    m_keys.pop_back();
+
+    if (m_copyMake)
+        m_pos--;
+    else
+        m_pos->undoMove(move, undo);
+}
+
+//-----------------------------------------------------------------------------
+// Name : doNullMove ()
+//-----------------------------------------------------------------------------
+void Search::doNullMove(UndoInfo& undo)
+{
+    if (m_copyMake)
+    {
+        m_pos[1] = m_pos[0];
+        m_pos++;
+    }
+
+    m_pos->doNullMove(undo);
+    m_keys.push_back(m_pos->key());
+}
+
+//-----------------------------------------------------------------------------
+// Name : undoNullMove ()
+//-----------------------------------------------------------------------------
+void Search::undoNullMove(const UndoInfo& undo)
+{
+    m_keys.pop_back();
+
+    if (m_copyMake)
+        m_pos--;
+    else
+        m_pos->undoNullMove(undo);
+}
+
+//-----------------------------------------------------------------------------
+// Name : setFeatures ()
+//-----------------------------------------------------------------------------
+void Search::setFeatures(int features)
+{
+    m_features = features;
+}
+
+//-----------------------------------------------------------------------------
+// Name : setMultiPV ()
+//-----------------------------------------------------------------------------
+void Search::setMultiPV(int lines)
+{
+    m_multiPV = std::max(1, lines);
+}
+
+//-----------------------------------------------------------------------------
+// Name : setCopyMake ()
+//-----------------------------------------------------------------------------
+void Search::setCopyMake(bool enabled)
+{
+    m_copyMake = enabled;
+}
+
+//-----------------------------------------------------------------------------
+// Name : setInfoCallback ()
+//-----------------------------------------------------------------------------
+void Search::setInfoCallback(InfoCallback callback)
+{
+    m_infoCallback = callback;
+}
+
+//-----------------------------------------------------------------------------
+// Name : clearHistory ()
+//-----------------------------------------------------------------------------
+void Search::clearHistory()
+{
+    std::memset(m_killers, 0, sizeof(m_killers));
+    std::memset(m_history, 0, sizeof(m_history));
+    std::memset(m_pvLength, 0, sizeof(m_pvLength));
+}
+
+//-----------------------------------------------------------------------------
+// Name : getNodes ()
+//-----------------------------------------------------------------------------
+uint64_t Search::getNodes() const
+{
+    return m_nodes;
+}
+
+//-----------------------------------------------------------------------------
+// Name : isMateScore ()
+//-----------------------------------------------------------------------------
+bool Search::isMateScore(int score)
+{
+    return score >= VALUE_MATE_IN_MAX_PLY || score <= -VALUE_MATE_IN_MAX_PLY;
+}
+
+//-----------------------------------------------------------------------------
+// Name : scoreToTT ()
+// Desc : mate scores are stored relative to the node instead of the root
+//-----------------------------------------------------------------------------
+int Search::scoreToTT(int score, int ply)
+{
+    if (score >= VALUE_MATE_IN_MAX_PLY)
+        return score + ply;
+    if (score <= -VALUE_MATE_IN_MAX_PLY)
+        return score - ply;
+    return score;
+}
+
+//-----------------------------------------------------------------------------
+// Name : scoreFromTT ()
+//-----------------------------------------------------------------------------
+int Search::scoreFromTT(int score, int ply)
+{
+    if (score >= VALUE_MATE_IN_MAX_PLY)
+        return score - ply;
+    if (score <= -VALUE_MATE_IN_MAX_PLY)
+        return score + ply;
+    return score;
+}
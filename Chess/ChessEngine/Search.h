@@ -0,0 +1,146 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SEARCH_H_
+#define _SEARCH_H_
+
+#include <vector>
+#include <functional>
+#include "Position.h"
+#include "Evaluate.h"
+#include "TranspositionTable.h"
+#include "TimeManager.h"
+
+// progress report sent for every line of every completed iteration
+struct SearchInfo
+{
+    SearchInfo();
+
+    int      depth;
+    int      selDepth;
+    int      score;
+    uint64_t nodes;
+    int64_t  time;      // ms
+    int      hashfull;
+    int      multiPV;   // the rank of the line, 1 is the best move
+    std::vector<Move> pv;
+};
+
+// the selective parts of the search, each one can be turned off to measure
+// what it is worth
+enum SearchFeature
+{
+    SEARCH_PVS          = 1 << 0,   // zero window search after the first move, aspiration windows at root
+    SEARCH_NULL_MOVE    = 1 << 1,   // null move pruning, verified when few pieces are left
+    SEARCH_LMR          = 1 << 2,   // late move reductions of the quiet moves ordered last
+    SEARCH_FUTILITY     = 1 << 3,   // quiet moves near the leaves that can not raise alpha are skipped
+    SEARCH_ALL_FEATURES = SEARCH_PVS | SEARCH_NULL_MOVE | SEARCH_LMR | SEARCH_FUTILITY
+};
+
+struct SearchResult
+{
+    SearchResult();
+
+    Move     bestMove;
+    Move     ponderMove;
+    int      score;
+    int      depth;
+    uint64_t nodes;
+};
+
+// iterative deepening alpha beta search.
+// a Search object works on its own copy of the position so it can run on any
+// thread, only the transposition table is shared
+class Search
+{
+public:
+    typedef std::function<void (const SearchInfo&)> InfoCallback;
+
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    explicit Search(TranspositionTable& tt);
+
+    // gameHistory holds the keys of the positions played before root, oldest first
+    SearchResult think(const Position& root, const std::vector<uint64_t>& gameHistory,
+                       const SearchLimits& limits, TimeManager& timeManager);
+
+    void setInfoCallback(InfoCallback callback);
+    // copy-make plays every move on a copy of the position one ply up a stack
+    // instead of taking it back afterwards. must not be called while thinking
+    void setCopyMake    (bool enabled);
+    // a SearchFeature mask, all of them are on by default
+    void setFeatures    (int features);
+    // the number of best root moves searched and reported with their own
+    // score and pv, the result is always the best one
+    void setMultiPV     (int lines);
+    void clearHistory();
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    uint64_t getNodes() const;
+
+    static bool isMateScore(int score);
+
+private:
+    int  alphaBeta (int alpha, int beta, int depth, int ply);
+    int  quiescence(int alpha, int beta, int ply);
+    // searches the root with a window around the score of the previous
+    // iteration and widens it until the score falls inside
+    int  aspiration(int depth, int prevScore);
+
+    bool isDraw    () const;
+    void scoreMoves(const MoveList& moveList, int scores[], Move ttMove, int ply) const;
+    Move pickMove  (MoveList& moveList, int scores[], int index) const;
+    void updatePV  (int ply, Move move);
+    void doMove    (Move move, UndoInfo& undo);
+    void undoMove  (Move move, const UndoInfo& undo);
+    void doNullMove  (UndoInfo& undo);
+    void undoNullMove(const UndoInfo& undo);
+
+    static int scoreToTT  (int score, int ply);
+    static int scoreFromTT(int score, int ply);
+
+    Position            m_positions[MAX_PLY];   // the copy-make stack, [0] is root
+    Position*           m_pos;                  // the position being searched
+    bool                m_copyMake;
+    int                 m_features;
+    int                 m_multiPV;
+    Evaluator           m_evaluator;
+    TranspositionTable& m_tt;
+    TimeManager*        m_timeManager;
+    InfoCallback        m_infoCallback;
+
+    std::vector<uint64_t> m_keys;   // keys of the game and the current search line
+    std::vector<Move> m_excludedMoves;  // root moves of the lines already searched
+    Move     m_playedMoves[MAX_PLY];    // the move played at every ply, MOVE_NONE for a null move
+    Move     m_killers[MAX_PLY][2];
+    int      m_history[2][SQUARE_NB][SQUARE_NB];
+    Move     m_pv[MAX_PLY][MAX_PLY];
+    int      m_pvLength[MAX_PLY];
+    Move     m_rootBestMove;
+
+    uint64_t m_nodes;
+    int      m_selDepth;
+    bool     m_stopped;
+    bool     m_verifying;   // inside a null move verification, no null moves
+};
+
+#endif // _SEARCH_H_
@@ -0,0 +1,178 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Serialization.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    struct CrcTable
+    {
+        CrcTable()
+        {
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; bit++)
+                    value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+                entries[i] = value;
+            }
+        }
+
+        uint32_t entries[256];
+    };
+
+    const CrcTable Crc;
+
+    //-------------------------------------------------------------------------
+    // Name : renameOver ()
+    // Desc : a posix rename replaces the old file in one step, windows does
+    //        not rename over an existing file so the old one goes first
+    //-------------------------------------------------------------------------
+    bool renameOver(const std::string& from, const std::string& to)
+    {
+#ifdef _WIN32
+        std::remove(to.c_str());
+        return std::rename(from.c_str(), to.c_str()) == 0;
+#else
+        if (std::rename(from.c_str(), to.c_str()) != 0)
+            return false;
+
+        // the rename itself lives in the directory
+        size_t slash = to.find_last_of('/');
+        std::string directory = (slash == std::string::npos) ? "." : to.substr(0, slash + 1);
+        int file = open(directory.c_str(), O_RDONLY);
+        if (file >= 0)
+        {
+            fsync(file);
+            close(file);
+        }
+
+        return true;
+#endif
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : crc32 ()
+//-----------------------------------------------------------------------------
+uint32_t crc32(const void* data, size_t size, uint32_t crc)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+        crc = Crc.entries[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+//-----------------------------------------------------------------------------
+// Name : openFile ()
+//-----------------------------------------------------------------------------
+int openFile(const char* path, int flags)
+{
+#ifdef _WIN32
+    return _open(path, flags | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return open(path, flags, 0644);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Name : writeFile ()
+//-----------------------------------------------------------------------------
+bool writeFile(int file, const void* data, unsigned size)
+{
+#ifdef _WIN32
+    return _write(file, data, size) == static_cast<int>(size);
+#else
+    return write(file, data, size) == static_cast<ssize_t>(size);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Name : syncFd ()
+//-----------------------------------------------------------------------------
+bool syncFd(int file)
+{
+#ifdef _WIN32
+    return _commit(file) == 0;
+#else
+    return fsync(file) == 0;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Name : closeFile ()
+//-----------------------------------------------------------------------------
+void closeFile(int file)
+{
+#ifdef _WIN32
+    _close(file);
+#else
+    close(file);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Name : syncFile ()
+// Desc : syncing any handle of the file writes back all its cached data
+//-----------------------------------------------------------------------------
+bool syncFile(const std::string& path)
+{
+    int file = openFile(path.c_str(), O_RDWR);
+    if (file < 0)
+        return false;
+
+    bool synced = syncFd(file);
+    closeFile(file);
+    return synced;
+}
+
+//-----------------------------------------------------------------------------
+// Name : replaceFile ()
+// Desc : the new file is on the disk before the rename can point at it
+//-----------------------------------------------------------------------------
+bool replaceFile(const std::string& path, const void* data, size_t size)
+{
+    std::string tempPath = path + ".tmp";
+    int file = openFile(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC);
+    if (file < 0)
+        return false;
+
+    bool written = writeFile(file, data, static_cast<unsigned>(size)) && syncFd(file);
+    closeFile(file);
+
+    if (!written)
+    {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    return renameOver(tempPath, path);
+}
@@ -0,0 +1,86 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SERIALIZATION_H_
+#define _SERIALIZATION_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// helpers for the binary files the game writes. every value is stored little
+// endian whatever the machine so the files can be moved between platforms
+
+inline void writeLE16(uint8_t* data, uint16_t value)
+{
+    data[0] = static_cast<uint8_t>(value);
+    data[1] = static_cast<uint8_t>(value >> 8);
+}
+
+inline void writeLE32(uint8_t* data, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        data[i] = static_cast<uint8_t>(value >> (i * 8));
+}
+
+inline void writeLE64(uint8_t* data, uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+        data[i] = static_cast<uint8_t>(value >> (i * 8));
+}
+
+inline uint16_t readLE16(const uint8_t* data)
+{
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+inline uint32_t readLE32(const uint8_t* data)
+{
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--)
+        value = (value << 8) | data[i];
+    return value;
+}
+
+inline uint64_t readLE64(const uint8_t* data)
+{
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--)
+        value = (value << 8) | data[i];
+    return value;
+}
+
+// crc-32(the zip/png polynomial), pass the previous result to continue it
+uint32_t crc32(const void* data, size_t size, uint32_t crc = 0);
+
+// plain file descriptors for files whose data must reach the os with every
+// write instead of waiting in a stream buffer. flags are the open() O_ flags
+// from <fcntl.h>, files are opened binary and created readable and writable
+int  openFile (const char* path, int flags);
+bool writeFile(int file, const void* data, unsigned size);
+bool syncFd   (int file);
+void closeFile(int file);
+
+// the data of the file reaches the disk instead of waiting in the os cache
+bool syncFile   (const std::string& path);
+// writes the file aside, syncs it and renames it over path, so a crash or a
+// power loss leaves either the whole old or the whole new file
+bool replaceFile(const std::string& path, const void* data, size_t size);
+
+#endif // _SERIALIZATION_H_
@@ -0,0 +1,166 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ThreadPool.h"
+
+//-----------------------------------------------------------------------------
+// Name : ThreadPool (constructor)
+//-----------------------------------------------------------------------------
+ThreadPool::ThreadPool(int threadCount)
+{
+    if (threadCount <= 0)
+        threadCount = hardwareThreads();
+
+    m_queued = 0;
+    m_unfinished = 0;
+    m_nextQueue = 0;
+    m_quit = false;
+
+    for (int i = 0; i < threadCount; i++)
+        m_queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue));
+
+    for (int i = 0; i < threadCount; i++)
+        m_threads.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+}
+
+//-----------------------------------------------------------------------------
+// Name : ThreadPool (destructor)
+//-----------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+    wait();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_workAvailable.notify_all();
+
+    for (size_t i = 0; i < m_threads.size(); i++)
+        m_threads[i].join();
+}
+
+//-----------------------------------------------------------------------------
+// Name : submit ()
+//-----------------------------------------------------------------------------
+void ThreadPool::submit(Task task)
+{
+    unsigned queue;
+    {
+        // counted under the lock the workers sleep on so none misses it, a
+        // worker that looks before the push below just tries again
+        std::lock_guard<std::mutex> lock(m_mutex);
+        queue = m_nextQueue++ % m_queues.size();
+        m_unfinished++;
+        m_queued++;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_queues[queue]->mutex);
+        m_queues[queue]->tasks.push_back(std::move(task));
+    }
+
+    m_workAvailable.notify_one();
+}
+
+//-----------------------------------------------------------------------------
+// Name : wait ()
+//-----------------------------------------------------------------------------
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_allDone.wait(lock, [this]() { return m_unfinished == 0; });
+}
+
+//-----------------------------------------------------------------------------
+// Name : getThreadCount ()
+//-----------------------------------------------------------------------------
+int ThreadPool::getThreadCount() const
+{
+    return static_cast<int>(m_threads.size());
+}
+
+//-----------------------------------------------------------------------------
+// Name : hardwareThreads ()
+//-----------------------------------------------------------------------------
+int ThreadPool::hardwareThreads()
+{
+    unsigned count = std::thread::hardware_concurrency();
+    return count ? static_cast<int>(count) : 1;
+}
+
+//-----------------------------------------------------------------------------
+// Name : workerLoop ()
+//-----------------------------------------------------------------------------
+void ThreadPool::workerLoop(int worker)
+{
+    for (;;)
+    {
+        Task task;
+        if (popTask(worker, task))
+        {
+            task(worker);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_unfinished == 0)
+                m_allDone.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_workAvailable.wait(lock, [this]() { return m_quit || m_queued.load() > 0; });
+        if (m_quit && m_queued.load() == 0)
+            return;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : popTask ()
+// Desc : the newest task of the worker own queue, or else the oldest task
+//        of the first other queue that has one
+//-----------------------------------------------------------------------------
+bool ThreadPool::popTask(int worker, Task& task)
+{
+    size_t queueCount = m_queues.size();
+
+    for (size_t i = 0; i < queueCount; i++)
+    {
+        WorkQueue& queue = *m_queues[(worker + i) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            continue;
+
+        if (i == 0)
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+
+        m_queued--;
+        return true;
+    }
+
+    return false;
+}
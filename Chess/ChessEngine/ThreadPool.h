@@ -0,0 +1,86 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _THREADPOOL_H_
+#define _THREADPOOL_H_
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+// fixed set of worker threads with a task queue each.
+// tasks are dealt round robin to the queues, a worker runs its own tasks
+// newest first and when it runs dry steals the oldest task of another queue,
+// so a few long tasks never leave the other workers idle.
+// a task gets the index of the worker running it, to reach per worker state
+class ThreadPool
+{
+public:
+    typedef std::function<void (int worker)> Task;
+
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    // 0 threads uses one per hardware thread
+    explicit ThreadPool(int threadCount = 0);
+    // runs the tasks left before returning
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Task task);
+    // blocks until every submitted task has finished
+    void wait  ();
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    int getThreadCount() const;
+
+    static int hardwareThreads();
+
+private:
+    struct WorkQueue
+    {
+        std::mutex       mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(int worker);
+    bool popTask   (int worker, Task& task);
+
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::vector<std::thread>  m_threads;
+
+    std::mutex                m_mutex;
+    std::condition_variable   m_workAvailable;
+    std::condition_variable   m_allDone;
+    std::atomic<size_t>       m_queued;     // submitted and not picked up yet
+    size_t                    m_unfinished; // submitted and not done yet
+    unsigned                  m_nextQueue;
+    bool                      m_quit;
+};
+
+#endif // _THREADPOOL_H_
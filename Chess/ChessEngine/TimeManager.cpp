@@ -0,0 +1,284 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "TimeManager.h"
+#include <algorithm>
+
+namespace
+{
+    // the clock is read about this often(micro seconds), well below the 1ms
+    // we allow the search to overshoot the deadline
+    const int64_t  CheckPeriod      = 100;
+    const uint64_t MinCheckInterval = 32;
+    const uint64_t MaxCheckInterval = 16384;
+
+    const int DefaultMovesToGo = 30;
+}
+
+//-----------------------------------------------------------------------------
+// Name : SearchLimits (constructor)
+//-----------------------------------------------------------------------------
+SearchLimits::SearchLimits()
+{
+    depth = 0;
+    nodes = 0;
+    moveTime = 0;
+    time[0] = time[1] = 0;
+    increment[0] = increment[1] = 0;
+    movesToGo = 0;
+    infinite = false;
+    ponder = false;
+}
+
+//-----------------------------------------------------------------------------
+// Name : useTimeManagement ()
+//-----------------------------------------------------------------------------
+bool SearchLimits::useTimeManagement() const
+{
+    return !infinite && moveTime == 0 && (time[0] != 0 || time[1] != 0);
+}
+
+//-----------------------------------------------------------------------------
+// Name : TimeManager (constructor)
+//-----------------------------------------------------------------------------
+TimeManager::TimeManager()
+{
+    m_startTime = Clock::now();
+    m_optimumTime = 0;
+    m_maximumTime = 0;
+    m_nodeLimit = 0;
+    m_nextCheck = 0;
+    m_checkInterval = MinCheckInterval;
+    m_lastCheckNodes = 0;
+    m_lastCheckTime = 0;
+    m_lastBestMove = 0;
+    m_stableIterations = 0;
+    m_instability = 0;
+    m_stop = false;
+    m_pondering = false;
+    m_ponderhitTime = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : start ()
+// Desc : starts the clock and computes the time budget of the side to move
+//-----------------------------------------------------------------------------
+void TimeManager::start(const SearchLimits& limits, int side)
+{
+    m_startTime = Clock::now();
+    m_stop = false;
+    m_ponderhitTime = 0;
+    m_pondering = limits.ponder;
+
+    m_nodeLimit = limits.nodes;
+    m_checkInterval = 256;
+    m_nextCheck = m_checkInterval;
+    m_lastCheckNodes = 0;
+    m_lastCheckTime = 0;
+
+    m_lastBestMove = 0;
+    m_stableIterations = 0;
+    m_instability = 0;
+
+    m_optimumTime = 0;
+    m_maximumTime = 0;
+
+    if (limits.infinite)
+        return;
+
+    if (limits.moveTime > 0)
+    {
+        int64_t moveTime = std::max(1, limits.moveTime - s_moveOverhead);
+        m_optimumTime = moveTime * 1000;
+        m_maximumTime = moveTime * 1000;
+    }
+    else if (limits.useTimeManagement())
+    {
+        int64_t timeLeft  = limits.time[side];
+        int64_t increment = limits.increment[side];
+        int movesToGo = (limits.movesToGo > 0) ? std::min(limits.movesToGo, 50) : DefaultMovesToGo;
+
+        // never plan to use more than what is left minus the overhead
+        int64_t usable = std::max<int64_t>(1, timeLeft - s_moveOverhead);
+
+        int64_t optimum = timeLeft / movesToGo + increment * 3 / 4;
+        optimum = std::min<int64_t>(optimum, usable / 2);
+
+        int64_t maximum = std::min<int64_t>(optimum * 4, usable * 4 / 5);
+        if (movesToGo == 1)
+            maximum = usable;
+
+        m_optimumTime = std::max<int64_t>(1, optimum) * 1000;
+        m_maximumTime = std::max<int64_t>(1, std::max(optimum, maximum)) * 1000;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : checkTime ()
+// Desc : returns true when the search must stop
+//-----------------------------------------------------------------------------
+bool TimeManager::checkTime(uint64_t nodes)
+{
+    if (m_stop.load(std::memory_order_relaxed))
+        return true;
+
+    if (m_nodeLimit && nodes >= m_nodeLimit)
+    {
+        m_stop = true;
+        return true;
+    }
+
+    if (nodes < m_nextCheck)
+        return false;
+
+    int64_t now = elapsedMicros();
+
+    // adjust the interval to the actual node rate so the clock keeps being
+    // read about every CheckPeriod micro seconds
+    int64_t timeDelta = now - m_lastCheckTime;
+    if (timeDelta > 0)
+    {
+        uint64_t interval = (nodes - m_lastCheckNodes) * CheckPeriod / timeDelta;
+        m_checkInterval = std::max(MinCheckInterval, std::min(MaxCheckInterval, interval));
+    }
+
+    m_lastCheckNodes = nodes;
+    m_lastCheckTime = now;
+    m_nextCheck = nodes + m_checkInterval;
+
+    // while pondering it is the opponent's clock that runs
+    if (m_pondering.load(std::memory_order_acquire))
+        return false;
+
+    if (m_maximumTime && now - m_ponderhitTime.load(std::memory_order_relaxed) >= m_maximumTime)
+    {
+        m_stop = true;
+        return true;
+    }
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// Name : onIterationComplete ()
+// Desc : tracks how stable the best move is between iterations
+//-----------------------------------------------------------------------------
+void TimeManager::onIterationComplete(int depth, uint16_t bestMove)
+{
+    bool changed = depth > 1 && bestMove != m_lastBestMove;
+
+    m_instability = m_instability * 0.5 + (changed ? 1.0 : 0.0);
+    if (changed)
+        m_stableIterations = 0;
+    else
+        m_stableIterations++;
+
+    m_lastBestMove = bestMove;
+}
+
+//-----------------------------------------------------------------------------
+// Name : shouldStartIteration ()
+// Desc : a new iteration takes about as long as all the previous ones, so it
+//        is only started when it has a fair chance to finish in the allotment.
+//        the allotment grows when the best move keeps changing and shrinks
+//        when it has been stable for a while
+//-----------------------------------------------------------------------------
+bool TimeManager::shouldStartIteration() const
+{
+    if (m_stop.load(std::memory_order_relaxed))
+        return false;
+
+    if (m_optimumTime == 0 || m_pondering.load(std::memory_order_acquire))
+        return true;
+
+    double scale = 1.0 + m_instability;
+    if (m_stableIterations >= 4)
+        scale *= 0.6;
+
+    int64_t allotment = std::min<int64_t>(static_cast<int64_t>(m_optimumTime * scale), m_maximumTime);
+    return elapsedMicros() - m_ponderhitTime.load(std::memory_order_relaxed) < allotment / 2;
+}
+
+//-----------------------------------------------------------------------------
+// Name : requestStop ()
+//-----------------------------------------------------------------------------
+void TimeManager::requestStop()
+{
+    m_stop = true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : isStopped ()
+//-----------------------------------------------------------------------------
+bool TimeManager::isStopped() const
+{
+    return m_stop.load(std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+// Name : ponderhit ()
+// Desc : the time spent pondering was the opponent's, the budget of the move
+//        is counted from here
+//-----------------------------------------------------------------------------
+void TimeManager::ponderhit()
+{
+    m_ponderhitTime.store(elapsedMicros(), std::memory_order_relaxed);
+    m_pondering.store(false, std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------
+// Name : isPondering ()
+//-----------------------------------------------------------------------------
+bool TimeManager::isPondering() const
+{
+    return m_pondering.load(std::memory_order_acquire);
+}
+
+//-----------------------------------------------------------------------------
+// Name : getElapsed ()
+//-----------------------------------------------------------------------------
+int64_t TimeManager::getElapsed() const
+{
+    return elapsedMicros() / 1000;
+}
+
+//-----------------------------------------------------------------------------
+// Name : getOptimumTime ()
+//-----------------------------------------------------------------------------
+int64_t TimeManager::getOptimumTime() const
+{
+    return m_optimumTime / 1000;
+}
+
+//-----------------------------------------------------------------------------
+// Name : getMaximumTime ()
+//-----------------------------------------------------------------------------
+int64_t TimeManager::getMaximumTime() const
+{
+    return m_maximumTime / 1000;
+}
+
+//-----------------------------------------------------------------------------
+// Name : elapsedMicros ()
+//-----------------------------------------------------------------------------
+int64_t TimeManager::elapsedMicros() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_startTime).count();
+}
@@ -0,0 +1,106 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TIMEMANAGER_H_
+#define _TIMEMANAGER_H_
+
+#include <cstdint>
+#include <chrono>
+#include <atomic>
+
+// what the search is allowed to spend on one move.
+// a zero value means the limit is not used
+struct SearchLimits
+{
+    SearchLimits();
+
+    bool useTimeManagement() const;
+
+    int      depth;
+    uint64_t nodes;
+    int      moveTime;      // fixed time per move in ms
+    int      time[2];       // [side] remaining clock time in ms
+    int      increment[2];  // [side] increment per move in ms
+    int      movesToGo;
+    bool     infinite;
+    bool     ponder;        // search the expected reply until ponderhit
+};
+
+// decides how long the search thinks on a move.
+// the search calls checkTime() on every node, the clock itself is only read
+// once every few hundred nodes so checking costs almost nothing while the
+// search still stops within a millisecond of the hard deadline
+class TimeManager
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    TimeManager();
+
+    void start(const SearchLimits& limits, int side);
+
+    //-------------------------------------------------------------------------
+    // Functions called by the search
+    //-------------------------------------------------------------------------
+    bool checkTime(uint64_t nodes);
+    void onIterationComplete(int depth, uint16_t bestMove);
+    bool shouldStartIteration() const;
+
+    void requestStop();
+    bool isStopped() const;
+
+    // the opponent played the expected move, the limits apply from now on
+    void ponderhit();
+    bool isPondering() const;
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    int64_t getElapsed       () const;
+    int64_t getOptimumTime   () const;
+    int64_t getMaximumTime   () const;
+
+    static const int s_moveOverhead = 10;   // ms reserved for the gui/communication per move
+
+private:
+    int64_t elapsedMicros() const;
+
+    Clock::time_point m_startTime;
+    int64_t  m_optimumTime;     // micro seconds the search should aim for
+    int64_t  m_maximumTime;     // hard deadline in micro seconds, 0 = none
+    uint64_t m_nodeLimit;
+
+    uint64_t m_nextCheck;
+    uint64_t m_checkInterval;
+    uint64_t m_lastCheckNodes;
+    int64_t  m_lastCheckTime;
+
+    uint16_t m_lastBestMove;
+    int      m_stableIterations;
+    double   m_instability;
+
+    std::atomic<bool>    m_stop;
+    std::atomic<bool>    m_pondering;
+    std::atomic<int64_t> m_ponderhitTime;   // micro seconds from start() to ponderhit()
+};
+
+#endif // _TIMEMANAGER_H_
@@ -0,0 +1,231 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Tracer.h"
+#include <fstream>
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Tracer::s_enabled(false);
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char* name;
+        int64_t     start;  // nano seconds since the trace epoch
+        int64_t     end;
+    };
+
+    // the spans of one thread. only the owner writes, the writer publishes
+    // each span by advancing head
+    struct TraceBuffer
+    {
+        explicit TraceBuffer(int id) : events(Tracer::s_bufferSize), head(0), finished(false), threadId(id) {}
+
+        std::vector<TraceEvent> events;
+        std::atomic<uint64_t>   head;
+        std::atomic<bool>       finished;   // the owner thread has ended
+        int                     threadId;
+    };
+
+    struct TraceRegistry
+    {
+        TraceRegistry() : nextThreadId(1), epoch(std::chrono::steady_clock::now()) {}
+
+        std::mutex                mutex;
+        std::vector<TraceBuffer*> buffers;
+        int                       nextThreadId;
+        std::chrono::steady_clock::time_point epoch;
+    };
+
+    TraceRegistry& registry()
+    {
+        static TraceRegistry traceRegistry;
+        return traceRegistry;
+    }
+
+    // the buffer is created by the first span of the thread and handed to the
+    // registry, it is freed by clear() once the thread has ended
+    struct ThreadBuffer
+    {
+        ThreadBuffer() : buffer(nullptr) {}
+        ~ThreadBuffer()
+        {
+            if (buffer)
+                buffer->finished.store(true, std::memory_order_release);
+        }
+
+        TraceBuffer* buffer;
+    };
+
+    thread_local ThreadBuffer t_threadBuffer;
+
+    //-------------------------------------------------------------------------
+    // Name : writeMicros ()
+    // Desc : the trace format counts micro seconds, the fraction keeps the
+    //        nano seconds
+    //-------------------------------------------------------------------------
+    void writeMicros(std::ostream& out, int64_t nanos)
+    {
+        int64_t fraction = nanos % 1000;
+        out << nanos / 1000 << "." << (fraction < 100 ? "0" : "") << (fraction < 10 ? "0" : "") << fraction;
+    }
+
+    //-------------------------------------------------------------------------
+    // Name : writeEscaped ()
+    //-------------------------------------------------------------------------
+    void writeEscaped(std::ostream& out, const char* text)
+    {
+        for (; *text; text++)
+        {
+            if (*text == '"' || *text == '\\')
+                out << '\\';
+            out << *text;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : start ()
+// Desc : the spans of an earlier trace are dropped
+//-----------------------------------------------------------------------------
+void Tracer::start()
+{
+    clear();
+    s_enabled.store(true, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+// Name : stop ()
+//-----------------------------------------------------------------------------
+void Tracer::stop()
+{
+    s_enabled.store(false, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+// Name : clear ()
+//-----------------------------------------------------------------------------
+void Tracer::clear()
+{
+    TraceRegistry& traceRegistry = registry();
+    std::lock_guard<std::mutex> lock(traceRegistry.mutex);
+
+    std::vector<TraceBuffer*> buffers;
+    for (TraceBuffer* curBuffer : traceRegistry.buffers)
+    {
+        if (curBuffer->finished.load(std::memory_order_acquire))
+            delete curBuffer;
+        else
+        {
+            curBuffer->head.store(0, std::memory_order_release);
+            buffers.push_back(curBuffer);
+        }
+    }
+
+    traceRegistry.buffers.swap(buffers);
+}
+
+//-----------------------------------------------------------------------------
+// Name : now ()
+//-----------------------------------------------------------------------------
+int64_t Tracer::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - registry().epoch).count();
+}
+
+//-----------------------------------------------------------------------------
+// Name : record ()
+//-----------------------------------------------------------------------------
+void Tracer::record(const char* name, int64_t start, int64_t end)
+{
+    TraceBuffer* buffer = t_threadBuffer.buffer;
+    if (!buffer)
+    {
+        TraceRegistry& traceRegistry = registry();
+        std::lock_guard<std::mutex> lock(traceRegistry.mutex);
+
+        buffer = new TraceBuffer(traceRegistry.nextThreadId++);
+        traceRegistry.buffers.push_back(buffer);
+        t_threadBuffer.buffer = buffer;
+    }
+
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    TraceEvent& event = buffer->events[head & (s_bufferSize - 1)];
+    event.name = name;
+    event.start = start;
+    event.end = end;
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+//-----------------------------------------------------------------------------
+// Name : writeJson ()
+// Desc : the spans are copied out of each buffer while it may still be
+//        written, the ones the writer could have overwritten during the copy
+//        are left out
+//-----------------------------------------------------------------------------
+bool Tracer::writeJson(const std::string& path)
+{
+    std::ofstream out(path.c_str(), std::ios::trunc);
+    if (!out.good())
+        return false;
+
+    TraceRegistry& traceRegistry = registry();
+    std::lock_guard<std::mutex> lock(traceRegistry.mutex);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+
+    std::vector<TraceEvent> events;
+    for (TraceBuffer* curBuffer : traceRegistry.buffers)
+    {
+        uint64_t head = curBuffer->head.load(std::memory_order_acquire);
+        uint64_t begin = (head > s_bufferSize) ? head - s_bufferSize : 0;
+
+        events.clear();
+        for (uint64_t i = begin; i < head; i++)
+            events.push_back(curBuffer->events[i & (s_bufferSize - 1)]);
+
+        uint64_t newHead = curBuffer->head.load(std::memory_order_acquire);
+        size_t skip = 0;
+        if (newHead > s_bufferSize && newHead - s_bufferSize > begin)
+            skip = static_cast<size_t>(std::min(newHead - s_bufferSize - begin, head - begin));
+
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << curBuffer->threadId
+            << ",\"args\":{\"name\":\"thread " << curBuffer->threadId << "\"}}";
+        first = false;
+
+        for (size_t i = skip; i < events.size(); i++)
+        {
+            out << ",\n{\"name\":\"";
+            writeEscaped(out, events[i].name);
+            out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << curBuffer->threadId << ",\"ts\":";
+            writeMicros(out, events[i].start);
+            out << ",\"dur\":";
+            writeMicros(out, events[i].end - events[i].start);
+            out << "}";
+        }
+    }
+
+    out << "\n]}\n";
+    return out.good();
+}
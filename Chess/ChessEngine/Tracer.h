@@ -0,0 +1,93 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TRACER_H_
+#define _TRACER_H_
+
+#include <cstdint>
+#include <string>
+#include <atomic>
+#include <chrono>
+
+// records timed spans of the game and engine work to show them on a timeline.
+// every thread writes its spans to its own ring buffer and the buffers are
+// written on demand as a chrome trace(chrome://tracing or ui.perfetto.dev).
+// while tracing is off a span costs one relaxed load and a branch
+class Tracer
+{
+public:
+    static void start();
+    static void stop ();
+    static bool isEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    // writes the spans of every thread, the oldest ones are dropped once a
+    // thread recorded more than s_bufferSize of them
+    static bool writeJson(const std::string& path);
+    static void clear    ();
+
+    static int64_t now();
+    static void    record(const char* name, int64_t start, int64_t end);
+
+    static const size_t s_bufferSize = 1 << 16;    // spans kept per thread
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+// times the scope it lives in, the name must outlive the trace(a literal)
+class TraceSpan
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    explicit TraceSpan(const char* name)
+    {
+        if (!Tracer::isEnabled())
+        {
+            m_name = nullptr;
+            return;
+        }
+
+        m_name = name;
+        m_start = Tracer::now();
+    }
+
+    ~TraceSpan()
+    {
+        if (m_name)
+            Tracer::record(m_name, m_start, Tracer::now());
+    }
+
+private:
+    TraceSpan(const TraceSpan&);
+    TraceSpan& operator=(const TraceSpan&);
+
+    const char* m_name;
+    int64_t     m_start;
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name) TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+
+#endif // _TRACER_H_
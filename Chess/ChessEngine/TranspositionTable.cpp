@@ -0,0 +1,210 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "TranspositionTable.h"
+
+namespace
+{
+    // data word layout :
+    // bits 0-15 move, 16-31 score, 32-47 static eval, 48-55 depth,
+    // 56-57 bound, 58-63 generation
+    uint64_t packData(Move move, int score, int eval, int depth, int bound, int generation)
+    {
+        return static_cast<uint64_t>(move)
+             | (static_cast<uint64_t>(static_cast<uint16_t>(score)) << 16)
+             | (static_cast<uint64_t>(static_cast<uint16_t>(eval))  << 32)
+             | (static_cast<uint64_t>(static_cast<uint8_t>(depth))  << 48)
+             | (static_cast<uint64_t>(bound & 3) << 56)
+             | (static_cast<uint64_t>(generation & 63) << 58);
+    }
+
+    int dataDepth(uint64_t data)
+    {
+        return static_cast<int8_t>((data >> 48) & 0xFF);
+    }
+
+    int dataGeneration(uint64_t data)
+    {
+        return static_cast<int>(data >> 58);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : TranspositionTable (constructor)
+//-----------------------------------------------------------------------------
+TranspositionTable::TranspositionTable(size_t sizeInMB)
+{
+    m_clusterCount = 0;
+    m_sizeInMB = 0;
+    m_generation = 0;
+    resize(sizeInMB);
+}
+
+//-----------------------------------------------------------------------------
+// Name : resize ()
+// Desc : must not be called while a search is running
+//-----------------------------------------------------------------------------
+void TranspositionTable::resize(size_t sizeInMB)
+{
+    if (sizeInMB == 0)
+        sizeInMB = 1;
+
+    size_t count = (sizeInMB * 1024 * 1024) / sizeof(Cluster);
+    size_t clusters = 1;
+    while (clusters * 2 <= count)
+        clusters *= 2;
+
+    if (clusters != m_clusterCount)
+    {
+        m_clusters.reset(new Cluster[clusters]);
+        m_clusterCount = clusters;
+    }
+
+    m_sizeInMB = sizeInMB;
+    clear();
+}
+
+//-----------------------------------------------------------------------------
+// Name : clear ()
+//-----------------------------------------------------------------------------
+void TranspositionTable::clear()
+{
+    for (size_t i = 0; i < m_clusterCount; i++)
+    {
+        for (Entry& entry : m_clusters[i].entries)
+        {
+            entry.keyXorData.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    m_generation = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : newSearch ()
+// Desc : ages the entries of previous searches so they are replaced first
+//-----------------------------------------------------------------------------
+void TranspositionTable::newSearch()
+{
+    m_generation = (m_generation + 1) & 63;
+}
+
+//-----------------------------------------------------------------------------
+// Name : probe ()
+//-----------------------------------------------------------------------------
+bool TranspositionTable::probe(uint64_t key, TTData& ttData) const
+{
+    Cluster& cluster = clusterOf(key);
+
+    for (Entry& entry : cluster.entries)
+    {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t keyXorData = entry.keyXorData.load(std::memory_order_relaxed);
+
+        if ((keyXorData ^ data) != key || data == 0)
+            continue;
+
+        ttData.move  = static_cast<Move>(data & 0xFFFF);
+        ttData.score = static_cast<int16_t>((data >> 16) & 0xFFFF);
+        ttData.eval  = static_cast<int16_t>((data >> 32) & 0xFFFF);
+        ttData.depth = dataDepth(data);
+        ttData.bound = static_cast<int>((data >> 56) & 3);
+        return true;
+    }
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// Name : store ()
+//-----------------------------------------------------------------------------
+void TranspositionTable::store(uint64_t key, Move move, int score, int eval, int depth, int bound)
+{
+    Cluster& cluster = clusterOf(key);
+    Entry* replace = &cluster.entries[0];
+    int replaceValue = 1 << 30;
+
+    for (Entry& entry : cluster.entries)
+    {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t keyXorData = entry.keyXorData.load(std::memory_order_relaxed);
+
+        if ((keyXorData ^ data) == key)
+        {
+            // keep the old move when we have nothing better to store
+            if (move == MOVE_NONE)
+                move = static_cast<Move>(data & 0xFFFF);
+            replace = &entry;
+            break;
+        }
+
+        // prefer replacing shallow entries from old searches
+        int age = (m_generation - dataGeneration(data)) & 63;
+        int value = dataDepth(data) - 8 * age;
+        if (value < replaceValue)
+        {
+            replaceValue = value;
+            replace = &entry;
+        }
+    }
+
+    uint64_t data = packData(move, score, eval, depth, bound, m_generation);
+    replace->data.store(data, std::memory_order_relaxed);
+    replace->keyXorData.store(key ^ data, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+// Name : hashfull ()
+// Desc : permill of the table used by the current search
+//-----------------------------------------------------------------------------
+int TranspositionTable::hashfull() const
+{
+    size_t samples = (m_clusterCount < 250) ? m_clusterCount : 250;
+    int used = 0;
+
+    for (size_t i = 0; i < samples; i++)
+    {
+        for (Entry& entry : m_clusters[i].entries)
+        {
+            uint64_t data = entry.data.load(std::memory_order_relaxed);
+            if (data != 0 && dataGeneration(data) == m_generation)
+                used++;
+        }
+    }
+
+    return static_cast<int>(used * 1000 / (samples * s_clusterSize));
+}
+
+//-----------------------------------------------------------------------------
+// Name : getSizeInMB ()
+//-----------------------------------------------------------------------------
+size_t TranspositionTable::getSizeInMB() const
+{
+    return m_sizeInMB;
+}
+
+//-----------------------------------------------------------------------------
+// Name : clusterOf ()
+//-----------------------------------------------------------------------------
+TranspositionTable::Cluster& TranspositionTable::clusterOf(uint64_t key) const
+{
+    return m_clusters[key & (m_clusterCount - 1)];
+}
@@ -0,0 +1,92 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TRANSPOSITIONTABLE_H_
+#define _TRANSPOSITIONTABLE_H_
+
+#include <atomic>
+#include <memory>
+#include "Move.h"
+
+enum Bound
+{
+    BOUND_NONE  = 0,
+    BOUND_UPPER = 1,
+    BOUND_LOWER = 2,
+    BOUND_EXACT = BOUND_UPPER | BOUND_LOWER
+};
+
+// what a hash table entry remembers about a position
+struct TTData
+{
+    Move move;
+    int  score;
+    int  eval;
+    int  depth;
+    int  bound;
+};
+
+// hash table of search results shared by every searching thread.
+// it is lock free : an entry is two 64 bit words and the first holds the key
+// xored with the second, an entry torn by two threads writing at once simply
+// fails the key check and is treated as a miss
+class TranspositionTable
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    explicit TranspositionTable(size_t sizeInMB = 16);
+
+    void resize(size_t sizeInMB);
+    void clear();
+    void newSearch();
+
+    bool probe(uint64_t key, TTData& data) const;
+    void store(uint64_t key, Move move, int score, int eval, int depth, int bound);
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    int    hashfull() const;
+    size_t getSizeInMB() const;
+
+private:
+    struct Entry
+    {
+        std::atomic<uint64_t> keyXorData;
+        std::atomic<uint64_t> data;
+    };
+
+    // 4 entries fill a 64 bytes cache line
+    static const int s_clusterSize = 4;
+    struct Cluster
+    {
+        Entry entries[s_clusterSize];
+    };
+
+    Cluster& clusterOf(uint64_t key) const;
+
+    std::unique_ptr<Cluster[]> m_clusters;
+    size_t  m_clusterCount;
+    size_t  m_sizeInMB;
+    uint8_t m_generation;
+};
+
+#endif // _TRANSPOSITIONTABLE_H_
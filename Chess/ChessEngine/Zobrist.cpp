@@ -0,0 +1,120 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Zobrist.h"
+#include "Piece.h"
+
+uint64_t Zobrist::pieces[2][KING + 1][SQUARE_NB];
+uint64_t Zobrist::sideToMove;
+uint64_t Zobrist::castling[16];
+uint64_t Zobrist::enPassant[boardX];
+
+namespace
+{
+    //-----------------------------------------------------------------------------
+    // Name : nextRandom ()
+    // Desc : xorshift64* generator, a fixed seed keeps the keys identical between
+    //        runs so hashes written to disk stay valid
+    //-----------------------------------------------------------------------------
+    uint64_t nextRandom(uint64_t& state)
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+
+    struct ZobristInit
+    {
+        ZobristInit()
+        {
+            uint64_t state = 1070372ULL;
+
+            for (int side = 0; side < 2; side++)
+                for (int type = PAWN; type <= KING; type++)
+                    for (int square = 0; square < SQUARE_NB; square++)
+                        Zobrist::pieces[side][type][square] = nextRandom(state);
+
+            Zobrist::sideToMove = nextRandom(state);
+
+            // castling keys are combined from one key per right so that
+            // removing a single right is a single xor
+            uint64_t rightKeys[4];
+            for (int i = 0; i < 4; i++)
+                rightKeys[i] = nextRandom(state);
+
+            for (int rights = 0; rights < 16; rights++)
+            {
+                Zobrist::castling[rights] = 0;
+                for (int i = 0; i < 4; i++)
+                    if (rights & (1 << i))
+                        Zobrist::castling[rights] ^= rightKeys[i];
+            }
+
+            for (int file = 0; file < boardX; file++)
+                Zobrist::enPassant[file] = nextRandom(state);
+        }
+    };
+
+    ZobristInit zobristInit;
+}
+
+//-----------------------------------------------------------------------------
+// Name : pawnKey ()
+//-----------------------------------------------------------------------------
+uint64_t Zobrist::pawnKey(piece * SBoard[boardY][boardX])
+{
+    uint64_t key = 0;
+
+    for (int i = 0; i < boardY; i++)
+    {
+        for (int j = 0; j < boardX; j++)
+        {
+            piece * curPiece = SBoard[i][j];
+            if (curPiece != nullptr && curPiece->getType() == PAWN)
+                key ^= pieces[colorToSide(curPiece->getColor())][PAWN][makeSquare(j, i)];
+        }
+    }
+
+    return key;
+}
+
+//-----------------------------------------------------------------------------
+// Name : positionKey ()
+//-----------------------------------------------------------------------------
+uint64_t Zobrist::positionKey(piece * SBoard[boardY][boardX], int currentPlayer)
+{
+    uint64_t key = 0;
+
+    for (int i = 0; i < boardY; i++)
+    {
+        for (int j = 0; j < boardX; j++)
+        {
+            piece * curPiece = SBoard[i][j];
+            if (curPiece != nullptr)
+                key ^= pieces[colorToSide(curPiece->getColor())][curPiece->getType()][makeSquare(j, i)];
+        }
+    }
+
+    if (currentPlayer == WHITE)
+        key ^= sideToMove;
+
+    return key;
+}
@@ -0,0 +1,46 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ZOBRIST_H_
+#define _ZOBRIST_H_
+
+#include "Bitboard.h"
+
+class piece;
+
+// random keys used to hash board positions.
+// a position key is the xor of the keys of every piece on its square, the
+// side to move, the castling rights and the en passant file.
+// the pawn key only uses the pawns keys so it changes only on pawn moves
+class Zobrist
+{
+public:
+    static uint64_t pieces[2][KING + 1][SQUARE_NB];   // [side][piece type][square]
+    static uint64_t sideToMove;                       // xored in when white is to move
+    static uint64_t castling[16];
+    static uint64_t enPassant[boardX];
+
+    //-------------------------------------------------------------------------
+    // Functions that hash the interactive board from scratch
+    //-------------------------------------------------------------------------
+    static uint64_t pawnKey(piece * SBoard[boardY][boardX]);
+    static uint64_t positionKey(piece * SBoard[boardY][boardX], int currentPlayer);
+};
+
+#endif // _ZOBRIST_H_
@@ -0,0 +1,400 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <benchmark/benchmark.h>
+#include "../ChessEngine/Board.h"
+
+namespace
+{
+    struct BenchPosition
+    {
+        const char* name;
+        const char* fen;
+    };
+
+    // every benchmark runs over the same positions so the numbers of two
+    // commits can be compared one to one
+    const BenchPosition BenchPositions[] =
+    {
+        {"start",      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"},
+        {"opening",    "r1bqk1nr/pppp1ppp/2n5/2b1p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4"},
+        {"middlegame", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"},
+        {"check",      "rnbqkbnr/ppp2ppp/8/1B1pp3/4P3/8/PPPP1PPP/RNBQK1NR b KQkq - 1 3"},
+        {"endgame",    "8/1p3k2/p1r3p1/3R3p/P6P/6P1/5PK1/8 w - - 0 40"}
+    };
+
+    // the created pieces pile up in the board, it is set up fresh once in
+    // this many iterations, outside the timing
+    const int64_t ResetInterval = 1024;
+
+    const char* const OutputFile = "ChessEngineBench.json";
+
+    // the file benchmarks never touch the board.sav of a real game
+    const char* const BenchSaveFile    = "ChessEngineBench.sav";
+    const char* const BenchJournalFile = "ChessEngineBench.journal";
+
+    //-------------------------------------------------------------------------
+    // Name : resetBoard ()
+    //-------------------------------------------------------------------------
+    void resetBoard(benchmark::State& state, board& chessBoard, const char* fen)
+    {
+        state.PauseTiming();
+        chessBoard.setFromFEN(fen);
+        state.ResumeTiming();
+    }
+
+    //-------------------------------------------------------------------------
+    // Name : tempPath ()
+    // Desc : the file in the temp directory, the working directory when
+    //        none is set
+    //-------------------------------------------------------------------------
+    std::string tempPath(const char* fileName)
+    {
+        const char* EnvNames[] = {"TMPDIR", "TMP", "TEMP"};
+        for (const char* envName : EnvNames)
+        {
+            const char* dir = std::getenv(envName);
+            if (dir && *dir)
+                return std::string(dir) + "/" + fileName;
+        }
+
+        return fileName;
+    }
+
+    //-------------------------------------------------------------------------
+    // Name : useTempFiles ()
+    //-------------------------------------------------------------------------
+    void useTempFiles(board& chessBoard)
+    {
+        chessBoard.setSaveFiles(tempPath(BenchSaveFile), tempPath(BenchJournalFile));
+    }
+
+    //-------------------------------------------------------------------------
+    // Name : removeTempFiles ()
+    //-------------------------------------------------------------------------
+    void removeTempFiles()
+    {
+        std::remove(tempPath(BenchSaveFile).c_str());
+        std::remove(tempPath(BenchJournalFile).c_str());
+    }
+
+    //-------------------------------------------------------------------------
+    // Name : sidePieces ()
+    // Desc : the squares of the pieces of the side to move
+    //-------------------------------------------------------------------------
+    std::vector<BOARD_POINT> sidePieces(const Position& pos)
+    {
+        std::vector<BOARD_POINT> squares;
+        for (int square = 0; square < SQUARE_NB; square++)
+            if (pos.pieceOn(square) != NO_PIECE && pieceSide(pos.pieceOn(square)) == pos.sideToMove())
+                squares.push_back(squareToPoint(square));
+
+        return squares;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : BM_validateMove ()
+// Desc : every legal move of the position in turn. the move is played on the
+//        board, so the position is set up again before each one
+//-----------------------------------------------------------------------------
+static void BM_validateMove(benchmark::State& state, const char* fen)
+{
+    Position pos;
+    pos.setFromFEN(fen);
+
+    MoveList moveList;
+    pos.generateLegalMoves(moveList);
+    if (moveList.size == 0)
+    {
+        state.SkipWithError("no legal moves");
+        return;
+    }
+
+    std::vector<BOARD_POINT> starts, targets;
+    for (int i = 0; i < moveList.size; i++)
+    {
+        starts.push_back(squareToPoint(moveFrom(moveList.moves[i])));
+        targets.push_back(squareToPoint(moveTo(moveList.moves[i])));
+    }
+
+    board chessBoard;
+    size_t moveIndex = 0;
+    int64_t validMoves = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        chessBoard.setFromFEN(fen);
+        chessBoard.processPress(starts[moveIndex]);
+        state.ResumeTiming();
+
+        validMoves += chessBoard.validateMove(starts[moveIndex], targets[moveIndex]);
+        moveIndex = (moveIndex + 1) % starts.size();
+    }
+
+    state.counters["valid"] = benchmark::Counter(static_cast<double>(validMoves), benchmark::Counter::kAvgIterations);
+}
+
+//-----------------------------------------------------------------------------
+// Name : BM_markPawnMoves ()
+// Desc : the moves of every piece of the side to move, as when each is
+//        selected
+//-----------------------------------------------------------------------------
+static void BM_markPawnMoves(benchmark::State& state, const char* fen)
+{
+    Position pos;
+    pos.setFromFEN(fen);
+    std::vector<BOARD_POINT> squares = sidePieces(pos);
+
+    board chessBoard;
+    chessBoard.setFromFEN(fen);
+
+    for (auto _ : state)
+        for (const BOARD_POINT& square : squares)
+            chessBoard.markPawnMoves(square);
+
+    state.SetItemsProcessed(state.iterations() * squares.size());
+}
+
+//-----------------------------------------------------------------------------
+// Name : BM_isKingInThreat ()
+//-----------------------------------------------------------------------------
+static void BM_isKingInThreat(benchmark::State& state, const char* fen)
+{
+    board chessBoard;
+    chessBoard.setFromFEN(fen);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(chessBoard.isKingInThreat());
+}
+
+//-----------------------------------------------------------------------------
+// Name : BM_isEndGame ()
+//-----------------------------------------------------------------------------
+static void BM_isEndGame(benchmark::State& state, const char* fen)
+{
+    board chessBoard;
+    chessBoard.setFromFEN(fen);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(chessBoard.isEndGame());
+}
+
+//-----------------------------------------------------------------------------
+// Name : BM_isDraw ()
+//-----------------------------------------------------------------------------
+static void BM_isDraw(benchmark::State& state, const char* fen)
+{
+    board chessBoard;
+    chessBoard.setFromFEN(fen);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(chessBoard.isDraw());
+}
+
+//-----------------------------------------------------------------------------
+// Name : BM_endTurn ()
+// Desc : the position does not change, every call reports the same turn
+//-----------------------------------------------------------------------------
+static void BM_endTurn(benchmark::State& state, const char* fen)
+{
+    board chessBoard;
+    chessBoard.setFromFEN(fen);
+
+    for (auto _ : state)
+        chessBoard.endTurn();
+}
+
+//-----------------------------------------------------------------------------
+// Name : BM_encodeSave ()
+// Desc : the save in memory, without the file and the fsync
+//-----------------------------------------------------------------------------
+static void BM_encodeSave(benchmark::State& state, const char* fen)
+{
+    board chessBoard;
+    chessBoard.setFromFEN(fen);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(chessBoard.encodeSave());
+}
+
+//-----------------------------------------------------------------------------
+// Name : BM_decodeSave ()
+//-----------------------------------------------------------------------------
+static void BM_decodeSave(benchmark::State& state, const char* fen)
+{
+    board chessBoard;
+    chessBoard.setFromFEN(fen);
+    std::vector<uint8_t> data = chessBoard.encodeSave();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(chessBoard.decodeSave(data));
+}
+
+//-----------------------------------------------------------------------------
+// Name : BM_SaveBoardToFile ()
+// Desc : the whole save as the game does it, replaceFile() syncs the new
+//        file before the rename so the disk's fsync time is most of it
+//-----------------------------------------------------------------------------
+static void BM_SaveBoardToFile(benchmark::State& state, const char* fen)
+{
+    board chessBoard;
+    useTempFiles(chessBoard);
+    chessBoard.setFromFEN(fen);
+
+    for (auto _ : state)
+        chessBoard.SaveBoardToFile();
+
+    removeTempFiles();
+}
+
+//-----------------------------------------------------------------------------
+// Name : BM_LoadBoardFromFile ()
+//-----------------------------------------------------------------------------
+static void BM_LoadBoardFromFile(benchmark::State& state, const char* fen)
+{
+    board chessBoard;
+    useTempFiles(chessBoard);
+    chessBoard.setFromFEN(fen);
+    chessBoard.SaveBoardToFile();
+
+    for (auto _ : state)
+        chessBoard.LoadBoardFromFile();
+
+    removeTempFiles();
+}
+
+//-----------------------------------------------------------------------------
+// Name : BM_createPiece ()
+// Desc : the pieces are created off the board array, they only pile up in
+//        the piece lists until the next reset
+//-----------------------------------------------------------------------------
+static void BM_createPiece(benchmark::State& state, const char* fen)
+{
+    board chessBoard;
+    chessBoard.setFromFEN(fen);
+    int64_t iterations = 0;
+
+    for (auto _ : state)
+    {
+        PIECES type = static_cast<PIECES>(iterations % KING);
+        benchmark::DoNotOptimize(chessBoard.createPiece(WHITE, type, BOARD_POINT(4, 4)));
+
+        if (++iterations % ResetInterval == 0)
+            resetBoard(state, chessBoard, fen);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : runBenchmark ()
+// Desc : with the board counters compiled in, their counts per iteration
+//        are reported next to the timing
+//-----------------------------------------------------------------------------
+static void runBenchmark(benchmark::State& state, void (*function)(benchmark::State&, const char*), const char* fen)
+{
+    board::resetStats();
+    function(state, fen);
+
+    if (!BoardStats::s_enabled)
+        return;
+
+    BoardStats stats = board::stats();
+    for (int i = 0; i < BoardStats::COUNTER_NB; i++)
+        if (stats.counters[i])
+            state.counters[BoardStats::counterName(i)] =
+                benchmark::Counter(static_cast<double>(stats.counters[i]), benchmark::Counter::kAvgIterations);
+}
+
+//-----------------------------------------------------------------------------
+// Name : registerBenchmarks ()
+// Desc : one benchmark per function and position, named function/position
+//-----------------------------------------------------------------------------
+static void registerBenchmarks()
+{
+    typedef void (*BoardBenchmark)(benchmark::State&, const char*);
+
+    struct NamedBenchmark
+    {
+        const char*    name;
+        BoardBenchmark function;
+    };
+
+    const NamedBenchmark Benchmarks[] =
+    {
+        {"validateMove",      BM_validateMove},
+        {"markPawnMoves",     BM_markPawnMoves},
+        {"isKingInThreat",    BM_isKingInThreat},
+        {"isEndGame",         BM_isEndGame},
+        {"isDraw",            BM_isDraw},
+        {"endTurn",           BM_endTurn},
+        {"encodeSave",        BM_encodeSave},
+        {"decodeSave",        BM_decodeSave},
+        {"SaveBoardToFile",   BM_SaveBoardToFile},
+        {"LoadBoardFromFile", BM_LoadBoardFromFile},
+        {"createPiece",       BM_createPiece}
+    };
+
+    for (const NamedBenchmark& curBenchmark : Benchmarks)
+        for (const BenchPosition& curPosition : BenchPositions)
+        {
+            std::string name = std::string(curBenchmark.name) + "/" + curPosition.name;
+            benchmark::RegisterBenchmark(name.c_str(), runBenchmark, curBenchmark.function, curPosition.fen);
+        }
+}
+
+//-----------------------------------------------------------------------------
+// Name : main ()
+// Desc : the results are written to ChessEngineBench.json unless another
+//        --benchmark_out is given, two such files can be compared with the
+//        compare.py tool of google benchmark
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    std::vector<char*> args(argv, argv + argc);
+    bool hasOutput = false;
+    for (int i = 1; i < argc; i++)
+        if (std::strncmp(argv[i], "--benchmark_out=", 16) == 0)
+            hasOutput = true;
+
+    std::string outArg = std::string("--benchmark_out=") + OutputFile;
+    std::string formatArg = "--benchmark_out_format=json";
+    if (!hasOutput)
+    {
+        args.push_back(&outArg[0]);
+        args.push_back(&formatArg[0]);
+    }
+
+    int argCount = static_cast<int>(args.size());
+    benchmark::Initialize(&argCount, &args[0]);
+    if (benchmark::ReportUnrecognizedArguments(argCount, &args[0]))
+        return 1;
+
+    registerBenchmarks();
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
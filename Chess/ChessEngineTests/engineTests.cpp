@@ -0,0 +1,152 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include "../ChessEngine/OpeningBook.h"
+#include "../ChessEngine/Pgn.h"
+
+namespace
+{
+    const char* const StartFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    struct KeyVector
+    {
+        const char* moves;
+        uint64_t    key;
+    };
+
+    // the test positions of the polyglot book format description, they cover
+    // castling rights, en passant and both sides to move
+    const KeyVector PolyglotVectors[] =
+    {
+        {"",                                     0x463B96181691FC9CULL},
+        {"e2e4",                                 0x823C9B50FD114196ULL},
+        {"e2e4 d7d5",                            0x0756B94461C50FB0ULL},
+        {"e2e4 d7d5 e4e5",                       0x662FAFB965DB29D4ULL},
+        {"e2e4 d7d5 e4e5 f7f5",                  0x22A48B5A8E47FF78ULL},
+        {"e2e4 d7d5 e4e5 f7f5 e1e2",             0x652A607CA3F242C1ULL},
+        {"e2e4 d7d5 e4e5 f7f5 e1e2 e8f7",        0x00FDD303C946BDD9ULL},
+        {"a2a4 b7b5 h2h4 b5b4 c2c4",             0x3C8123EA7B067637ULL},
+        {"a2a4 b7b5 h2h4 b5b4 c2c4 b4c3 a1a3",   0x5C3F9B829B279560ULL}
+    };
+
+    // movetext the pgn reader must accept, every game ends with an en passant
+    // capture followed by one more move
+    const char* const EnPassantGames[] =
+    {
+        "1. e4 a6 2. e5 f5 3. exf6 e.p. gxf6 *",
+        "1. e4 a6 2. e5 f5 3. exf6e.p. gxf6 *",
+        "1. e4 a6 2. e5 f5 3. exf6 e.p.! gxf6 *"
+    };
+    const size_t EnPassantGameMoves = 6;
+
+    //-------------------------------------------------------------------------
+    // Name : playMoves ()
+    //-------------------------------------------------------------------------
+    bool playMoves(Position& pos, const std::string& moves)
+    {
+        std::istringstream moveStream(moves);
+        std::string moveString;
+        while (moveStream >> moveString)
+        {
+            Move move = pos.parseMove(moveString);
+            if (move == MOVE_NONE)
+                return false;
+
+            UndoInfo undo;
+            pos.doMove(move, undo);
+        }
+
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    // Name : testPolyglotKey ()
+    //-------------------------------------------------------------------------
+    int testPolyglotKey()
+    {
+        int failures = 0;
+
+        for (const KeyVector& curVector : PolyglotVectors)
+        {
+            Position pos;
+            pos.setFromFEN(StartFEN);
+
+            uint64_t key = 0;
+            if (playMoves(pos, curVector.moves))
+                key = OpeningBook::polyglotKey(pos);
+
+            if (key != curVector.key)
+            {
+                std::printf("polyglotKey \"%s\" : %016llx instead of %016llx\n", curVector.moves,
+                    static_cast<unsigned long long>(key), static_cast<unsigned long long>(curVector.key));
+                failures++;
+            }
+        }
+
+        return failures;
+    }
+
+    //-------------------------------------------------------------------------
+    // Name : testPgnEnPassant ()
+    //-------------------------------------------------------------------------
+    int testPgnEnPassant()
+    {
+        int failures = 0;
+
+        for (const char* movetext : EnPassantGames)
+        {
+            PgnGameText text;
+            text.begin = movetext;
+            text.end = movetext + std::strlen(movetext);
+            text.offset = 0;
+
+            PgnGame game;
+            bool parsed = PgnReader::parseGame(text, game);
+            if (!parsed || game.moves.size() != EnPassantGameMoves || moveType(game.moves[4]) != EN_PASSANT_MOVE)
+            {
+                std::printf("pgn \"%s\" : %s, %zu moves\n", movetext,
+                    game.error.empty() ? "wrong moves" : game.error.c_str(), game.moves.size());
+                failures++;
+            }
+        }
+
+        return failures;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : main ()
+// Desc : runs every test, the exit code is the number of failed checks
+//-----------------------------------------------------------------------------
+int main()
+{
+    int failures = 0;
+    failures += testPolyglotKey();
+    failures += testPgnEnPassant();
+
+    if (failures == 0)
+        std::printf("all tests passed\n");
+
+    return failures;
+}
@@ -0,0 +1,141 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "BookMaker.h"
+#include "PgnAnalyzer.h"
+#include "../ChessEngine/Pgn.h"
+#include "../ChessEngine/GameDatabase.h"
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+    const int DefaultMaxPlies = 20;
+    const int DefaultMinGames = 2;
+}
+
+//-----------------------------------------------------------------------------
+// Name : BookMaker (constructor)
+//-----------------------------------------------------------------------------
+BookMaker::BookMaker()
+{
+    m_maxPlies = DefaultMaxPlies;
+    m_minGames = DefaultMinGames;
+}
+
+//-----------------------------------------------------------------------------
+// Name : parseArguments ()
+// Desc : argv[1] is the book command itself
+//-----------------------------------------------------------------------------
+bool BookMaker::parseArguments(int argc, char* argv[])
+{
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "-plies" && hasValue)
+            m_maxPlies = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "-min" && hasValue)
+            m_minGames = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "-db" && hasValue)
+            m_databases.push_back(argv[++i]);
+        else if (!arg.empty() && arg[0] == '-')
+            return false;
+        else if (m_bookPath.empty())
+            m_bookPath = arg;
+        else
+            PgnAnalyzer::listPgnFiles(arg, m_inputs);
+    }
+
+    return !m_bookPath.empty() && (!m_inputs.empty() || !m_databases.empty());
+}
+
+//-----------------------------------------------------------------------------
+// Name : run ()
+//-----------------------------------------------------------------------------
+bool BookMaker::run()
+{
+    int games = 0;
+    for (size_t i = 0; i < m_databases.size(); i++)
+        games += addDatabase(m_databases[i]);
+    for (size_t i = 0; i < m_inputs.size(); i++)
+        games += addPgnFile(m_inputs[i]);
+
+    if (!m_builder.write(m_bookPath, m_minGames))
+    {
+        std::cerr << "can not write " << m_bookPath << std::endl;
+        return false;
+    }
+
+    std::cerr << games << " games read, " << m_builder.getMoveCount() << " moves collected" << std::endl;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : addPgnFile ()
+// Desc : a game with an illegal move adds its moves up to it
+//-----------------------------------------------------------------------------
+int BookMaker::addPgnFile(const std::string& path)
+{
+    PgnReader reader;
+    if (!reader.open(path))
+    {
+        std::cerr << "can not read " << path << std::endl;
+        return 0;
+    }
+
+    int games = 0;
+    PgnGameText text;
+    PgnGame game;
+
+    while (reader.nextGame(text))
+    {
+        PgnReader::parseGame(text, game);
+        m_builder.addGame(game.start, game.moves, GameDatabase::parseResult(game.result), m_maxPlies);
+        games++;
+    }
+
+    return games;
+}
+
+//-----------------------------------------------------------------------------
+// Name : addDatabase ()
+//-----------------------------------------------------------------------------
+int BookMaker::addDatabase(const std::string& path)
+{
+    GameDatabase database;
+    if (!database.open(path))
+    {
+        std::cerr << "can not open the database " << path << std::endl;
+        return 0;
+    }
+
+    int games = 0;
+    database.scan([&](uint32_t, const StoredGame& game)
+    {
+        m_builder.addGame(game.start, game.moves, game.result, m_maxPlies);
+        games++;
+        return true;
+    });
+
+    return games;
+}
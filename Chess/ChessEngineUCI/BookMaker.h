@@ -0,0 +1,54 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BOOKMAKER_H_
+#define _BOOKMAKER_H_
+
+#include <string>
+#include <vector>
+#include "../ChessEngine/OpeningBookBuilder.h"
+
+// builds the opening book the game reads from data/book.bin out of pgn
+// files and game databases
+class BookMaker
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    BookMaker();
+
+    // book [-plies N] [-min N] [-db database] <book.bin> <pgn files or directories>
+    bool parseArguments(int argc, char* argv[]);
+    // returns false when the book could not be written
+    bool run();
+
+private:
+    int  addPgnFile (const std::string& path);
+    int  addDatabase(const std::string& path);
+
+    int                      m_maxPlies;
+    int                      m_minGames;
+    std::string              m_bookPath;
+    std::vector<std::string> m_databases;
+    std::vector<std::string> m_inputs;
+    OpeningBookBuilder       m_builder;
+};
+
+#endif // _BOOKMAKER_H_
@@ -0,0 +1,353 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ChildProcess.h"
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <cerrno>
+#include <signal.h>
+#include <sys/wait.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// Name : ChildProcess (constructor)
+//-----------------------------------------------------------------------------
+ChildProcess::ChildProcess()
+{
+#ifdef _WIN32
+    m_process = nullptr;
+    m_input = nullptr;
+    m_output = nullptr;
+#else
+    m_pid = -1;
+    m_input = -1;
+    m_output = -1;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Name : ChildProcess (destructor)
+//-----------------------------------------------------------------------------
+ChildProcess::~ChildProcess()
+{
+    stop();
+}
+
+#ifdef _WIN32
+
+//-----------------------------------------------------------------------------
+// Name : start ()
+//-----------------------------------------------------------------------------
+bool ChildProcess::start(const std::string& command)
+{
+    stop();
+
+    SECURITY_ATTRIBUTES attributes = {sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE};
+    HANDLE childInput, childOutput, input, output;
+    if (!CreatePipe(&childInput, &input, &attributes, 0))
+        return false;
+    if (!CreatePipe(&output, &childOutput, &attributes, 0))
+    {
+        CloseHandle(childInput);
+        CloseHandle(input);
+        return false;
+    }
+
+    // our ends of the pipes are not inherited
+    SetHandleInformation(input, HANDLE_FLAG_INHERIT, 0);
+    SetHandleInformation(output, HANDLE_FLAG_INHERIT, 0);
+
+    STARTUPINFOA startup = {};
+    startup.cb = sizeof(startup);
+    startup.dwFlags = STARTF_USESTDHANDLES;
+    startup.hStdInput = childInput;
+    startup.hStdOutput = childOutput;
+    startup.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+
+    PROCESS_INFORMATION info = {};
+    std::string commandLine = "cmd /c " + command;
+    BOOL created = CreateProcessA(nullptr, &commandLine[0], nullptr, nullptr, TRUE, 0, nullptr, nullptr, &startup, &info);
+
+    CloseHandle(childInput);
+    CloseHandle(childOutput);
+    if (!created)
+    {
+        CloseHandle(input);
+        CloseHandle(output);
+        return false;
+    }
+
+    CloseHandle(info.hThread);
+    m_process = info.hProcess;
+    m_input = input;
+    m_output = output;
+    m_buffer.clear();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : stop ()
+//-----------------------------------------------------------------------------
+void ChildProcess::stop()
+{
+    if (m_input)
+        CloseHandle(m_input);
+
+    if (m_process)
+    {
+        if (WaitForSingleObject(m_process, s_exitTimeout) != WAIT_OBJECT_0)
+            TerminateProcess(m_process, 1);
+        CloseHandle(m_process);
+    }
+
+    if (m_output)
+        CloseHandle(m_output);
+
+    m_process = nullptr;
+    m_input = nullptr;
+    m_output = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// Name : writeLine ()
+//-----------------------------------------------------------------------------
+bool ChildProcess::writeLine(const std::string& line)
+{
+    if (!m_input)
+        return false;
+
+    std::string text = line + "\n";
+    DWORD written = 0;
+    return WriteFile(m_input, text.data(), static_cast<DWORD>(text.size()), &written, nullptr) &&
+           written == text.size();
+}
+
+//-----------------------------------------------------------------------------
+// Name : readLine ()
+// Desc : anonymous pipes can not wait with a timeout, they are polled
+//-----------------------------------------------------------------------------
+bool ChildProcess::readLine(std::string& line, int timeout)
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+    for (;;)
+    {
+        size_t end = m_buffer.find('\n');
+        if (end != std::string::npos)
+        {
+            line = m_buffer.substr(0, (end > 0 && m_buffer[end - 1] == '\r') ? end - 1 : end);
+            m_buffer.erase(0, end + 1);
+            return true;
+        }
+
+        DWORD available = 0;
+        if (!m_output || !PeekNamedPipe(m_output, nullptr, 0, nullptr, &available, nullptr))
+            return false;
+
+        if (available == 0)
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        char data[4096];
+        DWORD read = 0;
+        if (!ReadFile(m_output, data, std::min<DWORD>(available, sizeof(data)), &read, nullptr) || read == 0)
+            return false;
+        m_buffer.append(data, read);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : isRunning ()
+//-----------------------------------------------------------------------------
+bool ChildProcess::isRunning() const
+{
+    return m_process && WaitForSingleObject(m_process, 0) == WAIT_TIMEOUT;
+}
+
+#else
+
+//-----------------------------------------------------------------------------
+// Name : start ()
+//-----------------------------------------------------------------------------
+bool ChildProcess::start(const std::string& command)
+{
+    stop();
+
+    int toChild[2], fromChild[2];
+    if (pipe(toChild) != 0)
+        return false;
+    if (pipe(fromChild) != 0)
+    {
+        close(toChild[0]);
+        close(toChild[1]);
+        return false;
+    }
+
+    // programs started by other threads must not inherit these pipes or
+    // they would be kept open after this program exits
+    for (int i = 0; i < 2; i++)
+    {
+        fcntl(toChild[i], F_SETFD, FD_CLOEXEC);
+        fcntl(fromChild[i], F_SETFD, FD_CLOEXEC);
+    }
+
+    // nothing may allocate between fork and exec
+    std::string shellCommand = "exec " + command;
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        dup2(toChild[0], STDIN_FILENO);
+        dup2(fromChild[1], STDOUT_FILENO);
+        execl("/bin/sh", "sh", "-c", shellCommand.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+
+    close(toChild[0]);
+    close(fromChild[1]);
+    if (pid < 0)
+    {
+        close(toChild[1]);
+        close(fromChild[0]);
+        return false;
+    }
+
+    // a program that exits must not kill us with a write to its pipe
+    signal(SIGPIPE, SIG_IGN);
+
+    m_pid = pid;
+    m_input = toChild[1];
+    m_output = fromChild[0];
+    m_buffer.clear();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : stop ()
+//-----------------------------------------------------------------------------
+void ChildProcess::stop()
+{
+    if (m_input >= 0)
+        close(m_input);
+
+    if (m_pid > 0)
+    {
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(s_exitTimeout);
+        while (waitpid(m_pid, nullptr, WNOHANG) == 0)
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                kill(m_pid, SIGKILL);
+                waitpid(m_pid, nullptr, 0);
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+
+    if (m_output >= 0)
+        close(m_output);
+
+    m_pid = -1;
+    m_input = -1;
+    m_output = -1;
+}
+
+//-----------------------------------------------------------------------------
+// Name : writeLine ()
+//-----------------------------------------------------------------------------
+bool ChildProcess::writeLine(const std::string& line)
+{
+    if (m_input < 0)
+        return false;
+
+    std::string text = line + "\n";
+    size_t done = 0;
+    while (done < text.size())
+    {
+        ssize_t written = write(m_input, text.data() + done, text.size() - done);
+        if (written <= 0)
+            return false;
+        done += written;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : readLine ()
+//-----------------------------------------------------------------------------
+bool ChildProcess::readLine(std::string& line, int timeout)
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+    for (;;)
+    {
+        size_t end = m_buffer.find('\n');
+        if (end != std::string::npos)
+        {
+            line = m_buffer.substr(0, (end > 0 && m_buffer[end - 1] == '\r') ? end - 1 : end);
+            m_buffer.erase(0, end + 1);
+            return true;
+        }
+
+        if (m_output < 0)
+            return false;
+
+        int remaining = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                            deadline - std::chrono::steady_clock::now()).count());
+        if (remaining <= 0)
+            return false;
+
+        pollfd descriptor = {m_output, POLLIN, 0};
+        int ready = poll(&descriptor, 1, remaining);
+        if (ready < 0 && errno == EINTR)
+            continue;
+        if (ready <= 0)
+            return false;
+
+        char data[4096];
+        ssize_t count = read(m_output, data, sizeof(data));
+        if (count <= 0)
+            return false;
+        m_buffer.append(data, count);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : isRunning ()
+//-----------------------------------------------------------------------------
+bool ChildProcess::isRunning() const
+{
+    return m_pid > 0 && waitpid(m_pid, nullptr, WNOHANG) == 0;
+}
+
+#endif
@@ -0,0 +1,72 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHILDPROCESS_H_
+#define _CHILDPROCESS_H_
+
+#include <string>
+
+// a program started with its standard input and output connected to pipes,
+// talked to line by line like a uci engine
+class ChildProcess
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    ChildProcess();
+    // ends the program if it is still running
+    ~ChildProcess();
+
+    ChildProcess(const ChildProcess&) = delete;
+    ChildProcess& operator=(const ChildProcess&) = delete;
+
+    // the command is run by the shell so it may hold arguments
+    bool start(const std::string& command);
+    // closes the input of the program, waits a moment for it to exit and
+    // kills it otherwise
+    void stop ();
+
+    bool writeLine(const std::string& line);
+    // returns false when no whole line came within the timeout(ms) or the
+    // program has exited
+    bool readLine (std::string& line, int timeout);
+
+    //-------------------------------------------------------------------------
+    // Get methods for this class
+    //-------------------------------------------------------------------------
+    bool isRunning() const;
+
+    static const int s_exitTimeout = 1000;  // ms
+
+private:
+    std::string m_buffer;      // read and not returned yet
+
+#ifdef _WIN32
+    void* m_process;
+    void* m_input;
+    void* m_output;
+#else
+    int   m_pid;
+    int   m_input;             // written to the program
+    int   m_output;            // read from the program
+#endif
+};
+
+#endif // _CHILDPROCESS_H_
@@ -0,0 +1,117 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "GameImporter.h"
+#include "PgnAnalyzer.h"
+#include <iostream>
+#include <chrono>
+
+//-----------------------------------------------------------------------------
+// Name : GameImporter (constructor)
+//-----------------------------------------------------------------------------
+GameImporter::GameImporter()
+{}
+
+//-----------------------------------------------------------------------------
+// Name : parseArguments ()
+// Desc : argv[1] is the import command itself
+//-----------------------------------------------------------------------------
+bool GameImporter::parseArguments(int argc, char* argv[])
+{
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (!arg.empty() && arg[0] == '-')
+            return false;
+
+        if (m_databasePath.empty())
+            m_databasePath = arg;
+        else
+            PgnAnalyzer::listPgnFiles(arg, m_inputs);
+    }
+
+    return !m_databasePath.empty() && !m_inputs.empty();
+}
+
+//-----------------------------------------------------------------------------
+// Name : run ()
+//-----------------------------------------------------------------------------
+int GameImporter::run()
+{
+    if (!m_database.open(m_databasePath))
+    {
+        std::cerr << "can not open the database " << m_databasePath << std::endl;
+        return 0;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    int games = 0;
+    for (size_t i = 0; i < m_inputs.size(); i++)
+        games += importFile(m_inputs[i]);
+
+    m_database.close();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << games << " games imported in " << seconds << "s" << std::endl;
+    return games;
+}
+
+//-----------------------------------------------------------------------------
+// Name : importFile ()
+//-----------------------------------------------------------------------------
+int GameImporter::importFile(const std::string& path)
+{
+    PgnReader reader;
+    if (!reader.open(path))
+    {
+        std::cerr << "can not read " << path << std::endl;
+        return 0;
+    }
+
+    int games = 0;
+    PgnGameText text;
+    PgnGame game;
+    StoredGame stored;
+
+    while (reader.nextGame(text))
+    {
+        if (!PgnReader::parseGame(text, game))
+            std::cerr << path << " (offset " << text.offset << "): " << game.error
+                      << ", the game is imported up to it" << std::endl;
+
+        stored.whitePlayer = m_database.addPlayer(game.getTag("White"));
+        stored.blackPlayer = m_database.addPlayer(game.getTag("Black"));
+        stored.date        = GameDatabase::parseDate(game.getTag("Date"));
+        stored.result      = GameDatabase::parseResult(game.result);
+        stored.start       = game.start;
+        stored.moves.swap(game.moves);
+
+        if (m_database.addGame(stored) == GameDatabase::s_invalidId)
+        {
+            std::cerr << path << " (offset " << text.offset << "): the game can not be stored" << std::endl;
+            break;
+        }
+
+        games++;
+    }
+
+    return games;
+}
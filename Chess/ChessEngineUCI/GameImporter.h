@@ -0,0 +1,52 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _GAMEIMPORTER_H_
+#define _GAMEIMPORTER_H_
+
+#include <string>
+#include <vector>
+#include "../ChessEngine/Pgn.h"
+#include "../ChessEngine/GameDatabase.h"
+
+// copies the games of pgn files into a game database.
+// games with an illegal move are stored up to that move, like the analyzer
+// reads them
+class GameImporter
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    GameImporter();
+
+    // import <database> <pgn files or directories>
+    bool parseArguments(int argc, char* argv[]);
+    // returns the number of games imported
+    int  run();
+
+private:
+    int  importFile(const std::string& path);
+
+    std::string              m_databasePath;
+    std::vector<std::string> m_inputs;
+    GameDatabase             m_database;
+};
+
+#endif // _GAMEIMPORTER_H_
@@ -0,0 +1,302 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "MatchPlayer.h"
+#include <sstream>
+#include <chrono>
+
+//-----------------------------------------------------------------------------
+// Name : PlayerMove (constructor)
+//-----------------------------------------------------------------------------
+PlayerMove::PlayerMove()
+{
+    move = MOVE_NONE;
+    score = VALUE_NONE;
+    depth = 0;
+    nodes = 0;
+    time = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : EnginePlayer (constructor)
+//-----------------------------------------------------------------------------
+EnginePlayer::EnginePlayer(const std::string& name, size_t hashMB)
+    : m_name(name), m_tt(hashMB), m_search(m_tt)
+{}
+
+//-----------------------------------------------------------------------------
+// Name : newGame ()
+//-----------------------------------------------------------------------------
+bool EnginePlayer::newGame()
+{
+    m_tt.clear();
+    m_search.clearHistory();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : go ()
+//-----------------------------------------------------------------------------
+bool EnginePlayer::go(const Position& start, const std::vector<Move>& moves,
+                      const SearchLimits& limits, PlayerMove& result)
+{
+    Position pos = start;
+    std::vector<uint64_t> history;
+    history.reserve(moves.size());
+
+    for (size_t i = 0; i < moves.size(); i++)
+    {
+        history.push_back(pos.key());
+        UndoInfo undo;
+        pos.doMove(moves[i], undo);
+    }
+
+    m_tt.newSearch();
+    m_timeManager.start(limits, pos.sideToMove());
+    SearchResult searchResult = m_search.think(pos, history, limits, m_timeManager);
+
+    // a search stopped inside its first iteration has no score, it stays
+    // VALUE_NONE with a depth of 0
+    result.move = searchResult.bestMove;
+    result.score = searchResult.score;
+    result.depth = searchResult.depth;
+    result.nodes = searchResult.nodes;
+    result.time = m_timeManager.getElapsed();
+    return result.move != MOVE_NONE;
+}
+
+//-----------------------------------------------------------------------------
+// Name : getName ()
+//-----------------------------------------------------------------------------
+std::string EnginePlayer::getName() const
+{
+    return m_name;
+}
+
+//-----------------------------------------------------------------------------
+// Name : UciPlayer (constructor)
+//-----------------------------------------------------------------------------
+UciPlayer::UciPlayer(const std::string& name, const std::string& command, size_t hashMB)
+    : m_name(name), m_command(command), m_hashMB(hashMB)
+{
+    m_ready = false;
+}
+
+//-----------------------------------------------------------------------------
+// Name : UciPlayer (destructor)
+//-----------------------------------------------------------------------------
+UciPlayer::~UciPlayer()
+{
+    quit();
+}
+
+//-----------------------------------------------------------------------------
+// Name : start ()
+//-----------------------------------------------------------------------------
+bool UciPlayer::start()
+{
+    quit();
+
+    std::string line;
+    if (!m_process.start(m_command) || !m_process.writeLine("uci") || !waitFor("uciok", s_startTimeout, line))
+    {
+        quit();
+        return false;
+    }
+
+    m_process.writeLine("setoption name Hash value " + std::to_string(m_hashMB));
+    m_process.writeLine("isready");
+    m_ready = waitFor("readyok", s_startTimeout, line);
+    if (!m_ready)
+        quit();
+
+    return m_ready;
+}
+
+//-----------------------------------------------------------------------------
+// Name : quit ()
+//-----------------------------------------------------------------------------
+void UciPlayer::quit()
+{
+    if (m_process.isRunning())
+        m_process.writeLine("quit");
+
+    m_process.stop();
+    m_ready = false;
+}
+
+//-----------------------------------------------------------------------------
+// Name : newGame ()
+//-----------------------------------------------------------------------------
+bool UciPlayer::newGame()
+{
+    if ((!m_ready || !m_process.isRunning()) && !start())
+        return false;
+
+    std::string line;
+    m_process.writeLine("ucinewgame");
+    m_process.writeLine("isready");
+    if (!waitFor("readyok", s_startTimeout, line))
+    {
+        quit();
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : go ()
+// Desc : an engine that does not answer within its clock is stopped and
+//        restarted before its next game
+//-----------------------------------------------------------------------------
+bool UciPlayer::go(const Position& start, const std::vector<Move>& moves,
+                   const SearchLimits& limits, PlayerMove& result)
+{
+    if (!m_ready)
+        return false;
+
+    Position pos = start;
+    for (size_t i = 0; i < moves.size(); i++)
+    {
+        UndoInfo undo;
+        pos.doMove(moves[i], undo);
+    }
+
+    std::ostringstream position;
+    position << "position fen " << start.toFEN();
+    if (!moves.empty())
+    {
+        position << " moves";
+        for (size_t i = 0; i < moves.size(); i++)
+            position << " " << moveToString(moves[i]);
+    }
+
+    std::ostringstream go;
+    go << "go";
+    int timeout = s_searchTimeout;
+    if (limits.time[BOTTOM] || limits.time[UPPER])
+    {
+        go << " wtime " << limits.time[BOTTOM] << " btime " << limits.time[UPPER]
+           << " winc " << limits.increment[BOTTOM] << " binc " << limits.increment[UPPER];
+        timeout = limits.time[pos.sideToMove()] + s_timeMargin;
+    }
+    if (limits.moveTime)
+    {
+        go << " movetime " << limits.moveTime;
+        timeout = limits.moveTime + s_timeMargin;
+    }
+    if (limits.nodes)
+        go << " nodes " << limits.nodes;
+    if (limits.depth)
+        go << " depth " << limits.depth;
+
+    m_process.writeLine(position.str());
+    m_process.writeLine(go.str());
+
+    std::string line;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (;;)
+    {
+        int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+        if (elapsed >= timeout || !m_process.readLine(line, static_cast<int>(timeout - elapsed)))
+        {
+            quit();
+            return false;
+        }
+
+        if (line.compare(0, 5, "info ") == 0)
+            parseInfo(line, result);
+        else if (line.compare(0, 9, "bestmove ") == 0)
+            break;
+    }
+
+    result.time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+
+    std::istringstream bestMove(line.substr(9));
+    std::string moveString;
+    bestMove >> moveString;
+    result.move = pos.parseMove(moveString);
+    return result.move != MOVE_NONE;
+}
+
+//-----------------------------------------------------------------------------
+// Name : getName ()
+//-----------------------------------------------------------------------------
+std::string UciPlayer::getName() const
+{
+    return m_name;
+}
+
+//-----------------------------------------------------------------------------
+// Name : waitFor ()
+//-----------------------------------------------------------------------------
+bool UciPlayer::waitFor(const std::string& token, int timeout, std::string& line)
+{
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (;;)
+    {
+        int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+        if (elapsed >= timeout || !m_process.readLine(line, static_cast<int>(timeout - elapsed)))
+            return false;
+
+        if (line.compare(0, token.size(), token) == 0)
+            return true;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : parseInfo ()
+// Desc : keeps the depth, score and nodes of the last report of the best line
+//-----------------------------------------------------------------------------
+void UciPlayer::parseInfo(const std::string& line, PlayerMove& result) const
+{
+    std::istringstream tokens(line);
+    std::string token;
+
+    while (tokens >> token)
+    {
+        if (token == "depth")
+            tokens >> result.depth;
+        else if (token == "nodes")
+            tokens >> result.nodes;
+        else if (token == "multipv")
+        {
+            // the other lines do not score the move that is played
+            int multiPV = 1;
+            tokens >> multiPV;
+            if (multiPV != 1)
+                return;
+        }
+        else if (token == "score")
+        {
+            std::string type;
+            int value = 0;
+            tokens >> type >> value;
+
+            if (type == "cp")
+                result.score = value;
+            else if (type == "mate")
+                result.score = (value > 0) ? VALUE_MATE - (2 * value - 1) : -VALUE_MATE + 2 * -value;
+        }
+        else if (token == "pv" || token == "string")
+            break;
+    }
+}
@@ -0,0 +1,110 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MATCHPLAYER_H_
+#define _MATCHPLAYER_H_
+
+#include <string>
+#include <vector>
+#include "../ChessEngine/Search.h"
+#include "ChildProcess.h"
+
+// what a player answered for a position
+struct PlayerMove
+{
+    PlayerMove();
+
+    Move     move;
+    int      score;     // from the point of view of the side that moved, VALUE_NONE when unknown
+    int      depth;     // 0 when the move was played before the first iteration finished
+    uint64_t nodes;
+    int64_t  time;      // ms the player thought
+};
+
+// one side of the games the tournament runner plays
+class MatchPlayer
+{
+public:
+    virtual ~MatchPlayer() {}
+
+    virtual bool        newGame() = 0;
+    // searches the last position of the game, start plus moves
+    virtual bool        go     (const Position& start, const std::vector<Move>& moves,
+                                const SearchLimits& limits, PlayerMove& result) = 0;
+    virtual std::string getName() const = 0;
+};
+
+// the engine of this build searching on the calling thread with a hash
+// table of its own
+class EnginePlayer : public MatchPlayer
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    EnginePlayer(const std::string& name, size_t hashMB);
+
+    virtual bool        newGame();
+    virtual bool        go     (const Position& start, const std::vector<Move>& moves,
+                                const SearchLimits& limits, PlayerMove& result);
+    virtual std::string getName() const;
+
+private:
+    std::string        m_name;
+    TranspositionTable m_tt;
+    Search             m_search;
+    TimeManager        m_timeManager;
+};
+
+// a uci engine run as a child process, the command names the program and
+// its arguments. the program is started with the first game and restarted
+// after it failed to answer
+class UciPlayer : public MatchPlayer
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    UciPlayer(const std::string& name, const std::string& command, size_t hashMB);
+    ~UciPlayer();
+
+    virtual bool        newGame();
+    virtual bool        go     (const Position& start, const std::vector<Move>& moves,
+                                const SearchLimits& limits, PlayerMove& result);
+    virtual std::string getName() const;
+
+private:
+    bool start    ();
+    void quit     ();
+    // reads lines until one starts with token
+    bool waitFor  (const std::string& token, int timeout, std::string& line);
+    void parseInfo(const std::string& line, PlayerMove& result) const;
+
+    std::string  m_name;
+    std::string  m_command;
+    size_t       m_hashMB;
+    ChildProcess m_process;
+    bool         m_ready;
+
+    static const int s_startTimeout  = 10000;  // ms
+    static const int s_searchTimeout = 60000;  // ms, when the search has no clock
+    static const int s_timeMargin    = 1000;   // ms past the clock before giving up
+};
+
+#endif // _MATCHPLAYER_H_
@@ -0,0 +1,366 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PgnAnalyzer.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// Name : PgnAnalyzer (constructor)
+//-----------------------------------------------------------------------------
+PgnAnalyzer::PgnAnalyzer()
+{
+    m_threadCount = 0;
+    m_hashMB = 64;
+    m_written = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : parseArguments ()
+// Desc : argv[1] is the analyze command itself
+//-----------------------------------------------------------------------------
+bool PgnAnalyzer::parseArguments(int argc, char* argv[])
+{
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "-depth" && hasValue)
+            m_limits.depth = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "-nodes" && hasValue)
+            m_limits.nodes = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "-threads" && hasValue)
+            m_threadCount = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "-hash" && hasValue)
+            m_hashMB = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "-o" && hasValue)
+            m_outputPath = argv[++i];
+        else if (!arg.empty() && arg[0] == '-')
+            return false;
+        else
+            listPgnFiles(arg, m_inputs);
+    }
+
+    if (m_limits.depth == 0 && m_limits.nodes == 0)
+        m_limits.depth = s_defaultDepth;
+
+    return !m_inputs.empty();
+}
+
+//-----------------------------------------------------------------------------
+// Name : run ()
+//-----------------------------------------------------------------------------
+int PgnAnalyzer::run()
+{
+    std::ofstream file;
+    if (!m_outputPath.empty())
+    {
+        file.open(m_outputPath.c_str());
+        if (!file)
+        {
+            std::cerr << "can not write " << m_outputPath << std::endl;
+            return 0;
+        }
+    }
+    std::ostream& out = m_outputPath.empty() ? std::cout : file;
+
+    ThreadPool pool(m_threadCount);
+
+    // the table is shared by all the workers and aged once for the whole run,
+    // its generation is not safe to bump while other searches use it
+    m_tt.reset(new TranspositionTable(m_hashMB));
+    m_tt->newSearch();
+
+    for (int i = 0; i < pool.getThreadCount(); i++)
+    {
+        m_searches.push_back(std::unique_ptr<Search>(new Search(*m_tt)));
+        m_timeManagers.push_back(std::unique_ptr<TimeManager>(new TimeManager));
+    }
+
+    int games = 0;
+    for (size_t i = 0; i < m_inputs.size(); i++)
+        games += analyzeFile(m_inputs[i], pool, out);
+
+    pool.wait();
+    writeFinished(out, false);
+
+    std::cerr << "analyzed " << games << " games" << std::endl;
+    return games;
+}
+
+//-----------------------------------------------------------------------------
+// Name : analyzeFile ()
+// Desc : splits the file into games and hands them to the pool, which parses
+//        and analyzes them, while writing the ones that are done so only a
+//        few games per worker are held in memory
+//-----------------------------------------------------------------------------
+int PgnAnalyzer::analyzeFile(const std::string& path, ThreadPool& pool, std::ostream& out)
+{
+    // the games point into the mapping, it is closed with the last of them
+    std::shared_ptr<PgnReader> reader(new PgnReader);
+    if (!reader->open(path))
+    {
+        std::cerr << "can not read " << path << std::endl;
+        return 0;
+    }
+
+    size_t maxInFlight = static_cast<size_t>(pool.getThreadCount() * s_gamesInFlight);
+    int games = 0;
+    PgnGameText text;
+
+    while (reader->nextGame(text))
+    {
+        std::unique_ptr<GameJob> job(new GameJob);
+        job->reader = reader;
+        job->text = text;
+        job->source = path;
+        job->done = false;
+
+        GameJob* jobPtr = job.get();
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            m_pending.push_back(std::move(job));
+        }
+
+        pool.submit([this, jobPtr](int worker)
+        {
+            if (!PgnReader::parseGame(jobPtr->text, jobPtr->game))
+            {
+                std::ostringstream ss;
+                ss << jobPtr->source << " (offset " << jobPtr->text.offset << "): "
+                   << jobPtr->game.error << ", the game is analyzed up to it\n";
+                std::cerr << ss.str();
+            }
+
+            analyzeGame(*jobPtr, *m_searches[worker], *m_timeManagers[worker]);
+
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            jobPtr->done = true;
+            m_jobDone.notify_all();
+        });
+        games++;
+
+        bool full;
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            full = m_pending.size() >= maxInFlight;
+        }
+        writeFinished(out, full);
+    }
+
+    return games;
+}
+
+//-----------------------------------------------------------------------------
+// Name : analyzeGame ()
+// Desc : searches every position of the game once. the comment of a move is
+//        the evaluation of the position it leads to and the move the search
+//        preferred instead, when that was not the move played
+//-----------------------------------------------------------------------------
+void PgnAnalyzer::analyzeGame(GameJob& job, Search& search, TimeManager& timeManager)
+{
+    struct PositionResult
+    {
+        int  score;
+        Move bestMove;
+        int  sideToMove;
+        bool mated;
+    };
+
+    const std::vector<Move>& moves = job.game.moves;
+    std::vector<PositionResult> results(moves.size() + 1);
+
+    search.clearHistory();
+
+    Position pos = job.game.start;
+    std::vector<uint64_t> history;
+
+    for (size_t i = 0; i <= moves.size(); i++)
+    {
+        PositionResult& result = results[i];
+        result.score = 0;
+        result.bestMove = MOVE_NONE;
+        result.sideToMove = pos.sideToMove();
+        result.mated = false;
+
+        if (!pos.hasLegalMove())
+            result.mated = pos.inCheck();
+        else
+        {
+            timeManager.start(m_limits, pos.sideToMove());
+            SearchResult searchResult = search.think(pos, history, m_limits, timeManager);
+            result.score = searchResult.score;
+            result.bestMove = searchResult.bestMove;
+        }
+
+        if (i == moves.size())
+            break;
+
+        history.push_back(pos.key());
+        UndoInfo undo;
+        pos.doMove(moves[i], undo);
+    }
+
+    pos = job.game.start;
+    job.comments.resize(moves.size());
+
+    for (size_t i = 0; i < moves.size(); i++)
+    {
+        const PositionResult& next = results[i + 1];
+        Move bestMove = results[i].bestMove;
+
+        std::string comment;
+        // the san of a mating move already says it all
+        if (!next.mated)
+            comment = "[%eval " + evalToString(next.score, next.sideToMove) + "]";
+
+        if (bestMove != MOVE_NONE && bestMove != moves[i])
+            comment += (comment.empty() ? "best " : " best ") + moveToSAN(pos, bestMove);
+
+        job.comments[i] = comment;
+
+        UndoInfo undo;
+        pos.doMove(moves[i], undo);
+    }
+
+    std::ostringstream annotator;
+    annotator << "ChessEngineUCI ";
+    if (m_limits.depth)
+        annotator << "depth " << m_limits.depth;
+    else
+        annotator << "nodes " << m_limits.nodes;
+    job.game.setTag("Annotator", annotator.str());
+}
+
+//-----------------------------------------------------------------------------
+// Name : writeFinished ()
+// Desc : writes the finished games at the front of the queue, keeping the
+//        input order. waitForFirst blocks until at least one is written
+//-----------------------------------------------------------------------------
+void PgnAnalyzer::writeFinished(std::ostream& out, bool waitForFirst)
+{
+    for (;;)
+    {
+        std::unique_ptr<GameJob> job;
+        {
+            std::unique_lock<std::mutex> lock(m_pendingMutex);
+            if (waitForFirst)
+                m_jobDone.wait(lock, [this] { return m_pending.empty() || m_pending.front()->done; });
+
+            if (m_pending.empty() || !m_pending.front()->done)
+                return;
+
+            job = std::move(m_pending.front());
+            m_pending.pop_front();
+        }
+
+        writePgn(out, job->game, job->comments);
+        out.flush();
+        waitForFirst = false;
+
+        m_written++;
+        if (m_written % 10 == 0)
+            std::cerr << "analyzed " << m_written << " games" << std::endl;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : evalToString ()
+//-----------------------------------------------------------------------------
+std::string PgnAnalyzer::evalToString(int score, int sideToMove)
+{
+    if (sideToMove != BOTTOM)
+        score = -score;
+
+    std::ostringstream ss;
+    if (Search::isMateScore(score))
+    {
+        int plies = VALUE_MATE - std::abs(score);
+        int moves = (plies + 1) / 2;
+        ss << "#" << (score > 0 ? moves : -moves);
+    }
+    else
+        ss << (score < 0 ? "-" : "") << std::abs(score) / 100 << "."
+           << std::setw(2) << std::setfill('0') << std::abs(score) % 100;
+
+    return ss.str();
+}
+
+//-----------------------------------------------------------------------------
+// Name : listPgnFiles ()
+// Desc : a file is taken as is, a directory adds the .pgn files in it
+//-----------------------------------------------------------------------------
+void PgnAnalyzer::listPgnFiles(const std::string& path, std::vector<std::string>& files)
+{
+    std::vector<std::string> found;
+
+#ifdef _WIN32
+    DWORD attributes = GetFileAttributesA(path.c_str());
+    if (attributes == INVALID_FILE_ATTRIBUTES || !(attributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+        files.push_back(path);
+        return;
+    }
+
+    WIN32_FIND_DATAA data;
+    HANDLE handle = FindFirstFileA((path + "\\*.pgn").c_str(), &data);
+    if (handle != INVALID_HANDLE_VALUE)
+    {
+        do
+            found.push_back(path + "\\" + data.cFileName);
+        while (FindNextFileA(handle, &data));
+        FindClose(handle);
+    }
+#else
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0 || !S_ISDIR(info.st_mode))
+    {
+        files.push_back(path);
+        return;
+    }
+
+    DIR* dir = opendir(path.c_str());
+    if (dir)
+    {
+        while (dirent* entry = readdir(dir))
+        {
+            std::string name = entry->d_name;
+            if (name.size() > 4 && name.compare(name.size() - 4, 4, ".pgn") == 0)
+                found.push_back(path + "/" + name);
+        }
+        closedir(dir);
+    }
+#endif
+
+    // directory order is arbitrary, keep the output reproducible
+    std::sort(found.begin(), found.end());
+    files.insert(files.end(), found.begin(), found.end());
+}
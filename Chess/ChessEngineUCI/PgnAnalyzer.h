@@ -0,0 +1,92 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _PGNANALYZER_H_
+#define _PGNANALYZER_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include "../ChessEngine/Pgn.h"
+#include "../ChessEngine/Search.h"
+#include "../ChessEngine/ThreadPool.h"
+
+// batch analysis of pgn files.
+// every position of every game is searched to a fixed depth or node count and
+// the games are written back with the evaluation and the best move as comments.
+// games are analyzed in parallel, one game per task of a work stealing pool,
+// each worker with its own search while the transposition table is shared
+class PgnAnalyzer
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    PgnAnalyzer();
+
+    // analyze [-depth N] [-nodes N] [-threads N] [-hash MB] [-o file] <pgn files or directories>
+    bool parseArguments(int argc, char* argv[]);
+    // returns the number of games analyzed
+    int  run();
+
+    // "0.35", "-1.20" or "#3", "#-2" from white's point of view
+    static std::string evalToString(int score, int sideToMove);
+    // a directory adds the .pgn files it holds
+    static void        listPgnFiles(const std::string& path, std::vector<std::string>& files);
+
+private:
+    struct GameJob
+    {
+        std::shared_ptr<PgnReader> reader;
+        PgnGameText                text;
+        std::string                source;
+        PgnGame                    game;
+        std::vector<std::string>   comments;
+        bool                       done;
+    };
+
+    int  analyzeFile(const std::string& path, ThreadPool& pool, std::ostream& out);
+    void analyzeGame(GameJob& job, Search& search, TimeManager& timeManager);
+    void writeFinished(std::ostream& out, bool waitForFirst);
+
+    SearchLimits             m_limits;
+    int                      m_threadCount;
+    int                      m_hashMB;
+    std::string              m_outputPath;
+    std::vector<std::string> m_inputs;
+
+    std::unique_ptr<TranspositionTable>   m_tt;
+    std::vector<std::unique_ptr<Search>>      m_searches;       // [worker]
+    std::vector<std::unique_ptr<TimeManager>> m_timeManagers;   // [worker]
+
+    // games in input order, written as soon as the oldest one is done
+    std::deque<std::unique_ptr<GameJob>> m_pending;
+    std::mutex               m_pendingMutex;
+    std::condition_variable  m_jobDone;
+    int                      m_written;
+
+    static const int s_defaultDepth = 10;
+    static const int s_gamesInFlight = 4;   // per worker
+};
+
+#endif // _PGNANALYZER_H_
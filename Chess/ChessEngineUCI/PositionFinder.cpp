@@ -0,0 +1,143 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PositionFinder.h"
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+// Name : PositionFinder (constructor)
+//-----------------------------------------------------------------------------
+PositionFinder::PositionFinder()
+{
+    m_build = false;
+    m_threadCount = 0;
+    m_memoryMB = PositionIndex::s_defaultMemoryMB;
+}
+
+//-----------------------------------------------------------------------------
+// Name : parseArguments ()
+// Desc : argv[1] is the index or find command itself
+//-----------------------------------------------------------------------------
+bool PositionFinder::parseArguments(int argc, char* argv[])
+{
+    m_build = std::string(argv[1]) == "index";
+
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (m_build && arg == "-threads" && hasValue)
+            m_threadCount = std::max(0, std::atoi(argv[++i]));
+        else if (m_build && arg == "-memory" && hasValue)
+            m_memoryMB = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        else if (m_databasePath.empty())
+            m_databasePath = arg;
+        else if (!m_build && m_fen.empty())
+            m_fen = arg;
+        else if (!m_build)
+            m_fen += " " + arg;     // an unquoted fen comes as several arguments
+        else
+            return false;
+    }
+
+    return !m_databasePath.empty() && (m_build || !m_fen.empty());
+}
+
+//-----------------------------------------------------------------------------
+// Name : run ()
+//-----------------------------------------------------------------------------
+bool PositionFinder::run()
+{
+    return m_build ? buildIndex() : findPosition();
+}
+
+//-----------------------------------------------------------------------------
+// Name : buildIndex ()
+//-----------------------------------------------------------------------------
+bool PositionFinder::buildIndex()
+{
+    GameDatabase database;
+    if (!database.open(m_databasePath))
+    {
+        std::cerr << "can not open the database " << m_databasePath << std::endl;
+        return false;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (!PositionIndex::build(database, m_databasePath + ".cpx", m_threadCount, m_memoryMB))
+    {
+        std::cerr << "can not build the index of " << m_databasePath << std::endl;
+        return false;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    PositionIndex index;
+    index.open(m_databasePath + ".cpx");
+    std::cerr << index.getGameCount() << " games, " << index.getKeyCount() << " positions, "
+              << index.getPostingCount() << " postings indexed in " << seconds << "s" << std::endl;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : findPosition ()
+// Desc : one line per hit : id, players, date, result and the ply the
+//        position was reached at
+//-----------------------------------------------------------------------------
+bool PositionFinder::findPosition()
+{
+    GameDatabase database;
+    PositionIndex index;
+    if (!database.open(m_databasePath) || !index.open(m_databasePath + ".cpx"))
+    {
+        std::cerr << "can not open the database or the index of " << m_databasePath << std::endl;
+        return false;
+    }
+
+    Position pos;
+    if (!pos.setFromFEN(m_fen))
+    {
+        std::cerr << "invalid fen " << m_fen << std::endl;
+        return false;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<PositionHit> hits;
+    index.find(pos, hits);
+    double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    for (size_t i = 0; i < hits.size(); i++)
+    {
+        if (hits[i].gameId >= database.getGameCount())
+            continue;
+
+        const GameIndexEntry& entry = database.getEntry(hits[i].gameId);
+        std::cout << hits[i].gameId << "\t" << database.getPlayerName(entry.whitePlayer) << " - "
+                  << database.getPlayerName(entry.blackPlayer) << "\t" << entry.date << "\t"
+                  << GameDatabase::resultString(static_cast<GameResult>(entry.result))
+                  << "\tply " << hits[i].ply << "\n";
+    }
+
+    std::cerr << hits.size() << " games found in " << millis << "ms" << std::endl;
+    return true;
+}
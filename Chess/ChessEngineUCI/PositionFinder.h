@@ -0,0 +1,54 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _POSITIONFINDER_H_
+#define _POSITIONFINDER_H_
+
+#include <string>
+#include "../ChessEngine/GameDatabase.h"
+#include "../ChessEngine/PositionIndex.h"
+
+// builds the position index of a game database(database.cpx next to its
+// files) and lists the games that reached a position
+class PositionFinder
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    PositionFinder();
+
+    // index [-threads N] [-memory MB] <database>
+    // find <database> <fen>
+    bool parseArguments(int argc, char* argv[]);
+    // returns false when the database or the index can not be read
+    bool run();
+
+private:
+    bool buildIndex  ();
+    bool findPosition();
+
+    bool        m_build;
+    int         m_threadCount;
+    size_t      m_memoryMB;
+    std::string m_databasePath;
+    std::string m_fen;
+};
+
+#endif // _POSITIONFINDER_H_
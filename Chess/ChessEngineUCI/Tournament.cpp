@@ -0,0 +1,622 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Tournament.h"
+#include "PgnAnalyzer.h"
+#include "../ChessEngine/ThreadPool.h"
+#include "../ChessEngine/DrawRules.h"
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <ctime>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+namespace
+{
+    const char* DefaultTimeControl = "10+0.1";
+
+    std::string dateTag()
+    {
+        std::time_t now = std::time(nullptr);
+        std::tm* date = std::localtime(&now);
+        if (date == nullptr)
+            return "????.??.??";
+
+        std::ostringstream ss;
+        ss << date->tm_year + 1900 << "." << std::setw(2) << std::setfill('0') << date->tm_mon + 1
+           << "." << std::setw(2) << std::setfill('0') << date->tm_mday;
+        return ss.str();
+    }
+
+    double scoreToElo(double score)
+    {
+        // scores of 0 or 1 have no finite elo
+        const double epsilon = 1e-6;
+        score = std::min(1.0 - epsilon, std::max(epsilon, score));
+        return -400.0 * std::log10(1.0 / score - 1.0);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : Tournament (constructor)
+//-----------------------------------------------------------------------------
+Tournament::Tournament()
+{
+    m_gameCount = s_defaultGames;
+    m_concurrency = 0;
+    m_hashMB = s_defaultHashMB;
+    m_baseTime = 0;
+    m_increment = 0;
+    m_names[0] = "ChessEngine A";
+    m_names[1] = "ChessEngine B";
+    m_sprt = false;
+    m_elo0 = 0.0;
+    m_elo1 = 5.0;
+    m_alpha = 0.05;
+    m_beta = 0.05;
+    m_sprtResult = SPRT_NONE;
+    m_llr = 0.0;
+    m_nextRound = 0;
+    m_stop = false;
+    m_played = 0;
+    m_wins = 0;
+    m_losses = 0;
+    m_draws = 0;
+    m_nodes[0] = m_nodes[1] = 0;
+    m_thinkTime[0] = m_thinkTime[1] = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : parseArguments ()
+// Desc : argv[1] is the selfplay or sprt command itself. without any limit
+//        the games are played at 10 seconds plus 0.1 second per move
+//-----------------------------------------------------------------------------
+bool Tournament::parseArguments(int argc, char* argv[])
+{
+    m_sprt = std::string(argv[1]) == "sprt";
+    if (m_sprt)
+        m_gameCount = s_defaultSprtGames;
+
+    int engines = 0;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+            return false;
+
+        if (arg == "-engine" && engines < 2)
+            m_commands[engines++] = argv[++i];
+        else if (arg == "-games")
+            m_gameCount = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "-concurrency")
+            m_concurrency = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "-hash")
+            m_hashMB = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        else if (arg == "-tc")
+            m_timeControl = argv[++i];
+        else if (arg == "-movetime")
+            m_limits.moveTime = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "-nodes")
+            m_limits.nodes = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "-depth")
+            m_limits.depth = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "-openings")
+            m_openingsPath = argv[++i];
+        else if (arg == "-o")
+            m_outputPath = argv[++i];
+        else if (m_sprt && arg == "-elo0")
+            m_elo0 = std::atof(argv[++i]);
+        else if (m_sprt && arg == "-elo1")
+            m_elo1 = std::atof(argv[++i]);
+        else if (m_sprt && arg == "-alpha")
+            m_alpha = std::atof(argv[++i]);
+        else if (m_sprt && arg == "-beta")
+            m_beta = std::atof(argv[++i]);
+        else
+            return false;
+    }
+
+    if (m_sprt && (m_elo1 <= m_elo0 || m_alpha <= 0 || m_alpha >= 1 || m_beta <= 0 || m_beta >= 1))
+        return false;
+
+    // a single engine command plays against this build
+    for (int engine = 0; engine < 2; engine++)
+    {
+        if (!m_commands[engine].empty())
+            m_names[engine] = m_commands[engine];
+    }
+    if (m_names[0] == m_names[1])
+    {
+        m_names[0] += " A";
+        m_names[1] += " B";
+    }
+
+    if (m_timeControl.empty() && m_limits.moveTime == 0 && m_limits.nodes == 0 && m_limits.depth == 0)
+        m_timeControl = DefaultTimeControl;
+
+    if (!m_timeControl.empty())
+    {
+        // base+increment in seconds
+        char* end = nullptr;
+        double base = std::strtod(m_timeControl.c_str(), &end);
+        double increment = (*end == '+') ? std::strtod(end + 1, &end) : 0.0;
+        if (*end != '\0' || base <= 0 || increment < 0)
+            return false;
+
+        m_baseTime = static_cast<int64_t>(base * 1000);
+        m_increment = static_cast<int64_t>(increment * 1000);
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : run ()
+//-----------------------------------------------------------------------------
+int Tournament::run()
+{
+    if (!m_openingsPath.empty() && !loadOpenings(m_openingsPath))
+    {
+        std::cerr << "can not read openings from " << m_openingsPath << std::endl;
+        return 0;
+    }
+
+    if (m_openings.empty())
+    {
+        m_openings.resize(1);
+        m_openings[0].start.setStartPosition();
+    }
+
+    if (!m_outputPath.empty())
+    {
+        m_pgnOut.open(m_outputPath.c_str());
+        if (!m_pgnOut)
+        {
+            std::cerr << "can not write " << m_outputPath << std::endl;
+            return 0;
+        }
+    }
+
+    ThreadPool pool(m_concurrency);
+    int workerCount = std::min(pool.getThreadCount(), m_gameCount);
+
+    // each game runs two searches, the hash budget is split between all of them
+    size_t hashMB = std::max<size_t>(1, m_hashMB / (workerCount * 2));
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < workerCount; i++)
+    {
+        workers.push_back(std::unique_ptr<Worker>(new Worker));
+        for (int engine = 0; engine < 2; engine++)
+        {
+            if (m_commands[engine].empty())
+                workers[i]->players[engine].reset(new EnginePlayer(m_names[engine], hashMB));
+            else
+                workers[i]->players[engine].reset(new UciPlayer(m_names[engine], m_commands[engine], hashMB));
+        }
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    m_nextRound = 0;
+    m_stop = false;
+    m_sprtResult = m_sprt ? SPRT_INCONCLUSIVE : SPRT_NONE;
+    for (int i = 0; i < workerCount; i++)
+    {
+        Worker* worker = workers[i].get();
+        pool.submit([this, worker](int) { runWorker(*worker); });
+    }
+    pool.wait();
+    // the child processes are ended before the summary
+    workers.clear();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printSummary(std::cout);
+    std::cout << m_played << " games in " << seconds << "s on " << workerCount << " threads" << std::endl;
+    return m_played;
+}
+
+//-----------------------------------------------------------------------------
+// Name : loadOpenings ()
+// Desc : an epd line is a position(the fen without the move counters), a pgn
+//        game is its start position and moves
+//-----------------------------------------------------------------------------
+bool Tournament::loadOpenings(const std::string& path)
+{
+    bool epd = path.size() > 4 && path.compare(path.size() - 4, 4, ".epd") == 0;
+
+    if (epd)
+    {
+        std::ifstream file(path.c_str());
+        if (!file)
+            return false;
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::istringstream fields(line);
+            std::string placement, side, castling, enPassant;
+            if (!(fields >> placement >> side >> castling >> enPassant))
+                continue;
+
+            Opening opening;
+            if (opening.start.setFromFEN(placement + " " + side + " " + castling + " " + enPassant + " 0 1"))
+                m_openings.push_back(opening);
+        }
+    }
+    else
+    {
+        PgnReader reader;
+        if (!reader.open(path))
+            return false;
+
+        PgnGame game;
+        while (reader.readGame(game))
+        {
+            Opening opening;
+            opening.start = game.start;
+            opening.moves = game.moves;
+            m_openings.push_back(opening);
+        }
+    }
+
+    return !m_openings.empty();
+}
+
+//-----------------------------------------------------------------------------
+// Name : runWorker ()
+// Desc : the games are taken in round order, even rounds give the first
+//        engine white and the odd ones replay the same opening reversed
+//-----------------------------------------------------------------------------
+void Tournament::runWorker(Worker& worker)
+{
+    PgnGame game;
+    std::vector<std::string> comments;
+    std::string termination;
+    GameStats stats;
+
+    while (!m_stop)
+    {
+        int round = m_nextRound++;
+        if (round >= m_gameCount)
+            break;
+
+        MatchPlayer& first = *worker.players[0];
+        MatchPlayer& second = *worker.players[1];
+        if (round % 2 == 0)
+            playGame(round, first, second, game, comments, termination, stats);
+        else
+            playGame(round, second, first, game, comments, termination, stats);
+
+        recordGame(round, game, comments, termination, stats);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : playGame ()
+// Desc : the clock of a side only runs while its player thinks. a player
+//        that runs out of time, answers nothing or plays an illegal move
+//        loses the game
+//-----------------------------------------------------------------------------
+void Tournament::playGame(int round, MatchPlayer& white, MatchPlayer& black, PgnGame& game,
+                          std::vector<std::string>& comments, std::string& termination, GameStats& stats)
+{
+    const Opening& opening = m_openings[(round / 2) % m_openings.size()];
+
+    game.clear();
+    game.start = opening.start;
+    game.moves = opening.moves;
+    comments.assign(game.moves.size(), std::string());
+
+    Position pos = opening.start;
+    std::vector<uint64_t> keys;
+    for (size_t i = 0; i < game.moves.size(); i++)
+    {
+        keys.push_back(pos.key());
+        UndoInfo undo;
+        pos.doMove(game.moves[i], undo);
+    }
+    keys.push_back(pos.key());
+
+    white.newGame();
+    black.newGame();
+
+    stats.nodes[0] = stats.nodes[1] = 0;
+    stats.time[0] = stats.time[1] = 0;
+    stats.unsearched[0] = stats.unsearched[1] = 0;
+    int64_t clock[2] = {m_baseTime, m_baseTime};
+    GameResult result = RESULT_UNKNOWN;
+
+    for (;;)
+    {
+        result = gameEnd(pos, keys, termination);
+        if (result != RESULT_UNKNOWN)
+            break;
+
+        int side = pos.sideToMove();
+        MatchPlayer& player = (side == BOTTOM) ? white : black;
+        GameResult loss = (side == BOTTOM) ? RESULT_BLACK_WINS : RESULT_WHITE_WINS;
+
+        SearchLimits limits = m_limits;
+        if (m_baseTime)
+        {
+            limits.time[0] = static_cast<int>(clock[0]);
+            limits.time[1] = static_cast<int>(clock[1]);
+            limits.increment[0] = limits.increment[1] = static_cast<int>(m_increment);
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        PlayerMove reply;
+        bool answered = player.go(game.start, game.moves, limits, reply);
+        int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        stats.nodes[side] += reply.nodes;
+        stats.time[side] += elapsed;
+
+        if (!answered || !pos.isPseudoLegal(reply.move) || !pos.isLegal(reply.move))
+        {
+            result = loss;
+            termination = answered ? "illegal move" : "no move";
+            break;
+        }
+
+        if (m_baseTime)
+        {
+            clock[side] -= elapsed;
+            if (clock[side] < 0)
+            {
+                result = loss;
+                termination = "time forfeit";
+                break;
+            }
+            clock[side] += m_increment;
+        }
+
+        // a move played before the first iteration finished has no
+        // evaluation, only its time is written
+        std::ostringstream comment;
+        if (reply.depth == 0 || reply.score == VALUE_NONE)
+            stats.unsearched[side]++;
+        else
+            comment << PgnAnalyzer::evalToString(reply.score, BOTTOM) << "/" << reply.depth << " ";
+        comment << std::fixed << std::setprecision(2) << elapsed / 1000.0 << "s";
+        comments.push_back(comment.str());
+
+        game.moves.push_back(reply.move);
+        UndoInfo undo;
+        pos.doMove(reply.move, undo);
+        keys.push_back(pos.key());
+    }
+
+    game.result = GameDatabase::resultString(result);
+    game.setTag("Event", "Self-play");
+    game.setTag("Site", "?");
+    game.setTag("Date", dateTag());
+    game.setTag("Round", std::to_string(round + 1));
+    game.setTag("White", white.getName());
+    game.setTag("Black", black.getName());
+    game.setTag("Result", game.result);
+
+    Position standard;
+    standard.setStartPosition();
+    if (game.start.toFEN() != standard.toFEN())
+    {
+        game.setTag("SetUp", "1");
+        game.setTag("FEN", game.start.toFEN());
+    }
+
+    game.setTag("TimeControl", m_baseTime ? m_timeControl : "-");
+    game.setTag("Termination", termination);
+}
+
+//-----------------------------------------------------------------------------
+// Name : recordGame ()
+//-----------------------------------------------------------------------------
+void Tournament::recordGame(int round, const PgnGame& game, const std::vector<std::string>& comments,
+                            const std::string& termination, const GameStats& stats)
+{
+    // the first engine has white in the even rounds
+    GameResult result = GameDatabase::parseResult(game.result);
+    bool firstIsWhite = round % 2 == 0;
+
+    std::lock_guard<std::mutex> lock(m_resultMutex);
+
+    if (result == RESULT_DRAW)
+        m_draws++;
+    else if ((result == RESULT_WHITE_WINS) == firstIsWhite)
+        m_wins++;
+    else
+        m_losses++;
+
+    m_played++;
+    m_terminations[termination]++;
+
+    int whiteEngine = firstIsWhite ? 0 : 1;
+    m_nodes[whiteEngine] += stats.nodes[BOTTOM];
+    m_nodes[1 - whiteEngine] += stats.nodes[UPPER];
+    m_thinkTime[whiteEngine] += stats.time[BOTTOM];
+    m_thinkTime[1 - whiteEngine] += stats.time[UPPER];
+
+    if (m_sprt)
+        updateSprt();
+
+    if (m_pgnOut.is_open())
+    {
+        writePgn(m_pgnOut, game, comments);
+        m_pgnOut.flush();
+    }
+
+    std::cerr << "game " << round + 1 << " " << game.getTag("White") << " - " << game.getTag("Black")
+              << " " << game.result << " (" << termination << "), " << m_names[0] << " +" << m_wins
+              << " -" << m_losses << " =" << m_draws;
+    if (m_sprt)
+        std::cerr << ", llr " << std::fixed << std::setprecision(2) << m_llr;
+    // moves played before a depth finished mean the time control is too
+    // short for the engines to show their strength
+    int unsearched = stats.unsearched[BOTTOM] + stats.unsearched[UPPER];
+    if (unsearched > 0)
+        std::cerr << ", " << unsearched << " moves without a finished depth";
+    std::cerr << std::endl;
+}
+
+//-----------------------------------------------------------------------------
+// Name : updateSprt ()
+// Desc : once the ratio leaves the bounds no new game is started, the games
+//        already being played are still counted
+//-----------------------------------------------------------------------------
+void Tournament::updateSprt()
+{
+    m_llr = computeLLR(m_wins, m_losses, m_draws, m_elo0, m_elo1);
+    if (m_sprtResult != SPRT_INCONCLUSIVE)
+        return;
+
+    double lower = std::log(m_beta / (1.0 - m_alpha));
+    double upper = std::log((1.0 - m_beta) / m_alpha);
+
+    if (m_llr >= upper)
+        m_sprtResult = SPRT_H1_ACCEPTED;
+    else if (m_llr <= lower)
+        m_sprtResult = SPRT_H0_ACCEPTED;
+
+    if (m_sprtResult != SPRT_INCONCLUSIVE)
+        m_stop = true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : getSprtResult ()
+//-----------------------------------------------------------------------------
+Tournament::SprtResult Tournament::getSprtResult() const
+{
+    return m_sprtResult;
+}
+
+//-----------------------------------------------------------------------------
+// Name : printSummary ()
+//-----------------------------------------------------------------------------
+void Tournament::printSummary(std::ostream& out) const
+{
+    int results[2][3] = {{m_wins, m_losses, m_draws}, {m_losses, m_wins, m_draws}};
+
+    size_t nameWidth = std::max<size_t>(16, std::max(m_names[0].size(), m_names[1].size()) + 2);
+
+    out << std::left << std::setw(nameWidth) << "engine" << std::right << std::setw(8) << "games"
+        << std::setw(8) << "wins" << std::setw(8) << "losses" << std::setw(8) << "draws"
+        << std::setw(9) << "score" << std::setw(12) << "nps" << "\n";
+
+    for (int engine = 0; engine < 2; engine++)
+    {
+        double score = m_played ? (results[engine][0] + results[engine][2] * 0.5) * 100.0 / m_played : 0.0;
+        uint64_t nps = m_thinkTime[engine] > 0 ? m_nodes[engine] * 1000 / m_thinkTime[engine] : 0;
+        out << std::left << std::setw(nameWidth) << m_names[engine] << std::right << std::setw(8) << m_played
+            << std::setw(8) << results[engine][0] << std::setw(8) << results[engine][1]
+            << std::setw(8) << results[engine][2] << std::setw(8) << std::fixed << std::setprecision(1)
+            << score << "%" << std::setw(12) << nps << "\n";
+    }
+
+    double elo, margin;
+    computeElo(m_wins, m_losses, m_draws, elo, margin);
+    out << "\nelo difference " << std::fixed << std::setprecision(1) << elo << " +/- " << margin << "\n";
+
+    if (m_sprt)
+    {
+        const char* verdict = (m_sprtResult == SPRT_H1_ACCEPTED) ? "H1 accepted" :
+                              (m_sprtResult == SPRT_H0_ACCEPTED) ? "H0 accepted" : "inconclusive";
+        out << "sprt elo0 " << m_elo0 << " elo1 " << m_elo1 << " alpha " << std::setprecision(3) << m_alpha
+            << " beta " << m_beta << " : llr " << std::setprecision(2) << m_llr << " ["
+            << std::log(m_beta / (1.0 - m_alpha)) << ", " << std::log((1.0 - m_beta) / m_alpha) << "] "
+            << verdict << "\n";
+    }
+    out << "\n";
+
+    out << std::left << std::setw(24) << "termination" << std::right << std::setw(8) << "games" << "\n";
+    for (std::map<std::string, int>::const_iterator it = m_terminations.begin(); it != m_terminations.end(); ++it)
+        out << std::left << std::setw(24) << it->first << std::right << std::setw(8) << it->second << "\n";
+    out << std::endl;
+}
+
+//-----------------------------------------------------------------------------
+// Name : computeElo ()
+// Desc : the logistic elo of the mean score, the interval comes from the
+//        standard error of the per game scores
+//-----------------------------------------------------------------------------
+void Tournament::computeElo(int wins, int losses, int draws, double& elo, double& margin)
+{
+    elo = 0.0;
+    margin = 0.0;
+
+    int games = wins + losses + draws;
+    if (games == 0)
+        return;
+
+    double score = (wins + draws * 0.5) / games;
+    double variance = (wins * (1.0 - score) * (1.0 - score) + losses * score * score +
+                       draws * (0.5 - score) * (0.5 - score)) / games;
+    double error = 1.96 * std::sqrt(variance / games);
+
+    elo = scoreToElo(score);
+    margin = (scoreToElo(score + error) - scoreToElo(score - error)) / 2.0;
+}
+
+//-----------------------------------------------------------------------------
+// Name : computeLLR ()
+// Desc : the generalized sprt : the per game scores are taken as normally
+//        distributed around the expected score of each hypothesis
+//-----------------------------------------------------------------------------
+double Tournament::computeLLR(int wins, int losses, int draws, double elo0, double elo1)
+{
+    int games = wins + losses + draws;
+    if (games == 0)
+        return 0.0;
+
+    double score = (wins + draws * 0.5) / games;
+    double variance = (wins * (1.0 - score) * (1.0 - score) + losses * score * score +
+                       draws * (0.5 - score) * (0.5 - score)) / games;
+    if (variance <= 0.0)
+        return 0.0;
+
+    double score0 = 1.0 / (1.0 + std::pow(10.0, -elo0 / 400.0));
+    double score1 = 1.0 / (1.0 + std::pow(10.0, -elo1 / 400.0));
+
+    return (score1 - score0) * (2.0 * score - score0 - score1) / (2.0 * variance / games);
+}
+
+//-----------------------------------------------------------------------------
+// Name : gameEnd ()
+// Desc : keys holds the positions of the game, the current one last
+//-----------------------------------------------------------------------------
+GameResult Tournament::gameEnd(const Position& pos, const std::vector<uint64_t>& keys, std::string& termination)
+{
+    DrawType drawType = findDraw(pos, keys);
+    if (drawType != NO_DRAW)
+    {
+        termination = drawTypeToString(drawType);
+        return RESULT_DRAW;
+    }
+
+    if (pos.inCheck() && !pos.hasLegalMove())
+    {
+        termination = "checkmate";
+        return (pos.sideToMove() == BOTTOM) ? RESULT_BLACK_WINS : RESULT_WHITE_WINS;
+    }
+
+    return RESULT_UNKNOWN;
+}
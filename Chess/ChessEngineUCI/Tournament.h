@@ -0,0 +1,141 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TOURNAMENT_H_
+#define _TOURNAMENT_H_
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include "MatchPlayer.h"
+#include "../ChessEngine/Pgn.h"
+#include "../ChessEngine/GameDatabase.h"
+
+// plays engine against engine games, one game per worker thread.
+// every worker has its own players, each with its own position and a share
+// of the hash budget, so the games scale with the cores without any process
+// per game. the players are this build's engine or uci engines run as child
+// processes. openings come from an epd or pgn suite and each one is played
+// twice with the colors swapped. the games are written to a pgn file as
+// they finish and a summary table is printed at the end.
+// in sprt mode the games stop as soon as the sequential probability ratio
+// test of the first engine's elo against the bounds is decided
+class Tournament
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    Tournament();
+
+    enum SprtResult{SPRT_NONE, SPRT_INCONCLUSIVE, SPRT_H0_ACCEPTED, SPRT_H1_ACCEPTED};
+
+    // selfplay [-engine command [-engine command]] [-games N] [-concurrency N] [-hash MB]
+    //          [-tc base+inc] [-movetime ms] [-nodes N] [-depth N]
+    //          [-openings file.epd|file.pgn] [-o out.pgn]
+    // sprt     [selfplay options] [-elo0 E] [-elo1 E] [-alpha A] [-beta B]
+    bool parseArguments(int argc, char* argv[]);
+    // returns the number of games played
+    int  run();
+
+    SprtResult getSprtResult() const;
+
+    // elo difference of a score and the half width of its 95% interval
+    static void   computeElo(int wins, int losses, int draws, double& elo, double& margin);
+    // log likelihood ratio of elo1 against elo0 from the game results
+    static double computeLLR(int wins, int losses, int draws, double elo0, double elo1);
+
+private:
+    struct Opening
+    {
+        Position          start;
+        std::vector<Move> moves;
+    };
+
+    // the two players of a worker, [0] is the first engine
+    struct Worker
+    {
+        std::unique_ptr<MatchPlayer> players[2];
+    };
+
+    // what each side spent on the game, [side]
+    struct GameStats
+    {
+        uint64_t nodes[2];
+        int64_t  time[2];
+        int      unsearched[2];     // moves played without a finished iteration
+    };
+
+    bool loadOpenings(const std::string& path);
+    void runWorker   (Worker& worker);
+    void playGame    (int round, MatchPlayer& white, MatchPlayer& black, PgnGame& game,
+                      std::vector<std::string>& comments, std::string& termination, GameStats& stats);
+    void recordGame  (int round, const PgnGame& game, const std::vector<std::string>& comments,
+                      const std::string& termination, const GameStats& stats);
+    void updateSprt  ();
+    void printSummary(std::ostream& out) const;
+
+    static GameResult gameEnd(const Position& pos, const std::vector<uint64_t>& keys, std::string& termination);
+
+    int          m_gameCount;
+    int          m_concurrency;
+    size_t       m_hashMB;
+    SearchLimits m_limits;
+    int64_t      m_baseTime;        // ms, 0 without a clock
+    int64_t      m_increment;       // ms
+    std::string  m_timeControl;
+    std::string  m_openingsPath;
+    std::string  m_outputPath;
+    std::string  m_names[2];
+    std::string  m_commands[2];     // empty for this build's engine
+
+    bool         m_sprt;
+    double       m_elo0;
+    double       m_elo1;
+    double       m_alpha;
+    double       m_beta;
+    SprtResult   m_sprtResult;
+    double       m_llr;
+
+    std::vector<Opening> m_openings;
+    std::atomic<int>     m_nextRound;
+    std::atomic<bool>    m_stop;
+
+    // results of the first engine
+    std::mutex    m_resultMutex;
+    std::ofstream m_pgnOut;
+    int           m_played;
+    int           m_wins;
+    int           m_losses;
+    int           m_draws;
+    std::map<std::string, int> m_terminations;
+    uint64_t      m_nodes[2];       // [engine]
+    int64_t       m_thinkTime[2];   // [engine] ms
+
+    static const int s_defaultGames     = 100;
+    static const int s_defaultSprtGames = 20000;
+    static const int s_defaultHashMB    = 256;
+};
+
+#endif // _TOURNAMENT_H_
@@ -0,0 +1,342 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "UciEngine.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cctype>
+
+//-----------------------------------------------------------------------------
+// Name : UciEngine (constructor)
+//-----------------------------------------------------------------------------
+UciEngine::UciEngine() : m_tt(s_defaultHash), m_search(m_tt)
+{
+    m_out = &std::cout;
+    m_searchFeatures = SEARCH_ALL_FEATURES;
+    m_pos.setStartPosition();
+    m_search.setInfoCallback([this](const SearchInfo& info) { onInfo(info); });
+}
+
+//-----------------------------------------------------------------------------
+// Name : UciEngine (destructor)
+//-----------------------------------------------------------------------------
+UciEngine::~UciEngine()
+{
+    onStop();
+}
+
+//-----------------------------------------------------------------------------
+// Name : run ()
+//-----------------------------------------------------------------------------
+void UciEngine::run(std::istream& in, std::ostream& out)
+{
+    m_out = &out;
+
+    std::string line;
+    while (std::getline(in, line))
+        if (!execute(line))
+            return;
+
+    onStop();
+}
+
+//-----------------------------------------------------------------------------
+// Name : execute ()
+//-----------------------------------------------------------------------------
+bool UciEngine::execute(const std::string& command)
+{
+    std::istringstream args(command);
+    std::string token;
+    args >> token;
+
+    if (token == "uci")
+        onUci();
+    else if (token == "isready")
+        send("readyok");
+    else if (token == "setoption")
+        onSetOption(args);
+    else if (token == "ucinewgame")
+        onNewGame();
+    else if (token == "position")
+        onPosition(args);
+    else if (token == "go")
+        onGo(args);
+    else if (token == "stop")
+        onStop();
+    else if (token == "ponderhit")
+        m_timeManager.ponderhit();
+    else if (token == "quit")
+    {
+        onStop();
+        return false;
+    }
+    else if (!token.empty())
+        send("info string unknown command " + command);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Name : scoreToString ()
+// Desc : the uci form of a score, mates are given in moves
+//-----------------------------------------------------------------------------
+std::string UciEngine::scoreToString(int score)
+{
+    std::ostringstream ss;
+
+    if (Search::isMateScore(score))
+    {
+        int plies = VALUE_MATE - std::abs(score);
+        int moves = (plies + 1) / 2;
+        ss << "mate " << (score > 0 ? moves : -moves);
+    }
+    else
+        ss << "cp " << score;
+
+    return ss.str();
+}
+
+//-----------------------------------------------------------------------------
+// Name : onUci ()
+//-----------------------------------------------------------------------------
+void UciEngine::onUci()
+{
+    std::ostringstream ss;
+    ss << "id name 3D Chess\n";
+    ss << "id author Matan Keren\n";
+    ss << "option name Hash type spin default " << s_defaultHash << " min 1 max " << s_maxHash << "\n";
+    ss << "option name Threads type spin default 1 min 1 max " << s_maxThreads << "\n";
+    ss << "option name Ponder type check default false\n";
+    ss << "option name MultiPV type spin default 1 min 1 max " << MAX_MOVES << "\n";
+    ss << "option name CopyMake type check default false\n";
+    ss << "option name PVS type check default true\n";
+    ss << "option name NullMove type check default true\n";
+    ss << "option name LMR type check default true\n";
+    ss << "option name Futility type check default true\n";
+    ss << "uciok";
+    send(ss.str());
+}
+
+//-----------------------------------------------------------------------------
+// Name : onSetOption ()
+// Desc : setoption name <name> value <value>, both may hold spaces
+//-----------------------------------------------------------------------------
+void UciEngine::onSetOption(std::istringstream& args)
+{
+    std::string token, name, value;
+    bool readingValue = false;
+
+    args >> token;  // name
+    while (args >> token)
+    {
+        if (!readingValue && token == "value")
+        {
+            readingValue = true;
+            continue;
+        }
+
+        std::string& target = readingValue ? value : name;
+        target += (target.empty() ? "" : " ") + token;
+    }
+
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+    // options may only change between searches
+    onStop();
+
+    if (name == "hash")
+        m_tt.resize(std::max(1, std::min(s_maxHash, std::atoi(value.c_str()))));
+    else if (name == "threads")
+        m_search.setThreadCount(std::max(1, std::min(s_maxThreads, std::atoi(value.c_str()))));
+    else if (name == "multipv")
+        m_search.setMultiPV(std::max(1, std::min(MAX_MOVES, std::atoi(value.c_str()))));
+    else if (name == "copymake")
+        m_search.setCopyMake(value == "true");
+    else if (name == "pvs" || name == "nullmove" || name == "lmr" || name == "futility")
+    {
+        int feature = (name == "pvs") ? SEARCH_PVS : (name == "nullmove") ? SEARCH_NULL_MOVE :
+                      (name == "lmr") ? SEARCH_LMR : SEARCH_FUTILITY;
+        if (value == "true")
+            m_searchFeatures |= feature;
+        else
+            m_searchFeatures &= ~feature;
+
+        m_search.setFeatures(m_searchFeatures);
+    }
+    else if (name != "ponder")
+        send("info string unknown option " + name);
+}
+
+//-----------------------------------------------------------------------------
+// Name : onNewGame ()
+//-----------------------------------------------------------------------------
+void UciEngine::onNewGame()
+{
+    onStop();
+    m_tt.clear();
+    m_search.clearHistory();
+}
+
+//-----------------------------------------------------------------------------
+// Name : onPosition ()
+// Desc : position startpos|fen <fen> [moves <move>...]
+//-----------------------------------------------------------------------------
+void UciEngine::onPosition(std::istringstream& args)
+{
+    std::string token, fen;
+    args >> token;
+
+    if (token == "startpos")
+    {
+        m_pos.setStartPosition();
+        args >> token;  // moves
+    }
+    else if (token == "fen")
+    {
+        while (args >> token && token != "moves")
+            fen += token + " ";
+
+        if (!m_pos.setFromFEN(fen))
+        {
+            send("info string invalid fen " + fen);
+            m_pos.setStartPosition();
+        }
+    }
+    else
+        return;
+
+    m_gameHistory.clear();
+
+    while (args >> token)
+    {
+        Move move = m_pos.parseMove(token);
+        if (move == MOVE_NONE)
+        {
+            send("info string illegal move " + token);
+            break;
+        }
+
+        m_gameHistory.push_back(m_pos.key());
+        UndoInfo undo;
+        m_pos.doMove(move, undo);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Name : onGo ()
+//-----------------------------------------------------------------------------
+void UciEngine::onGo(std::istringstream& args)
+{
+    SearchLimits limits;
+    std::string token;
+
+    while (args >> token)
+    {
+        if (token == "wtime")
+            args >> limits.time[BOTTOM];
+        else if (token == "btime")
+            args >> limits.time[UPPER];
+        else if (token == "winc")
+            args >> limits.increment[BOTTOM];
+        else if (token == "binc")
+            args >> limits.increment[UPPER];
+        else if (token == "movestogo")
+            args >> limits.movesToGo;
+        else if (token == "depth")
+            args >> limits.depth;
+        else if (token == "nodes")
+            args >> limits.nodes;
+        else if (token == "movetime")
+            args >> limits.moveTime;
+        else if (token == "infinite")
+            limits.infinite = true;
+        else if (token == "ponder")
+            limits.ponder = true;
+    }
+
+    onStop();
+
+    // the clock starts here so a stop or ponderhit read right after the go
+    // can not be lost
+    m_tt.newSearch();
+    m_timeManager.start(limits, m_pos.sideToMove());
+
+    Position root = m_pos;
+    std::vector<uint64_t> gameHistory = m_gameHistory;
+
+    m_searchThread = std::thread([this, root, gameHistory, limits]()
+    {
+        SearchResult result = m_search.think(root, gameHistory, limits, m_timeManager);
+
+        std::string line = "bestmove " + (result.bestMove != MOVE_NONE ? moveToString(result.bestMove) : "0000");
+        if (result.ponderMove != MOVE_NONE)
+            line += " ponder " + moveToString(result.ponderMove);
+        send(line);
+    });
+}
+
+//-----------------------------------------------------------------------------
+// Name : onStop ()
+//-----------------------------------------------------------------------------
+void UciEngine::onStop()
+{
+    m_timeManager.requestStop();
+    waitForSearch();
+}
+
+//-----------------------------------------------------------------------------
+// Name : onInfo ()
+//-----------------------------------------------------------------------------
+void UciEngine::onInfo(const SearchInfo& info)
+{
+    std::ostringstream ss;
+    ss << "info depth " << info.depth << " seldepth " << info.selDepth
+       << " multipv " << info.multiPV
+       << " score " << scoreToString(info.score)
+       << " nodes " << info.nodes
+       << " nps " << (info.time > 0 ? info.nodes * 1000 / info.time : info.nodes)
+       << " time " << info.time
+       << " hashfull " << info.hashfull
+       << " pv";
+
+    for (size_t i = 0; i < info.pv.size(); i++)
+        ss << " " << moveToString(info.pv[i]);
+
+    send(ss.str());
+}
+
+//-----------------------------------------------------------------------------
+// Name : waitForSearch ()
+//-----------------------------------------------------------------------------
+void UciEngine::waitForSearch()
+{
+    if (m_searchThread.joinable())
+        m_searchThread.join();
+}
+
+//-----------------------------------------------------------------------------
+// Name : send ()
+// Desc : both the search thread and the command thread write lines
+//-----------------------------------------------------------------------------
+void UciEngine::send(const std::string& line)
+{
+    std::lock_guard<std::mutex> lock(m_outMutex);
+    *m_out << line << std::endl;
+}
@@ -0,0 +1,85 @@
+/* * 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+ * Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+ *
+ * This file is part of 3D Chess.
+ *
+ * 3D Chess is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * 3D Chess is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _UCIENGINE_H_
+#define _UCIENGINE_H_
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include "../ChessEngine/ParallelSearch.h"
+
+// the engine side of the uci protocol.
+// commands are read on the calling thread, a go starts the search on its own
+// thread so stop and ponderhit can be handled while it thinks
+class UciEngine
+{
+public:
+    //-------------------------------------------------------------------------
+    // Constructors & Destructors for This Class.
+    //-------------------------------------------------------------------------
+    UciEngine();
+    ~UciEngine();
+
+    UciEngine(const UciEngine&) = delete;
+    UciEngine& operator=(const UciEngine&) = delete;
+
+    // reads commands until quit or the end of the input
+    void run    (std::istream& in, std::ostream& out);
+    // returns false on quit
+    bool execute(const std::string& command);
+
+    static std::string scoreToString(int score);
+
+private:
+    //-------------------------------------------------------------------------
+    // Functions that handle the uci commands
+    //-------------------------------------------------------------------------
+    void onUci      ();
+    void onSetOption(std::istringstream& args);
+    void onNewGame  ();
+    void onPosition (std::istringstream& args);
+    void onGo       (std::istringstream& args);
+    void onStop     ();
+    void onInfo     (const SearchInfo& info);
+
+    void waitForSearch();
+    void send         (const std::string& line);
+
+    std::ostream*         m_out;
+    std::mutex            m_outMutex;
+
+    TranspositionTable    m_tt;
+    ParallelSearch        m_search;
+    int                   m_searchFeatures;   // SearchFeature mask of the check options
+    TimeManager           m_timeManager;
+    std::thread           m_searchThread;
+
+    Position              m_pos;
+    std::vector<uint64_t> m_gameHistory;   // keys of the positions before m_pos
+
+    static const int s_defaultHash = 32;
+    static const int s_maxHash     = 4096;
+    static const int s_maxThreads  = 256;
+};
+
+#endif // _UCIENGINE_H_
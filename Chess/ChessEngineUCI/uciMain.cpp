@@ -0,0 +1,109 @@
+//
+// 3D Chess - A cross platform Chess game for 2 players made using OpenGL and c++
+// Copyright (C) 2016-2020 Matan Keren <xmakerenx@gmail.com>
+//
+// This file is part of 3D Chess.
+//
+// 3D Chess is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// 3D Chess is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with 3D Chess.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <cstring>
+#include "UciEngine.h"
+#include "PgnAnalyzer.h"
+#include "GameImporter.h"
+#include "BookMaker.h"
+#include "PositionFinder.h"
+#include "Tournament.h"
+
+//-----------------------------------------------------------------------------
+// Name : main ()
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::strcmp(argv[1], "analyze") == 0)
+    {
+        PgnAnalyzer analyzer;
+        if (!analyzer.parseArguments(argc, argv))
+        {
+            std::cerr << "usage: " << argv[0]
+                      << " analyze [-depth N] [-nodes N] [-threads N] [-hash MB] [-o out.pgn] <pgn files or directories>" << std::endl;
+            return 1;
+        }
+
+        analyzer.run();
+        return 0;
+    }
+
+    if (argc > 1 && std::strcmp(argv[1], "import") == 0)
+    {
+        GameImporter importer;
+        if (!importer.parseArguments(argc, argv))
+        {
+            std::cerr << "usage: " << argv[0] << " import <database> <pgn files or directories>" << std::endl;
+            return 1;
+        }
+
+        return importer.run() > 0 ? 0 : 1;
+    }
+
+    if (argc > 1 && std::strcmp(argv[1], "book") == 0)
+    {
+        BookMaker maker;
+        if (!maker.parseArguments(argc, argv))
+        {
+            std::cerr << "usage: " << argv[0]
+                      << " book [-plies N] [-min N] [-db database] <book.bin> <pgn files or directories>" << std::endl;
+            return 1;
+        }
+
+        return maker.run() ? 0 : 1;
+    }
+
+    if (argc > 1 && (std::strcmp(argv[1], "index") == 0 || std::strcmp(argv[1], "find") == 0))
+    {
+        PositionFinder finder;
+        if (!finder.parseArguments(argc, argv))
+        {
+            std::cerr << "usage: " << argv[0] << " index [-threads N] [-memory MB] <database>\n"
+                      << "       " << argv[0] << " find <database> <fen>" << std::endl;
+            return 1;
+        }
+
+        return finder.run() ? 0 : 1;
+    }
+
+    if (argc > 1 && (std::strcmp(argv[1], "selfplay") == 0 || std::strcmp(argv[1], "sprt") == 0))
+    {
+        Tournament tournament;
+        if (!tournament.parseArguments(argc, argv))
+        {
+            std::cerr << "usage: " << argv[0] << " selfplay [-engine command [-engine command]] [-games N] [-concurrency N]\n"
+                      << "       [-hash MB] [-tc base+inc] [-movetime ms] [-nodes N] [-depth N]\n"
+                      << "       [-openings file.epd|file.pgn] [-o out.pgn]\n"
+                      << "       " << argv[0] << " sprt [selfplay options] [-elo0 E] [-elo1 E] [-alpha A] [-beta B]" << std::endl;
+            return 1;
+        }
+
+        if (tournament.run() == 0)
+            return 1;
+
+        // a test that did not accept its H1 fails
+        Tournament::SprtResult sprt = tournament.getSprtResult();
+        return (sprt == Tournament::SPRT_NONE || sprt == Tournament::SPRT_H1_ACCEPTED) ? 0 : 1;
+    }
+
+    UciEngine engine;
+    engine.run(std::cin, std::cout);
+    return 0;
+}
@@ -20,6 +20,8 @@
 
 #include "ChessScene.h" 
 #include "gameoverDef.h"
+#include "ChessEngine/Tracer.h"
+#include <ctime>
 
 //-----------------------------------------------------------------------------
 // Name : ChessScene
@@ -38,6 +40,8 @@ ChessScene::ChessScene(DialogUI& promotionDialog, DialogUI& gameOverDialog) : m_
     m_redAttribute = -1;
     m_yellowAttribute = -1;
     m_lastIndex = 0;
+    m_enginePlayer = 0;
+    m_ponderMove = MOVE_NONE;
     
     for (int i = 0; i < 8; i++)
     {
@@ -51,8 +55,11 @@ ChessScene::ChessScene(DialogUI& promotionDialog, DialogUI& gameOverDialog) : m_
 //-----------------------------------------------------------------------------
 ChessScene::~ChessScene()
 {
+    m_engine.shutdown();
+    
+    // every move is already in the journal, closing it flushes the last ones
     if(gameBoard != nullptr)
-        gameBoard->SaveBoardToFile();
+        gameBoard->setJournaling(false);
 }
 
 //-----------------------------------------------------------------------------
@@ -140,12 +147,21 @@ void ChessScene::InitObjects()
     m_redEyesAttribute = m_assetManager.getAttribute("", GL_REPEAT, redEye, s_meshShaderPath2 );;
     
     gameBoard = new board();
-    gameBoard->connectToPieceCreated(boost::bind(&ChessScene::onChessPieceCreated, this, _1));
-    gameBoard->connectToPieceMoved(boost::bind(&ChessScene::onChessPieceMoved, this, _1, _2, _3));
-    gameBoard->connectToGameOver(boost::bind(&ChessScene::ShowGameOver, this , _1));
+    gameBoard->connectToPieceCreated(board::PieceCreatedDelegate::fromMethod<ChessScene, &ChessScene::onChessPieceCreated>(this));
+    gameBoard->connectToPieceMoved(board::PieceMovedDelegate::fromMethod<ChessScene, &ChessScene::onChessPieceMoved>(this));
+    gameBoard->connectToGameOver(board::GameOverDelegate::fromMethod<ChessScene, &ChessScene::ShowGameOver>(this));
+    gameBoard->conntectToEndTurn(board::EndTurnDelegate::fromMethod<ChessScene, &ChessScene::onTurnEnded>(this));
+    // mates and draws are detected by the engine thread
+    gameBoard->setAsyncEndGameCheck(true);
+    gameBoard->setJournaling(true);
     
     gameBoard->init();
     
+    m_engine.openBook("data/book.bin");
+    m_engine.start();
+    m_gameDatabase.open("data/games");
+    onTurnEnded(gameBoard->getCurrentPlayer());
+    
     m_promotionDialog.getButton(IDC_KNIGHT)->connectToClick( boost::bind(&ChessScene::onPromotionSelected, this, _1));
     m_promotionDialog.getButton(IDC_BISHOP)->connectToClick( boost::bind(&ChessScene::onPromotionSelected, this, _1));
     m_promotionDialog.getButton(IDC_ROOK)->connectToClick( boost::bind(&ChessScene::onPromotionSelected, this, _1));
@@ -177,6 +193,10 @@ void ChessScene::newGame()
     
     m_lastIndex = 3;
     gameBoard->resetGame();
+    
+    m_ponderMove = MOVE_NONE;
+    m_engine.newGame();
+    onTurnEnded(gameBoard->getCurrentPlayer());
 }
 
 //-----------------------------------------------------------------------------
@@ -193,6 +213,9 @@ void ChessScene::loadGame()
     }
     
     m_lastIndex = 3;
+    
+    m_ponderMove = MOVE_NONE;
+    m_engine.newGame();
     gameBoard->LoadBoardFromFile();
     
     const BOARD_POINT& threatBoardSquare = gameBoard->getThreatSquare();
@@ -205,6 +228,8 @@ void ChessScene::loadGame()
 //-----------------------------------------------------------------------------
 bool ChessScene::handleMouseEvent(MouseEvent event, const ModifierKeysStates &modifierStates)
 {
+    TRACE_SCOPE("ChessScene::handleMouseEvent");
+
     switch(event.type)
     {
         case MouseEventType::MouseMoved:
@@ -231,6 +256,10 @@ bool ChessScene::handleMouseEvent(MouseEvent event, const ModifierKeysStates &mo
         {
             if (event.down)
             {
+                // the board is not ours to touch while the engine is on the move
+                if (gameBoard->getCurrentPlayer() == m_enginePlayer)
+                    return true;
+                
                 Object* temp = PickObject(event.cursorPos, m_faceCount, m_meshIndex);
                 if (temp != nullptr && m_meshIndex < 2)
                 {
@@ -266,6 +295,8 @@ bool ChessScene::handleMouseEvent(MouseEvent event, const ModifierKeysStates &mo
 //-----------------------------------------------------------------------------
 Object * ChessScene::PickObject(Point& cursor, int& faceCount, int &meshIndex)
 {
+    TRACE_SCOPE("ChessScene::PickObject");
+
     const glm::mat4x4& matPorj = m_camera.GetProjMatrix();
 
     glm::vec3 v;
@@ -305,6 +336,8 @@ Object * ChessScene::PickObject(Point& cursor, int& faceCount, int &meshIndex)
 //-----------------------------------------------------------------------------
 void ChessScene::RotateCamera(float frameTimeDelta)
 {
+    TRACE_SCOPE("ChessScene::RotateCamera");
+
     if (m_rotationMode != RotationMode::Stoped)
     {
         float eyeX = -80*glm::cos(m_rotationAngle) - glm::sin(m_rotationAngle);
@@ -386,6 +419,9 @@ void ChessScene::RotateCamera(float frameTimeDelta)
 //-----------------------------------------------------------------------------
 void ChessScene::Drawing(double frameTimeDelta)
 {
+    TRACE_SCOPE("ChessScene::Drawing");
+
+    pollEngine();
     RotateCamera(frameTimeDelta);
     Scene::Drawing(frameTimeDelta);
     
@@ -521,6 +557,8 @@ void ChessScene::onChessPieceCreated(piece* pPiece)
 //-----------------------------------------------------------------------------
 void ChessScene::onChessPieceMoved(piece* pPiece, BOARD_POINT pieceOldBoardPoint, BOARD_POINT pieceNewBoardPoint)
 {    
+    TRACE_SCOPE("ChessScene::onChessPieceMoved");
+
      Point pieceOldPoint = boardPointToPoint(pieceOldBoardPoint);
      Point pieceNewPoint = boardPointToPoint(pieceNewBoardPoint);
      glm::vec3 piecePosition = glm::vec3(pieceNewPoint.x * 10 + 5,
@@ -544,6 +582,8 @@ void ChessScene::onChessPieceMoved(piece* pPiece, BOARD_POINT pieceOldBoardPoint
 //-----------------------------------------------------------------------------
 void ChessScene::onChessPieceKilled(piece* pPiece)
 {
+    TRACE_SCOPE("ChessScene::onChessPieceKilled");
+
     Point pieceBoardPoint = boardPointToPoint(pPiece->getPosition());
     int blah = pieceObjects[pieceBoardPoint.y][pieceBoardPoint.x];
     m_objects.erase(m_objects.begin() + blah);
@@ -597,6 +637,130 @@ void ChessScene::ShowGameOver(std::string gameOverStatus)
 {
     m_gameOverDialog.setVisible(true);
     m_gameOverDialog.getStatic(IDC_ENDREASON)->setText(gameOverStatus.c_str());
+    storeGame(gameOverStatus);
+}
+
+//-----------------------------------------------------------------------------
+// Name : storeGame() 
+//-----------------------------------------------------------------------------
+void ChessScene::storeGame(const std::string& gameOverStatus)
+{
+    if (!m_gameDatabase.isOpen())
+        return;
+    
+    StoredGame game;
+    game.whitePlayer = m_gameDatabase.addPlayer(m_enginePlayer == WHITE ? "Computer" : "Player");
+    game.blackPlayer = m_gameDatabase.addPlayer(m_enginePlayer == BLACK ? "Computer" : "Player");
+    
+    std::time_t now = std::time(nullptr);
+    std::tm* date = std::localtime(&now);
+    game.date = date ? (date->tm_year + 1900) * 10000 + (date->tm_mon + 1) * 100 + date->tm_mday : 0;
+    
+    if (gameOverStatus == "White Wins!")
+        game.result = RESULT_WHITE_WINS;
+    else if (gameOverStatus == "Black Wins!")
+        game.result = RESULT_BLACK_WINS;
+    else if (gameOverStatus == "Draw")
+        game.result = RESULT_DRAW;
+    else
+        game.result = RESULT_UNKNOWN;
+    
+    game.start = gameBoard->getStartPosition();
+    Position pos = game.start;
+    UndoInfo undo;
+    for (Move move : gameBoard->getMoveHistory())
+    {
+        if (!pos.isPseudoLegal(move) || !pos.isLegal(move))
+            break;
+        
+        pos.doMove(move, undo);
+        game.moves.push_back(move);
+    }
+    
+    m_gameDatabase.addGame(game);
+    m_gameDatabase.sync();
+}
+
+//-----------------------------------------------------------------------------
+// Name : onTurnEnded() 
+//-----------------------------------------------------------------------------
+void ChessScene::onTurnEnded(int currentPlayer)
+{
+    requestEngineTurn();
+}
+
+//-----------------------------------------------------------------------------
+// Name : setEnginePlayer() 
+//-----------------------------------------------------------------------------
+void ChessScene::setEnginePlayer(int playerColor)
+{
+    m_enginePlayer = playerColor;
+    
+    // post the position again so the engine starts thinking if it is its turn
+    if (gameBoard->isBoardActive() && !gameBoard->isUnitPromotion())
+        requestEngineTurn();
+}
+
+//-----------------------------------------------------------------------------
+// Name : getEnginePlayer() 
+//-----------------------------------------------------------------------------
+int ChessScene::getEnginePlayer() const
+{
+    return m_enginePlayer;
+}
+
+//-----------------------------------------------------------------------------
+// Name : requestEngineTurn() 
+// Desc : hands the current position to the engine thread which checks if
+//        the game has ended and searches a move when it is the engine turn
+//-----------------------------------------------------------------------------
+void ChessScene::requestEngineTurn()
+{
+    Position pos = gameBoard->getPosition();
+    bool engineTurn = gameBoard->getCurrentPlayer() == m_enginePlayer;
+    
+    // the player made the move the engine was pondering on, its search
+    // simply goes on as the search of this move. a move that ends the game
+    // is never pondered, it is posted below and gets its game status
+    if (engineTurn && m_engine.ponderhit(pos))
+        return;
+    
+    SearchLimits limits;
+    limits.moveTime = s_engineMoveTime;
+    
+    Move ponderMove = (m_enginePlayer != 0 && !engineTurn) ? m_ponderMove : MOVE_NONE;
+    m_ponderMove = MOVE_NONE;
+    
+    const std::vector<uint64_t>& positionKeys = gameBoard->getPositionKeys();
+    std::vector<uint64_t> gameHistory(positionKeys.begin(), positionKeys.end() - 1);
+    m_engine.postTurn(pos, gameHistory, engineTurn, limits, ponderMove);
+}
+
+//-----------------------------------------------------------------------------
+// Name : pollEngine() 
+// Desc : applies what the engine thread found since the last frame
+//-----------------------------------------------------------------------------
+void ChessScene::pollEngine()
+{
+    EngineResult result;
+    while (m_engine.pollResult(result))
+    {
+        if (result.type == EngineResult::TURN_STATUS)
+        {
+            if (result.status == GAME_CHECKMATE)
+                gameBoard->declareGameOver(gameBoard->getCurrentPlayer() == WHITE ? "Black Wins!" : "White Wins!");
+            else if (result.status != GAME_ONGOING)
+                gameBoard->declareDraw(result.drawType);
+        }
+        else if (result.type == EngineResult::BEST_MOVE && gameBoard->getCurrentPlayer() == m_enginePlayer)
+        {
+            // playing the move ends the turn and posts the next position,
+            // anything left in the queue is stale after that
+            m_ponderMove = result.ponderMove;
+            gameBoard->playMove(result.move);
+            highLightSquares();
+        }
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -604,6 +768,8 @@ void ChessScene::ShowGameOver(std::string gameOverStatus)
 //-----------------------------------------------------------------------------
 void ChessScene::highLightSquares()
 {
+    TRACE_SCOPE("ChessScene::highLightSquares");
+
     const std::vector<BOARD_POINT>& moveSquares = gameBoard->getMoveSquares();
     const std::vector<BOARD_POINT>& attackSquares = gameBoard->getAttackSquares();
                     
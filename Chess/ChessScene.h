@@ -21,7 +21,10 @@
 #define _CHESSSCENE_H_
 
 #include <Render/Scene.h>
+#include <boost/bind/bind.hpp>
 #include "ChessEngine/Board.h"
+#include "ChessEngine/EngineService.h"
+#include "ChessEngine/GameDatabase.h"
 #include <Render/GUI/DialogUI.h>
 #include "pawnsDef.h"
 
@@ -51,6 +54,11 @@ public:
     void onChessPieceKilled(piece* pPiece);
     void onPromotionSelected(ButtonUI* selectedPieceButton);
     void ShowGameOver(std::string gameOverStatus);
+    void onTurnEnded(int currentPlayer);
+    
+    // the color the engine plays, 0 when both sides are played by humans
+    void setEnginePlayer(int playerColor);
+    int getEnginePlayer() const;
     
     void highLightSquares();
     void hightlightBoardSquare(Point squareToHightlight, GLuint attributeID);
@@ -63,6 +71,11 @@ public:
     
 private:
     void RotateCamera(float frameTimeDelta);
+    void requestEngineTurn();
+    void pollEngine();
+    // adds the finished game to the played games database
+    void storeGame(const std::string& gameOverStatus);
+    
     bool m_cameraRotation;
     RotationMode m_rotationMode;
     float m_rotationAngle;
@@ -84,8 +97,15 @@ private:
     DialogUI& m_promotionDialog;
     DialogUI& m_gameOverDialog;
     
+    EngineService m_engine;
+    int m_enginePlayer;
+    // the reply the engine expects to its last move, searched on the player time
+    Move m_ponderMove;
+    GameDatabase m_gameDatabase;
+    
     static const int nCellHigh = 8;
     static const int nCellWide = 8;
+    static const int s_engineMoveTime = 1000; // ms
 
 };
 